@@ -0,0 +1,268 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Chip8Core.h"
+#include "Chip8Jit.h"
+#include "Chip8Lockstep.h"
+#include "Guards.h"
+
+// Default instructions per 60Hz frame, as in the demo
+#define BENCH_IPF 12
+// Each measurement is the best of this many runs
+#define BENCH_REPEATS 3
+
+/*
+ * A synthetic ROM that spends nearly all of its time in one class of
+ * instruction
+ */
+typedef struct BenchRom {
+    const char *name;
+    const char *opClass;
+    const uint8_t *program;
+    size_t size;
+    bool superMode;
+} BenchRom;
+
+// ENGINE_LOCKSTEP runs CHIP8_LANES copies of the ROM as one Chip8Lockstep
+// group, and counts the instructions of every lane
+typedef enum BenchEngine {
+    ENGINE_REFERENCE, ENGINE_THREADED, ENGINE_JIT, ENGINE_LOCKSTEP
+} BenchEngine;
+
+static const char *engineNames[] = {
+    "reference", "threaded", "jit", "lockstep"
+};
+
+static const uint8_t aluRom[] = {
+    // Seed V0 and V1
+    0x60, 0x01,
+    0x61, 0x03,
+    // Loop: V0 += V1
+    0x80, 0x14,
+    // V1 -= V0
+    0x81, 0x05,
+    // V2 ^= V0
+    0x82, 0x03,
+    // V0 |= V2
+    0x80, 0x21,
+    // V3 &= V1
+    0x83, 0x12,
+    // V4 = V0 >> 1
+    0x84, 0x06,
+    // V0 += 7
+    0x70, 0x07,
+    // Back to the loop
+    0x12, 0x04
+};
+
+static const uint8_t drawRom[] = {
+    // Point I to the sprite for the char in V0
+    0xF0, 0x29,
+    // Draw it at (V0, V1)
+    0xD0, 0x15,
+    // Move right 3 and down 1
+    0x70, 0x03,
+    0x71, 0x01,
+    // Back to the start
+    0x12, 0x00
+};
+
+static const uint8_t drawHiresRom[] = {
+    // Enable largeScreen mode
+    0x00, 0xFF,
+    // Loop: point I to the large sprite for 0
+    0xA0, 0x80,
+    // Draw 8x10 at (V0, V1)
+    0xD0, 0x1A,
+    // Draw 16x16 at (V1, V0)
+    0xD1, 0x00,
+    // Move right 5 and down 3
+    0x70, 0x05,
+    0x71, 0x03,
+    // Back to the loop
+    0x12, 0x02
+};
+
+static const uint8_t scrollRom[] = {
+    // Enable largeScreen mode
+    0x00, 0xFF,
+    // Loop: draw a large 0 at (V0, V1)
+    0xA0, 0x80,
+    0xD0, 0x1A,
+    0x70, 0x0B,
+    0x71, 0x07,
+    // Scroll down 2, right 4 and left 4
+    0x00, 0xC2,
+    0x00, 0xFB,
+    0x00, 0xFC,
+    0x00, 0xFB,
+    // Back to the loop
+    0x12, 0x02
+};
+
+static const uint8_t callRom[] = {
+    // Loop: call the subroutine twice
+    0x22, 0x06,
+    0x22, 0x06,
+    // Back to the loop
+    0x12, 0x00,
+    // Subroutine: V0 += 1, return
+    0x70, 0x01,
+    0x00, 0xEE
+};
+
+static const uint8_t memRom[] = {
+    // Loop: point I to scratch ram
+    0xA8, 0x00,
+    // Store V0...V7 and read them back
+    0xF8, 0x55,
+    0xF8, 0x65,
+    // Store the decimal digits of V0
+    0xF0, 0x33,
+    // Read three bytes back
+    0xF3, 0x65,
+    // V0 += 13
+    0x70, 0x0D,
+    // Back to the loop
+    0x12, 0x00
+};
+
+static const BenchRom roms[] = {
+    { "alu", "8xyn", aluRom, sizeof(aluRom), false },
+    { "draw", "Dxyn", drawRom, sizeof(drawRom), false },
+    { "draw-hires", "Dxyn", drawHiresRom, sizeof(drawHiresRom), true },
+    { "scroll", "00Cn/00FB/00FC", scrollRom, sizeof(scrollRom), true },
+    { "call", "2nnn/00EE", callRom, sizeof(callRom), false },
+    { "mem", "Fx55/Fx65/Fx33", memRom, sizeof(memRom), true }
+};
+
+static uint64_t presented;
+
+void countFrame(uint64_t screen[64][2], uint64_t dirtyRows);
+bool runBench(const BenchRom *rom, BenchEngine engine, uint64_t budget,
+        unsigned ipf, Chip8Proc *procs);
+Chip8RunStats runLockstep(Chip8Proc *lanes, uint64_t budget, unsigned ipf);
+
+int main(int argc, char **argv) {
+    // bench [instructions per run] [rom name or all] [instructions per frame]
+    uint64_t budget = argc > 1 ? strtoull(argv[1], NULL, 10) : 20000000;
+    const char *only = argc > 2 && strcmp(argv[2], "all") != 0
+        ? argv[2] : NULL;
+    unsigned ipf = argc > 3 ? (unsigned) strtoul(argv[3], NULL, 10) : BENCH_IPF;
+
+    // One processor per lane of a lockstep group; the other engines use
+    // the first
+    Chip8Proc *procs = aligned_alloc(_Alignof(Chip8Proc),
+            CHIP8_LANES * sizeof(Chip8Proc));
+    OOM_GUARD(procs, __FILE__, __LINE__);
+    for (size_t r = 0; r < sizeof(roms) / sizeof(roms[0]); ++r) {
+        if (only != NULL && strcmp(only, roms[r].name) != 0) {
+            continue;
+        }
+        for (BenchEngine e = ENGINE_REFERENCE; e <= ENGINE_LOCKSTEP; ++e) {
+            runBench(&roms[r], e, budget, ipf, procs);
+        }
+    }
+    free(procs);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Stand-in for a display, so Chip8_present does its usual work
+ */
+void countFrame(uint64_t screen[64][2], uint64_t dirtyRows) {
+    (void) screen;
+    (void) dirtyRows;
+    ++presented;
+}
+
+/*
+ * Run rom headlessly for budget instructions on one engine, ipf instructions
+ * per frame, and print one JSON line with the best of BENCH_REPEATS runs.
+ * Returns false if the engine is unavailable or the ROM trapped.
+ */
+bool runBench(const BenchRom *rom, BenchEngine engine, uint64_t budget,
+        unsigned ipf, Chip8Proc *procs) {
+    Chip8RunStats best = { 0 };
+    uint64_t bestPresented = 0;
+    Chip8Proc *proc = &procs[0];
+    int count = engine == ENGINE_LOCKSTEP ? CHIP8_LANES : 1;
+    for (int i = 0; i < BENCH_REPEATS; ++i) {
+        for (int p = 0; p < count; ++p) {
+            Chip8_initAt(&procs[p], rom->program, rom->size, countFrame,
+                    NULL, rom->superMode);
+        }
+        proc->referenceMode = engine == ENGINE_REFERENCE;
+        if (engine == ENGINE_JIT && !Chip8Jit_enable(proc)) {
+            return false;
+        }
+        Chip8RunConfig config = {
+            .ipf = ipf,
+            .headless = true,
+            .maxCycles = budget
+        };
+        presented = 0;
+        Chip8RunStats stats = engine == ENGINE_LOCKSTEP
+            ? runLockstep(procs, budget, ipf)
+            : Chip8_run(proc, &config);
+        Chip8Jit_disable(proc);
+        if (proc->trap != CHIP8_TRAP_NONE) {
+            fprintf(stderr, "%s: %03X - %s (%04X)\n", rom->name,
+                    proc->trapPC, Chip8_trapName(proc->trap),
+                    proc->trapOpcode);
+            return false;
+        }
+        if (i == 0 || stats.seconds < best.seconds) {
+            best = stats;
+            bestPresented = presented;
+        }
+    }
+
+    printf("{\"rom\":\"%s\",\"class\":\"%s\",\"engine\":\"%s\","
+            "\"ipf\":%u,\"instructions\":%llu,\"seconds\":%.6f,\"ips\":%.0f,"
+            "\"ns_per_op\":%.3f,\"fps\":%.0f,\"presented\":%llu}\n",
+            rom->name, rom->opClass, engineNames[engine], ipf,
+            (unsigned long long) best.cycles, best.seconds, best.ips,
+            best.cycles > 0 ? best.seconds * 1e9 / best.cycles : 0,
+            best.seconds > 0 ? best.frames / best.seconds : 0,
+            (unsigned long long) bestPresented);
+    return true;
+}
+
+/*
+ * Run the CHIP8_LANES processors in lanes as one lockstep group for budget
+ * instructions each, ipf instructions per frame, ticking and presenting
+ * every lane after each frame as Chip8_run would. The stats count the
+ * instructions of every lane.
+ */
+Chip8RunStats runLockstep(Chip8Proc *lanes, uint64_t budget, unsigned ipf) {
+    Chip8Proc *procs[CHIP8_LANES];
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        procs[lane] = &lanes[lane];
+    }
+    Chip8Lockstep group;
+    Chip8Lockstep_init(&group, procs, CHIP8_LANES);
+    Chip8RunStats stats = { .running = true };
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint64_t done = 0; stats.running && done < budget; done += ipf) {
+        stats.running = Chip8Lockstep_execute(&group,
+                budget - done < ipf ? budget - done : ipf);
+        Chip8Lockstep_sync(&group);
+        for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+            Chip8_tick(&lanes[lane]);
+            Chip8_present(&lanes[lane]);
+        }
+        ++stats.frames;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        stats.cycles += lanes[lane].cycles;
+    }
+    stats.seconds = (end.tv_sec - start.tv_sec)
+        + (end.tv_nsec - start.tv_nsec) / 1e9;
+    stats.ips = stats.seconds > 0 ? stats.cycles / stats.seconds : 0;
+    return stats;
+}
@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/build/test/unit/src/Chip8Aot.c" "CMakeFiles/AotCompile.dir/src/Chip8Aot.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Aot.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Audio.c" "CMakeFiles/AotCompile.dir/src/Chip8Audio.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Audio.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Batch.c" "CMakeFiles/AotCompile.dir/src/Chip8Batch.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Batch.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Capture.c" "CMakeFiles/AotCompile.dir/src/Chip8Capture.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Capture.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Console.c" "CMakeFiles/AotCompile.dir/src/Chip8Console.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Console.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Core.c" "CMakeFiles/AotCompile.dir/src/Chip8Core.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Core.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Debug.c" "CMakeFiles/AotCompile.dir/src/Chip8Debug.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Debug.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Input.c" "CMakeFiles/AotCompile.dir/src/Chip8Input.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Input.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Jit.c" "CMakeFiles/AotCompile.dir/src/Chip8Jit.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Jit.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Lockstep.c" "CMakeFiles/AotCompile.dir/src/Chip8Lockstep.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Lockstep.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Pool.c" "CMakeFiles/AotCompile.dir/src/Chip8Pool.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Pool.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Present.c" "CMakeFiles/AotCompile.dir/src/Chip8Present.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Present.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Profile.c" "CMakeFiles/AotCompile.dir/src/Chip8Profile.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Profile.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Rom.c" "CMakeFiles/AotCompile.dir/src/Chip8Rom.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Rom.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Run.c" "CMakeFiles/AotCompile.dir/src/Chip8Run.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Run.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8State.c" "CMakeFiles/AotCompile.dir/src/Chip8State.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8State.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Term.c" "CMakeFiles/AotCompile.dir/src/Chip8Term.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Term.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Trace.c" "CMakeFiles/AotCompile.dir/src/Chip8Trace.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Chip8Trace.c.o.d"
+  "/root/repo/build/test/unit/src/Guards.c" "CMakeFiles/AotCompile.dir/src/Guards.c.o" "gcc" "CMakeFiles/AotCompile.dir/src/Guards.c.o.d"
+  "/root/repo/build/test/unit/tools/AotCompile.c" "CMakeFiles/AotCompile.dir/tools/AotCompile.c.o" "gcc" "CMakeFiles/AotCompile.dir/tools/AotCompile.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
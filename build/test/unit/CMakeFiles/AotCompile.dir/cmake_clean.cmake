@@ -0,0 +1,49 @@
+file(REMOVE_RECURSE
+  "AotCompile"
+  "AotCompile.pdb"
+  "CMakeFiles/AotCompile.dir/src/Chip8Aot.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Aot.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Audio.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Audio.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Batch.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Batch.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Capture.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Capture.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Console.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Console.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Core.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Core.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Debug.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Debug.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Input.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Input.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Jit.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Jit.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Lockstep.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Lockstep.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Pool.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Pool.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Present.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Present.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Profile.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Profile.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Rom.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Rom.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Run.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Run.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8State.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8State.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Term.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Term.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Chip8Trace.c.o"
+  "CMakeFiles/AotCompile.dir/src/Chip8Trace.c.o.d"
+  "CMakeFiles/AotCompile.dir/src/Guards.c.o"
+  "CMakeFiles/AotCompile.dir/src/Guards.c.o.d"
+  "CMakeFiles/AotCompile.dir/tools/AotCompile.c.o"
+  "CMakeFiles/AotCompile.dir/tools/AotCompile.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/AotCompile.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,59 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/build/test/unit/aot/random1.sc8.c" "CMakeFiles/all_tests.dir/aot/random1.sc8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random1.sc8.c.o.d"
+  "/root/repo/build/test/unit/aot/random2.ch8.c" "CMakeFiles/all_tests.dir/aot/random2.ch8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random2.ch8.c.o.d"
+  "/root/repo/build/test/unit/aot/random3.sc8.c" "CMakeFiles/all_tests.dir/aot/random3.sc8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random3.sc8.c.o.d"
+  "/root/repo/build/test/unit/aot/random4.ch8.c" "CMakeFiles/all_tests.dir/aot/random4.ch8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random4.ch8.c.o.d"
+  "/root/repo/build/test/unit/aot/random5.sc8.c" "CMakeFiles/all_tests.dir/aot/random5.sc8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random5.sc8.c.o.d"
+  "/root/repo/build/test/unit/aot/random6.ch8.c" "CMakeFiles/all_tests.dir/aot/random6.ch8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random6.ch8.c.o.d"
+  "/root/repo/build/test/unit/aot/random7.sc8.c" "CMakeFiles/all_tests.dir/aot/random7.sc8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random7.sc8.c.o.d"
+  "/root/repo/build/test/unit/aot/random8.ch8.c" "CMakeFiles/all_tests.dir/aot/random8.ch8.c.o" "gcc" "CMakeFiles/all_tests.dir/aot/random8.ch8.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Aot.c" "CMakeFiles/all_tests.dir/src/Chip8Aot.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Aot.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Audio.c" "CMakeFiles/all_tests.dir/src/Chip8Audio.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Audio.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Batch.c" "CMakeFiles/all_tests.dir/src/Chip8Batch.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Batch.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Capture.c" "CMakeFiles/all_tests.dir/src/Chip8Capture.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Capture.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Console.c" "CMakeFiles/all_tests.dir/src/Chip8Console.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Console.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Core.c" "CMakeFiles/all_tests.dir/src/Chip8Core.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Core.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Debug.c" "CMakeFiles/all_tests.dir/src/Chip8Debug.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Debug.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Input.c" "CMakeFiles/all_tests.dir/src/Chip8Input.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Input.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Jit.c" "CMakeFiles/all_tests.dir/src/Chip8Jit.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Jit.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Lockstep.c" "CMakeFiles/all_tests.dir/src/Chip8Lockstep.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Lockstep.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Pool.c" "CMakeFiles/all_tests.dir/src/Chip8Pool.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Pool.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Present.c" "CMakeFiles/all_tests.dir/src/Chip8Present.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Present.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Profile.c" "CMakeFiles/all_tests.dir/src/Chip8Profile.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Profile.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Rom.c" "CMakeFiles/all_tests.dir/src/Chip8Rom.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Rom.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Run.c" "CMakeFiles/all_tests.dir/src/Chip8Run.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Run.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8State.c" "CMakeFiles/all_tests.dir/src/Chip8State.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8State.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Term.c" "CMakeFiles/all_tests.dir/src/Chip8Term.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Term.c.o.d"
+  "/root/repo/build/test/unit/src/Chip8Trace.c" "CMakeFiles/all_tests.dir/src/Chip8Trace.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Chip8Trace.c.o.d"
+  "/root/repo/build/test/unit/src/Guards.c" "CMakeFiles/all_tests.dir/src/Guards.c.o" "gcc" "CMakeFiles/all_tests.dir/src/Guards.c.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Aot.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Aot.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Aot.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Audio.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Audio.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Audio.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Capture.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Capture.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Capture.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Core.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Core.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Core.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Debug.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Debug.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Debug.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Idle.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Idle.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Idle.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Input.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Input.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Input.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Jit.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Jit.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Jit.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Lockstep.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Lockstep.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Lockstep.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Pool.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Pool.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Pool.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Rom.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Rom.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Rom.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8State.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8State.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8State.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Threaded.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Threaded.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Threaded.cpp.o.d"
+  "/root/repo/build/test/unit/test/unit/Chip8Trace.cpp" "CMakeFiles/all_tests.dir/test/unit/Chip8Trace.cpp.o" "gcc" "CMakeFiles/all_tests.dir/test/unit/Chip8Trace.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,99 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/all_tests.dir/aot/random1.sc8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random1.sc8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random2.ch8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random2.ch8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random3.sc8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random3.sc8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random4.ch8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random4.ch8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random5.sc8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random5.sc8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random6.ch8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random6.ch8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random7.sc8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random7.sc8.c.o.d"
+  "CMakeFiles/all_tests.dir/aot/random8.ch8.c.o"
+  "CMakeFiles/all_tests.dir/aot/random8.ch8.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Aot.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Aot.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Audio.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Audio.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Batch.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Batch.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Capture.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Capture.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Console.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Console.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Core.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Core.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Debug.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Debug.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Input.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Input.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Jit.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Jit.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Lockstep.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Lockstep.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Pool.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Pool.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Present.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Present.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Profile.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Profile.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Rom.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Rom.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Run.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Run.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8State.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8State.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Term.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Term.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Chip8Trace.c.o"
+  "CMakeFiles/all_tests.dir/src/Chip8Trace.c.o.d"
+  "CMakeFiles/all_tests.dir/src/Guards.c.o"
+  "CMakeFiles/all_tests.dir/src/Guards.c.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Aot.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Aot.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Audio.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Audio.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Capture.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Capture.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Core.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Core.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Debug.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Debug.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Idle.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Idle.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Input.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Input.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Jit.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Jit.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Lockstep.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Lockstep.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Pool.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Pool.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Rom.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Rom.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8State.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8State.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Threaded.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Threaded.cpp.o.d"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Trace.cpp.o"
+  "CMakeFiles/all_tests.dir/test/unit/Chip8Trace.cpp.o.d"
+  "all_tests"
+  "all_tests.pdb"
+  "aot/random1.sc8.c"
+  "aot/random2.ch8.c"
+  "aot/random3.sc8.c"
+  "aot/random4.ch8.c"
+  "aot/random5.sc8.c"
+  "aot/random6.ch8.c"
+  "aot/random7.sc8.c"
+  "aot/random8.ch8.c"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/all_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/build/test/unit
+# Build directory: /root/repo/build/test/unit
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(all_tests "/root/repo/build/test/unit/all_tests")
+set_tests_properties(all_tests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/build/test/unit/CMakeLists.txt;83;add_test;/root/repo/build/test/unit/CMakeLists.txt;0;")
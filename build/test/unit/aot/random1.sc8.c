@@ -0,0 +1,116 @@
+/* Generated by AotCompile from "random1" (SUPER-CHIP, 4 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[160] = {
+    0x7A, 0x17, 0x12, 0x96, 0x41, 0x02, 0x62, 0x05, 0x76, 0x18, 0xCB, 0x0F,
+    0x71, 0xEC, 0xA2, 0x15, 0x43, 0x01, 0xF3, 0x75, 0x79, 0x97, 0x39, 0xD4,
+    0xC1, 0x3C, 0x00, 0xFF, 0x3A, 0x1E, 0x7C, 0x38, 0xEE, 0xA1, 0x60, 0x00,
+    0xC1, 0xC6, 0x73, 0x48, 0x74, 0x00, 0xE1, 0xA1, 0x74, 0x9C, 0xA2, 0x5A,
+    0x12, 0x7E, 0xC1, 0xD3, 0x3B, 0x2B, 0x54, 0x70, 0xB2, 0x70, 0x7F, 0x00,
+    0x7D, 0x00, 0x4F, 0x01, 0x88, 0x4E, 0x39, 0x57, 0xFC, 0x18, 0x83, 0x1E,
+    0x44, 0x01, 0xC3, 0xCE, 0x75, 0x40, 0x81, 0x77, 0x8F, 0x5E, 0x79, 0x14,
+    0xDC, 0x7E, 0x5B, 0xE0, 0x72, 0xF9, 0xEB, 0xA1, 0x62, 0x9F, 0x9D, 0xA0,
+    0x48, 0x03, 0xFA, 0x33, 0xCC, 0xBB, 0x22, 0x50, 0x4E, 0x01, 0xE1, 0x9E,
+    0x64, 0x0D, 0x12, 0x34, 0x7F, 0xC2, 0x80, 0x94, 0x7B, 0x2F, 0x62, 0x11,
+    0xA2, 0x63, 0xD1, 0xFB, 0xD1, 0xF0, 0x12, 0x36, 0x81, 0x90, 0x95, 0x30,
+    0xA2, 0x88, 0x92, 0x90, 0x7E, 0x5D, 0xEF, 0xA1, 0xCB, 0xA1, 0x60, 0x00,
+    0x75, 0x00, 0x30, 0x4A, 0x12, 0x40, 0x7A, 0xA7, 0x7B, 0x00, 0x5E, 0x10,
+    0xB2, 0x30, 0xD1, 0x14,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random1",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = true,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x296: goto L296;
+        case 0x29C: goto L29C;
+        case 0x29E: goto L29E;
+        default: return;
+    }
+L200:
+    if (self->cycles + 2 > end) { self->PC = 0x200; return; }
+    V[10] += 0x17;
+    self->cycles += 2;
+    goto L296;
+L296:
+    if (self->cycles + 3 > end) { self->PC = 0x296; return; }
+    V[10] += 0xA7;
+    V[11] += 0x00;
+    self->cycles += 3;
+    if (V[14] == V[1]) {
+        goto L29E;
+    }
+    goto L29C;
+L29C:
+    if (self->cycles + 1 > end) { self->PC = 0x29C; return; }
+    self->cycles += 1;
+    self->PC = 0x230 + V[0];
+    goto dispatch;
+L29E:
+    if (self->cycles + 1 > end) { self->PC = 0x29E; return; }
+    if (!Chip8Aot_helper(self, 0x29E)) { return; }
+    self->PC = 0x2A0;
+    return;
+}
@@ -0,0 +1,128 @@
+/* Generated by AotCompile from "random2" (CHIP-8, 6 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[192] = {
+    0xF4, 0x75, 0x00, 0xFF, 0x00, 0xFE, 0x69, 0xE5, 0x8B, 0xA6, 0x7D, 0x91,
+    0x5C, 0xA0, 0xB2, 0x70, 0xB2, 0x90, 0xD1, 0x39, 0x96, 0x70, 0x6E, 0xAE,
+    0x51, 0xE0, 0x12, 0x28, 0x59, 0xF0, 0x00, 0xFE, 0x40, 0x03, 0xA2, 0x32,
+    0x60, 0x00, 0xC0, 0x29, 0x37, 0xD7, 0xC6, 0xD8, 0x9C, 0x60, 0xCA, 0x9E,
+    0x7B, 0x29, 0xB2, 0x40, 0xDA, 0x42, 0x37, 0x4F, 0x6E, 0xE7, 0x60, 0x00,
+    0xB2, 0x40, 0xF1, 0x55, 0x97, 0x70, 0xA2, 0x4B, 0x7D, 0x4D, 0x71, 0x73,
+    0xB2, 0x60, 0xA2, 0x5D, 0x98, 0xD0, 0xF7, 0x85, 0xCB, 0x33, 0xD2, 0x7E,
+    0xA2, 0xAA, 0x46, 0x02, 0x00, 0xFB, 0x72, 0x69, 0xC0, 0xEC, 0x75, 0x00,
+    0xB2, 0xB0, 0xB2, 0xB0, 0xD7, 0xBC, 0x12, 0xBC, 0xF1, 0x65, 0xDC, 0x68,
+    0x53, 0x10, 0x3E, 0x41, 0x84, 0x70, 0x7C, 0x32, 0x5D, 0x30, 0x99, 0xC0,
+    0x77, 0x00, 0x12, 0x60, 0x79, 0x00, 0x58, 0x20, 0x78, 0x00, 0x72, 0x65,
+    0x46, 0x00, 0x4B, 0x00, 0xA2, 0x32, 0x47, 0x03, 0x7B, 0xC0, 0x8D, 0x90,
+    0x77, 0x25, 0x7C, 0xB3, 0xA2, 0x41, 0x60, 0x00, 0x71, 0x3D, 0x4A, 0x01,
+    0xB2, 0x20, 0x12, 0x02, 0x96, 0x50, 0x12, 0x40, 0xE6, 0xA1, 0xFD, 0x18,
+    0x97, 0xD0, 0x62, 0xCB, 0x33, 0xC5, 0xB2, 0x90, 0x5C, 0x10, 0x12, 0x0E,
+    0xB2, 0x10, 0xCA, 0x4A, 0x6C, 0x9D, 0x3F, 0x77, 0x71, 0x26, 0x7F, 0x31,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random2",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = false,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x202: goto L202;
+        case 0x204: goto L204;
+        case 0x206: goto L206;
+        case 0x20E: goto L20E;
+        case 0x210: goto L210;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    if (!Chip8Aot_helper(self, 0x200)) { return; }
+    goto L202;
+L202:
+    if (self->cycles + 1 > end) { self->PC = 0x202; return; }
+    if (!Chip8Aot_helper(self, 0x202)) { return; }
+    goto L204;
+L204:
+    if (self->cycles + 1 > end) { self->PC = 0x204; return; }
+    if (!Chip8Aot_helper(self, 0x204)) { return; }
+    goto L206;
+L206:
+    if (self->cycles + 4 > end) { self->PC = 0x206; return; }
+    V[9] = 0xE5;
+    V[15] = V[10] & 0x01; V[11] = V[10] >> 1;
+    V[13] += 0x91;
+    self->cycles += 4;
+    if (V[12] == V[10]) {
+        goto L210;
+    }
+    goto L20E;
+L20E:
+    if (self->cycles + 1 > end) { self->PC = 0x20E; return; }
+    self->cycles += 1;
+    self->PC = 0x270 + V[0];
+    goto dispatch;
+L210:
+    if (self->cycles + 1 > end) { self->PC = 0x210; return; }
+    self->cycles += 1;
+    self->PC = 0x290 + V[0];
+    goto dispatch;
+}
@@ -0,0 +1,184 @@
+/* Generated by AotCompile from "random3" (SUPER-CHIP, 12 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[224] = {
+    0x7C, 0xFE, 0x30, 0x6F, 0x66, 0x1D, 0x50, 0xE0, 0xA2, 0x1E, 0x12, 0x10,
+    0xB2, 0x10, 0x7D, 0xCB, 0x71, 0x79, 0x7F, 0x52, 0x46, 0x01, 0xD8, 0xC0,
+    0x78, 0xB1, 0x66, 0x8D, 0x5E, 0xE0, 0xDC, 0x62, 0x74, 0xEB, 0x5E, 0xA0,
+    0x75, 0x00, 0x6C, 0xF5, 0x60, 0x00, 0x60, 0x00, 0x79, 0x00, 0x7C, 0x45,
+    0xA2, 0x79, 0xB2, 0x20, 0x70, 0x0F, 0x00, 0xFE, 0x78, 0x03, 0x76, 0x06,
+    0xFA, 0x65, 0x60, 0x00, 0x62, 0x5F, 0x70, 0x00, 0x7F, 0x44, 0x7A, 0xCD,
+    0xA2, 0xD0, 0x74, 0x00, 0x7A, 0x42, 0x55, 0xA0, 0x7C, 0x69, 0x12, 0xA2,
+    0xF1, 0x75, 0x9D, 0xC0, 0x7B, 0xEC, 0xF9, 0x55, 0x78, 0x3C, 0x76, 0x00,
+    0x00, 0xFF, 0x3A, 0x45, 0xC2, 0xF9, 0x5E, 0x00, 0xCC, 0x46, 0x9D, 0x00,
+    0x77, 0xB6, 0x7B, 0xED, 0x60, 0x00, 0x63, 0xCA, 0x73, 0x00, 0x12, 0xA4,
+    0x3B, 0x6A, 0x7F, 0x00, 0x68, 0xB0, 0x77, 0x00, 0xC7, 0xF8, 0x71, 0x4F,
+    0x5E, 0x70, 0x7F, 0x5A, 0x87, 0xA6, 0x72, 0x2C, 0x76, 0x55, 0x6F, 0xF6,
+    0x60, 0x00, 0xA2, 0x7C, 0x65, 0xA8, 0x77, 0xE8, 0x87, 0x4E, 0x9A, 0xB0,
+    0x7B, 0xAC, 0x31, 0x52, 0x77, 0x08, 0x90, 0x00, 0x60, 0x00, 0xC5, 0xD9,
+    0x97, 0x10, 0x7A, 0x5A, 0xEE, 0xA1, 0x7F, 0x8E, 0x8F, 0x8E, 0x00, 0xFC,
+    0x76, 0x00, 0x98, 0x50, 0x72, 0x6E, 0x77, 0x62, 0x72, 0x9A, 0xDD, 0x50,
+    0x72, 0x13, 0xA2, 0x85, 0x37, 0xFF, 0x12, 0xC2, 0x22, 0xB0, 0x65, 0xB4,
+    0x72, 0xC3, 0x34, 0x08, 0x70, 0xCA, 0x60, 0x00, 0x7B, 0xCC, 0x7F, 0x00,
+    0x12, 0x52, 0x12, 0x02, 0x43, 0x02, 0xCD, 0x1C,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random3",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = true,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x204: goto L204;
+        case 0x206: goto L206;
+        case 0x208: goto L208;
+        case 0x20A: goto L20A;
+        case 0x210: goto L210;
+        case 0x216: goto L216;
+        case 0x218: goto L218;
+        case 0x21E: goto L21E;
+        case 0x220: goto L220;
+        case 0x224: goto L224;
+        case 0x226: goto L226;
+        default: return;
+    }
+L200:
+    if (self->cycles + 2 > end) { self->PC = 0x200; return; }
+    V[12] += 0xFE;
+    self->cycles += 2;
+    if (V[0] == 0x6F) {
+        goto L206;
+    }
+    goto L204;
+L204:
+    if (self->cycles + 1 > end) { self->PC = 0x204; return; }
+    V[6] = 0x1D;
+    self->cycles += 1;
+    goto L206;
+L206:
+    if (self->cycles + 1 > end) { self->PC = 0x206; return; }
+    self->cycles += 1;
+    if (V[0] == V[14]) {
+        goto L20A;
+    }
+    goto L208;
+L208:
+    if (self->cycles + 1 > end) { self->PC = 0x208; return; }
+    self->I = 0x21E;
+    self->cycles += 1;
+    goto L20A;
+L20A:
+    if (self->cycles + 1 > end) { self->PC = 0x20A; return; }
+    self->cycles += 1;
+    goto L210;
+L210:
+    if (self->cycles + 3 > end) { self->PC = 0x210; return; }
+    V[1] += 0x79;
+    V[15] += 0x52;
+    self->cycles += 3;
+    if (V[6] != 0x01) {
+        goto L218;
+    }
+    goto L216;
+L216:
+    if (self->cycles + 1 > end) { self->PC = 0x216; return; }
+    if (!Chip8Aot_helper(self, 0x216)) { return; }
+    goto L218;
+L218:
+    if (self->cycles + 3 > end) { self->PC = 0x218; return; }
+    V[8] += 0xB1;
+    V[6] = 0x8D;
+    self->cycles += 3;
+    if (1) {
+        goto L220;
+    }
+    goto L21E;
+L21E:
+    if (self->cycles + 1 > end) { self->PC = 0x21E; return; }
+    if (!Chip8Aot_helper(self, 0x21E)) { return; }
+    goto L220;
+L220:
+    if (self->cycles + 2 > end) { self->PC = 0x220; return; }
+    V[4] += 0xEB;
+    self->cycles += 2;
+    if (V[14] == V[10]) {
+        goto L226;
+    }
+    goto L224;
+L224:
+    if (self->cycles + 1 > end) { self->PC = 0x224; return; }
+    V[5] += 0x00;
+    self->cycles += 1;
+    goto L226;
+L226:
+    if (self->cycles + 7 > end) { self->PC = 0x226; return; }
+    V[12] = 0xF5;
+    V[0] = 0x00;
+    V[0] = 0x00;
+    V[9] += 0x00;
+    V[12] += 0x45;
+    self->I = 0x279;
+    self->cycles += 7;
+    self->PC = 0x220 + V[0];
+    goto dispatch;
+}
@@ -0,0 +1,168 @@
+/* Generated by AotCompile from "random4" (CHIP-8, 10 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[256] = {
+    0x12, 0xB0, 0xEC, 0xA1, 0x00, 0xE0, 0xF2, 0x07, 0x3F, 0x35, 0x12, 0xA0,
+    0xD8, 0xBA, 0x47, 0x00, 0x6E, 0x5F, 0x9E, 0x70, 0x60, 0x00, 0x60, 0x00,
+    0xB2, 0xA0, 0x66, 0x01, 0x12, 0x2E, 0x12, 0x7E, 0x76, 0xFC, 0x44, 0x03,
+    0x60, 0x00, 0x7C, 0xC4, 0x40, 0x01, 0x56, 0x70, 0x7A, 0x00, 0x60, 0x00,
+    0x12, 0x86, 0x51, 0x20, 0x6D, 0xC2, 0xC4, 0xDF, 0xB2, 0x10, 0x7C, 0xB1,
+    0xC0, 0xCC, 0x7B, 0x00, 0xFC, 0x15, 0x73, 0x56, 0xC9, 0x5D, 0x9A, 0xB0,
+    0x75, 0xDD, 0x71, 0x64, 0xE8, 0x9E, 0x70, 0x00, 0x6C, 0x0A, 0xF4, 0x55,
+    0xD5, 0x31, 0x60, 0x00, 0x3F, 0xB9, 0xA2, 0x0B, 0x73, 0x00, 0xEC, 0x9E,
+    0xB2, 0x00, 0xCD, 0x18, 0xE2, 0x9E, 0x7E, 0x7F, 0x43, 0x02, 0x98, 0x30,
+    0x73, 0x01, 0xE5, 0xA1, 0x3D, 0x52, 0xD4, 0xBF, 0x81, 0x2E, 0x41, 0x03,
+    0x00, 0xFE, 0xE1, 0x9E, 0x75, 0xA9, 0x00, 0xFE, 0x55, 0x30, 0x12, 0x0A,
+    0xB2, 0x00, 0xA2, 0x87, 0x7B, 0x00, 0x73, 0x07, 0x6C, 0x6B, 0xB2, 0x30,
+    0x77, 0x3C, 0xF0, 0x30, 0x76, 0xA9, 0x7B, 0x6F, 0x12, 0x6E, 0x78, 0x33,
+    0x5B, 0x20, 0xCA, 0x26, 0x74, 0xED, 0x60, 0x00, 0x4B, 0x01, 0x7E, 0x00,
+    0x98, 0xE0, 0x72, 0x8D, 0x12, 0x90, 0xD9, 0x54, 0xF6, 0x07, 0x78, 0xC4,
+    0x00, 0xFB, 0xE0, 0x9E, 0x96, 0x40, 0x53, 0xB0, 0x00, 0xFB, 0x93, 0x40,
+    0x9F, 0x10, 0x00, 0xEE, 0x72, 0x00, 0xB2, 0xC0, 0x81, 0xA6, 0x44, 0x01,
+    0xB2, 0xB0, 0x46, 0x02, 0x76, 0x21, 0xF7, 0x33, 0x3A, 0xB9, 0x60, 0x00,
+    0x5E, 0xD0, 0x7D, 0xFC, 0x22, 0x20, 0xF7, 0x29, 0xB2, 0x70, 0x7D, 0xF7,
+    0x00, 0xFB, 0xDA, 0x67, 0xED, 0x9E, 0x00, 0xFF, 0x7F, 0xEF, 0x86, 0x14,
+    0x8B, 0xE3, 0x3F, 0xE4, 0x56, 0xC0, 0xE2, 0x9E, 0xA2, 0xF5, 0x7A, 0xA3,
+    0x8D, 0x64, 0x78, 0x34,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random4",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = false,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x2B0: goto L2B0;
+        case 0x2B6: goto L2B6;
+        case 0x2B8: goto L2B8;
+        case 0x2BA: goto L2BA;
+        case 0x2BC: goto L2BC;
+        case 0x2BE: goto L2BE;
+        case 0x2C0: goto L2C0;
+        case 0x2C2: goto L2C2;
+        case 0x2C4: goto L2C4;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    self->cycles += 1;
+    goto L2B0;
+L2B0:
+    if (self->cycles + 3 > end) { self->PC = 0x2B0; return; }
+    V[6] = self->D;
+    V[8] += 0xC4;
+    self->cycles += 2;
+    if (!Chip8Aot_helper(self, 0x2B4)) { return; }
+    goto L2B6;
+L2B6:
+    if (self->cycles + 1 > end) { self->PC = 0x2B6; return; }
+    self->cycles += 1;
+    if ((self->keys >> (V[0] & 0xF) & 1)) {
+        goto L2BA;
+    }
+    goto L2B8;
+L2B8:
+    if (self->cycles + 1 > end) { self->PC = 0x2B8; return; }
+    self->cycles += 1;
+    if (V[6] != V[4]) {
+        goto L2BC;
+    }
+    goto L2BA;
+L2BA:
+    if (self->cycles + 1 > end) { self->PC = 0x2BA; return; }
+    self->cycles += 1;
+    if (V[3] == V[11]) {
+        goto L2BE;
+    }
+    goto L2BC;
+L2BC:
+    if (self->cycles + 1 > end) { self->PC = 0x2BC; return; }
+    if (!Chip8Aot_helper(self, 0x2BC)) { return; }
+    goto L2BE;
+L2BE:
+    if (self->cycles + 1 > end) { self->PC = 0x2BE; return; }
+    self->cycles += 1;
+    if (V[3] != V[4]) {
+        goto L2C2;
+    }
+    goto L2C0;
+L2C0:
+    if (self->cycles + 1 > end) { self->PC = 0x2C0; return; }
+    self->cycles += 1;
+    if (V[15] != V[1]) {
+        goto L2C4;
+    }
+    goto L2C2;
+L2C2:
+    if (self->cycles + 1 > end) { self->PC = 0x2C2; return; }
+    if (self->SC < 0) { self->PC = 0x2C2; return; }
+    self->PC = self->stack[self->SC--] + 2;
+    self->cycles += 1;
+    goto dispatch;
+L2C4:
+    if (self->cycles + 2 > end) { self->PC = 0x2C4; return; }
+    V[2] += 0x00;
+    self->cycles += 2;
+    self->PC = 0x2C0 + V[0];
+    goto dispatch;
+}
@@ -0,0 +1,146 @@
+/* Generated by AotCompile from "random5" (SUPER-CHIP, 7 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[288] = {
+    0xDB, 0xFF, 0x77, 0xE2, 0xA2, 0x90, 0x8A, 0xE0, 0xE7, 0x9E, 0x38, 0xD5,
+    0x66, 0x94, 0xD7, 0xF3, 0xDE, 0x04, 0x7F, 0x06, 0x7A, 0xD4, 0xB2, 0x20,
+    0x12, 0xB0, 0xCC, 0x85, 0xD2, 0x91, 0x00, 0xFF, 0x12, 0x64, 0xB2, 0x10,
+    0xFA, 0x85, 0x92, 0x40, 0x12, 0x52, 0x71, 0x1C, 0x72, 0x00, 0x79, 0x00,
+    0x72, 0x00, 0xC6, 0x95, 0x3D, 0x84, 0x00, 0xFC, 0xE3, 0x9E, 0x66, 0xF7,
+    0x3F, 0x53, 0x7C, 0x8D, 0x76, 0x31, 0xFC, 0x0A, 0x00, 0xC2, 0x72, 0x69,
+    0x22, 0xB8, 0x7A, 0x3A, 0x00, 0xE0, 0x8C, 0x01, 0x00, 0xFD, 0x3D, 0x76,
+    0xC4, 0x17, 0x13, 0x12, 0x97, 0xA0, 0x32, 0x88, 0x12, 0x1C, 0x00, 0xFF,
+    0x3E, 0x89, 0xD4, 0x15, 0x7B, 0x79, 0x71, 0x87, 0x00, 0xFE, 0xA2, 0x9E,
+    0xC0, 0x9E, 0x75, 0x7D, 0x3C, 0xC9, 0x13, 0x10, 0xB2, 0x60, 0xA2, 0x66,
+    0xED, 0x9E, 0x60, 0x00, 0x74, 0xCF, 0x81, 0x71, 0x7C, 0x00, 0x8A, 0xEE,
+    0x12, 0xE2, 0xA2, 0x5E, 0x7C, 0x00, 0x00, 0xFC, 0xFC, 0x07, 0x75, 0x04,
+    0xF6, 0x1E, 0x7D, 0x00, 0xF1, 0x33, 0x9A, 0x90, 0x70, 0xDB, 0xA2, 0xC8,
+    0x5D, 0x90, 0x34, 0xD2, 0x76, 0x13, 0x97, 0x20, 0x72, 0x32, 0x60, 0x00,
+    0xD3, 0xF3, 0xDE, 0xC4, 0xC7, 0xB1, 0x53, 0x30, 0xE2, 0x9E, 0x73, 0x98,
+    0x75, 0x4F, 0x7F, 0xF2, 0xA3, 0x0F, 0xB3, 0x00, 0x8A, 0x8E, 0xA2, 0xF0,
+    0x73, 0x00, 0xDB, 0x93, 0xB2, 0x60, 0xC2, 0x32, 0x74, 0x00, 0x69, 0x7B,
+    0x7D, 0x48, 0x9A, 0xF0, 0x4C, 0x02, 0xB2, 0xC0, 0xC9, 0x64, 0xC4, 0x5A,
+    0x75, 0x85, 0x3A, 0x89, 0x00, 0xEE, 0xD9, 0x47, 0x78, 0x13, 0x84, 0x1E,
+    0x7F, 0x14, 0x49, 0x00, 0x64, 0x04, 0x00, 0xEE, 0x7A, 0x00, 0x8E, 0x74,
+    0x12, 0x20, 0xDD, 0xCB, 0x53, 0x10, 0xFE, 0x18, 0x22, 0x70, 0xF3, 0x0A,
+    0xC8, 0x4B, 0x77, 0xA4, 0x30, 0x71, 0x99, 0x50, 0x22, 0xD8, 0x72, 0x00,
+    0xE1, 0x9E, 0x12, 0xF2, 0x72, 0xE0, 0x13, 0x1C, 0xEC, 0x9E, 0x95, 0x50,
+    0x7B, 0x51, 0xFB, 0x18, 0xCA, 0xFF, 0x12, 0x42, 0x00, 0xC2, 0x12, 0x28,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random5",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = true,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x202: goto L202;
+        case 0x20A: goto L20A;
+        case 0x20C: goto L20C;
+        case 0x20E: goto L20E;
+        case 0x210: goto L210;
+        case 0x212: goto L212;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    if (!Chip8Aot_helper(self, 0x200)) { return; }
+    goto L202;
+L202:
+    if (self->cycles + 4 > end) { self->PC = 0x202; return; }
+    V[7] += 0xE2;
+    self->I = 0x290;
+    V[10] = V[14];
+    self->cycles += 4;
+    if ((self->keys >> (V[7] & 0xF) & 1)) {
+        goto L20C;
+    }
+    goto L20A;
+L20A:
+    if (self->cycles + 1 > end) { self->PC = 0x20A; return; }
+    self->cycles += 1;
+    if (V[8] == 0xD5) {
+        goto L20E;
+    }
+    goto L20C;
+L20C:
+    if (self->cycles + 1 > end) { self->PC = 0x20C; return; }
+    V[6] = 0x94;
+    self->cycles += 1;
+    goto L20E;
+L20E:
+    if (self->cycles + 1 > end) { self->PC = 0x20E; return; }
+    if (!Chip8Aot_helper(self, 0x20E)) { return; }
+    goto L210;
+L210:
+    if (self->cycles + 1 > end) { self->PC = 0x210; return; }
+    if (!Chip8Aot_helper(self, 0x210)) { return; }
+    goto L212;
+L212:
+    if (self->cycles + 3 > end) { self->PC = 0x212; return; }
+    V[15] += 0x06;
+    V[10] += 0xD4;
+    self->cycles += 3;
+    self->PC = 0x220 + V[0];
+    goto dispatch;
+}
@@ -0,0 +1,463 @@
+/* Generated by AotCompile from "random6" (CHIP-8, 51 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[320] = {
+    0xC9, 0xF1, 0x6E, 0x46, 0x5B, 0x10, 0x00, 0xFB, 0x7E, 0x00, 0xF4, 0x33,
+    0x67, 0xC4, 0x64, 0x10, 0x12, 0xBE, 0x7D, 0x33, 0x72, 0x00, 0x8D, 0x11,
+    0x12, 0xCA, 0xA2, 0x95, 0x3E, 0x04, 0xA2, 0xF8, 0x30, 0xBF, 0x49, 0x01,
+    0x3C, 0xBC, 0xDB, 0x9C, 0xCC, 0x9D, 0xA2, 0xA5, 0x85, 0x74, 0x3A, 0xBA,
+    0x55, 0x80, 0xD4, 0x24, 0x58, 0x20, 0x83, 0xB6, 0x31, 0x83, 0xE5, 0xA1,
+    0xB2, 0x70, 0x78, 0x1A, 0x00, 0xEE, 0x12, 0x7A, 0x37, 0x03, 0x12, 0x38,
+    0xD1, 0xA6, 0xF6, 0x85, 0x12, 0x90, 0xFE, 0x33, 0xCD, 0x90, 0x33, 0xE0,
+    0xB2, 0x00, 0x12, 0x30, 0x75, 0x56, 0x60, 0x00, 0x51, 0x10, 0x78, 0xD3,
+    0xB2, 0xA0, 0xC4, 0x5C, 0x6E, 0x73, 0x98, 0x10, 0xB3, 0x10, 0x7F, 0x46,
+    0x77, 0x00, 0x42, 0x00, 0xC4, 0xDE, 0x50, 0xC0, 0x59, 0xD0, 0x78, 0x00,
+    0x79, 0xB3, 0x34, 0x9E, 0x78, 0x25, 0x4C, 0x00, 0x60, 0x00, 0xB2, 0x40,
+    0x00, 0xFD, 0xED, 0xA1, 0xDE, 0x02, 0x13, 0x34, 0x13, 0x0E, 0xA2, 0x9F,
+    0x91, 0xE0, 0x12, 0x14, 0x72, 0x38, 0xB2, 0x00, 0x73, 0xCA, 0x60, 0x00,
+    0x96, 0x30, 0xF1, 0x1E, 0x42, 0x00, 0xC2, 0x36, 0xE3, 0x9E, 0xE8, 0xA1,
+    0x5D, 0xE0, 0x34, 0x4C, 0x13, 0x2E, 0x6C, 0x62, 0x7C, 0x98, 0xE0, 0xA1,
+    0x9A, 0x40, 0xFB, 0x15, 0x60, 0x00, 0x44, 0x01, 0x6A, 0x58, 0x22, 0xF0,
+    0xA2, 0x2C, 0x6E, 0x47, 0x13, 0x3C, 0x87, 0xC5, 0x52, 0x10, 0x73, 0xC9,
+    0x64, 0xDA, 0x74, 0x0C, 0x56, 0x30, 0x76, 0x41, 0x7F, 0x10, 0x50, 0xC0,
+    0xC6, 0xBF, 0xDC, 0xE2, 0x70, 0x1D, 0x58, 0xD0, 0xE1, 0x9E, 0xE0, 0x9E,
+    0x7D, 0x8D, 0xF8, 0x30, 0x72, 0x23, 0x5F, 0xA0, 0xA3, 0x13, 0x37, 0x52,
+    0x00, 0xFC, 0x90, 0x40, 0x3E, 0xFA, 0x7D, 0x24, 0xF0, 0x85, 0x45, 0x01,
+    0x7A, 0x61, 0xDD, 0xB8, 0x53, 0xB0, 0x76, 0xAC, 0xF2, 0x18, 0x79, 0xA5,
+    0xA2, 0x3F, 0x49, 0x01, 0x12, 0x98, 0x9C, 0x10, 0x75, 0x09, 0x73, 0x04,
+    0xE2, 0x9E, 0xDD, 0x37, 0x70, 0x8F, 0xA2, 0x52, 0x33, 0x68, 0x78, 0x00,
+    0x55, 0x80, 0x78, 0xB3, 0xB2, 0x60, 0x00, 0xE0, 0x60, 0x00, 0xF4, 0x85,
+    0x66, 0xB2, 0x79, 0x0C, 0x74, 0x00, 0x22, 0x80, 0x00, 0xFC, 0x00, 0xFC,
+    0x49, 0x00, 0x70, 0x51, 0x33, 0x15, 0x00, 0xFB,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0xC0, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random6",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = false,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x202: goto L202;
+        case 0x206: goto L206;
+        case 0x208: goto L208;
+        case 0x20C: goto L20C;
+        case 0x280: goto L280;
+        case 0x298: goto L298;
+        case 0x29E: goto L29E;
+        case 0x2A0: goto L2A0;
+        case 0x2A2: goto L2A2;
+        case 0x2A4: goto L2A4;
+        case 0x2A6: goto L2A6;
+        case 0x2A8: goto L2A8;
+        case 0x2AA: goto L2AA;
+        case 0x2AC: goto L2AC;
+        case 0x2AE: goto L2AE;
+        case 0x2B4: goto L2B4;
+        case 0x2B6: goto L2B6;
+        case 0x2B8: goto L2B8;
+        case 0x2BC: goto L2BC;
+        case 0x2BE: goto L2BE;
+        case 0x2C0: goto L2C0;
+        case 0x2F0: goto L2F0;
+        case 0x2F2: goto L2F2;
+        case 0x2F4: goto L2F4;
+        case 0x2F6: goto L2F6;
+        case 0x2F8: goto L2F8;
+        case 0x2FA: goto L2FA;
+        case 0x2FC: goto L2FC;
+        case 0x2FE: goto L2FE;
+        case 0x300: goto L300;
+        case 0x302: goto L302;
+        case 0x304: goto L304;
+        case 0x306: goto L306;
+        case 0x30C: goto L30C;
+        case 0x30E: goto L30E;
+        case 0x310: goto L310;
+        case 0x312: goto L312;
+        case 0x316: goto L316;
+        case 0x318: goto L318;
+        case 0x31E: goto L31E;
+        case 0x320: goto L320;
+        case 0x322: goto L322;
+        case 0x324: goto L324;
+        case 0x32E: goto L32E;
+        case 0x334: goto L334;
+        case 0x336: goto L336;
+        case 0x338: goto L338;
+        case 0x33A: goto L33A;
+        case 0x33C: goto L33C;
+        case 0x33E: goto L33E;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    if (!Chip8Aot_helper(self, 0x200)) { return; }
+    goto L202;
+L202:
+    if (self->cycles + 2 > end) { self->PC = 0x202; return; }
+    V[14] = 0x46;
+    self->cycles += 2;
+    if (V[11] == V[1]) {
+        goto L208;
+    }
+    goto L206;
+L206:
+    if (self->cycles + 1 > end) { self->PC = 0x206; return; }
+    if (!Chip8Aot_helper(self, 0x206)) { return; }
+    goto L208;
+L208:
+    if (self->cycles + 2 > end) { self->PC = 0x208; return; }
+    V[14] += 0x00;
+    self->cycles += 1;
+    if (!Chip8Aot_helper(self, 0x20A)) { return; }
+    goto L20C;
+L20C:
+    if (self->cycles + 3 > end) { self->PC = 0x20C; return; }
+    V[7] = 0xC4;
+    V[4] = 0x10;
+    self->cycles += 3;
+    goto L2BE;
+L280:
+    if (self->cycles + 2 > end) { self->PC = 0x280; return; }
+    V[0] = 0x00;
+    self->cycles += 2;
+    self->PC = 0x240 + V[0];
+    goto dispatch;
+L298:
+    if (self->cycles + 3 > end) { self->PC = 0x298; return; }
+    V[3] += 0xCA;
+    V[0] = 0x00;
+    self->cycles += 3;
+    if (V[6] != V[3]) {
+        goto L2A0;
+    }
+    goto L29E;
+L29E:
+    if (self->cycles + 1 > end) { self->PC = 0x29E; return; }
+    self->I += V[1];
+    self->cycles += 1;
+    goto L2A0;
+L2A0:
+    if (self->cycles + 1 > end) { self->PC = 0x2A0; return; }
+    self->cycles += 1;
+    if (V[2] != 0x00) {
+        goto L2A4;
+    }
+    goto L2A2;
+L2A2:
+    if (self->cycles + 1 > end) { self->PC = 0x2A2; return; }
+    if (!Chip8Aot_helper(self, 0x2A2)) { return; }
+    goto L2A4;
+L2A4:
+    if (self->cycles + 1 > end) { self->PC = 0x2A4; return; }
+    self->cycles += 1;
+    if ((self->keys >> (V[3] & 0xF) & 1)) {
+        goto L2A8;
+    }
+    goto L2A6;
+L2A6:
+    if (self->cycles + 1 > end) { self->PC = 0x2A6; return; }
+    self->cycles += 1;
+    if (!(self->keys >> (V[8] & 0xF) & 1)) {
+        goto L2AA;
+    }
+    goto L2A8;
+L2A8:
+    if (self->cycles + 1 > end) { self->PC = 0x2A8; return; }
+    self->cycles += 1;
+    if (V[13] == V[14]) {
+        goto L2AC;
+    }
+    goto L2AA;
+L2AA:
+    if (self->cycles + 1 > end) { self->PC = 0x2AA; return; }
+    self->cycles += 1;
+    if (V[4] == 0x4C) {
+        goto L2AE;
+    }
+    goto L2AC;
+L2AC:
+    if (self->cycles + 1 > end) { self->PC = 0x2AC; return; }
+    self->cycles += 1;
+    goto L32E;
+L2AE:
+    if (self->cycles + 3 > end) { self->PC = 0x2AE; return; }
+    V[12] = 0x62;
+    V[12] += 0x98;
+    self->cycles += 3;
+    if (!(self->keys >> (V[0] & 0xF) & 1)) {
+        goto L2B6;
+    }
+    goto L2B4;
+L2B4:
+    if (self->cycles + 1 > end) { self->PC = 0x2B4; return; }
+    self->cycles += 1;
+    if (V[10] != V[4]) {
+        goto L2B8;
+    }
+    goto L2B6;
+L2B6:
+    if (self->cycles + 1 > end) { self->PC = 0x2B6; return; }
+    self->D = V[11];
+    self->cycles += 1;
+    goto L2B8;
+L2B8:
+    if (self->cycles + 2 > end) { self->PC = 0x2B8; return; }
+    V[0] = 0x00;
+    self->cycles += 2;
+    if (V[4] != 0x01) {
+        goto L2BE;
+    }
+    goto L2BC;
+L2BC:
+    if (self->cycles + 1 > end) { self->PC = 0x2BC; return; }
+    V[10] = 0x58;
+    self->cycles += 1;
+    goto L2BE;
+L2BE:
+    if (self->cycles + 1 > end) { self->PC = 0x2BE; return; }
+    if (self->SC >= 15) { self->PC = 0x2BE; return; }
+    self->stack[++self->SC] = 0x2BE;
+    self->cycles += 1;
+    goto L2F0;
+L2C0:
+    if (self->cycles + 3 > end) { self->PC = 0x2C0; return; }
+    self->I = 0x22C;
+    V[14] = 0x47;
+    self->cycles += 3;
+    goto L33C;
+L2F0:
+    if (self->cycles + 1 > end) { self->PC = 0x2F0; return; }
+    if (!Chip8Aot_helper(self, 0x2F0)) { return; }
+    goto L2F2;
+L2F2:
+    if (self->cycles + 1 > end) { self->PC = 0x2F2; return; }
+    self->cycles += 1;
+    if (V[0] != V[4]) {
+        goto L2F6;
+    }
+    goto L2F4;
+L2F4:
+    if (self->cycles + 1 > end) { self->PC = 0x2F4; return; }
+    self->cycles += 1;
+    if (V[14] == 0xFA) {
+        goto L2F8;
+    }
+    goto L2F6;
+L2F6:
+    if (self->cycles + 1 > end) { self->PC = 0x2F6; return; }
+    V[13] += 0x24;
+    self->cycles += 1;
+    goto L2F8;
+L2F8:
+    if (self->cycles + 1 > end) { self->PC = 0x2F8; return; }
+    if (!Chip8Aot_helper(self, 0x2F8)) { return; }
+    goto L2FA;
+L2FA:
+    if (self->cycles + 1 > end) { self->PC = 0x2FA; return; }
+    self->cycles += 1;
+    if (V[5] != 0x01) {
+        goto L2FE;
+    }
+    goto L2FC;
+L2FC:
+    if (self->cycles + 1 > end) { self->PC = 0x2FC; return; }
+    V[10] += 0x61;
+    self->cycles += 1;
+    goto L2FE;
+L2FE:
+    if (self->cycles + 1 > end) { self->PC = 0x2FE; return; }
+    if (!Chip8Aot_helper(self, 0x2FE)) { return; }
+    goto L300;
+L300:
+    if (self->cycles + 1 > end) { self->PC = 0x300; return; }
+    self->cycles += 1;
+    if (V[3] == V[11]) {
+        goto L304;
+    }
+    goto L302;
+L302:
+    if (self->cycles + 1 > end) { self->PC = 0x302; return; }
+    V[6] += 0xAC;
+    self->cycles += 1;
+    goto L304;
+L304:
+    if (self->cycles + 1 > end) { self->PC = 0x304; return; }
+    if (!Chip8Aot_helper(self, 0x304)) { return; }
+    goto L306;
+L306:
+    if (self->cycles + 3 > end) { self->PC = 0x306; return; }
+    V[9] += 0xA5;
+    self->I = 0x23F;
+    self->cycles += 3;
+    if (V[9] != 0x01) {
+        goto L30E;
+    }
+    goto L30C;
+L30C:
+    if (self->cycles + 1 > end) { self->PC = 0x30C; return; }
+    self->cycles += 1;
+    self->PC = 0x298;
+    if (Chip8_skipIdle(self, end - self->cycles)) {
+        self->cycles = end;
+        return;
+    }
+    goto L298;
+L30E:
+    if (self->cycles + 1 > end) { self->PC = 0x30E; return; }
+    self->cycles += 1;
+    if (V[12] != V[1]) {
+        goto L312;
+    }
+    goto L310;
+L310:
+    if (self->cycles + 1 > end) { self->PC = 0x310; return; }
+    V[5] += 0x09;
+    self->cycles += 1;
+    goto L312;
+L312:
+    if (self->cycles + 2 > end) { self->PC = 0x312; return; }
+    V[3] += 0x04;
+    self->cycles += 2;
+    if ((self->keys >> (V[2] & 0xF) & 1)) {
+        goto L318;
+    }
+    goto L316;
+L316:
+    if (self->cycles + 1 > end) { self->PC = 0x316; return; }
+    if (!Chip8Aot_helper(self, 0x316)) { return; }
+    goto L318;
+L318:
+    if (self->cycles + 3 > end) { self->PC = 0x318; return; }
+    V[0] += 0x8F;
+    self->I = 0x252;
+    self->cycles += 3;
+    if (V[3] == 0x68) {
+        goto L320;
+    }
+    goto L31E;
+L31E:
+    if (self->cycles + 1 > end) { self->PC = 0x31E; return; }
+    V[8] += 0x00;
+    self->cycles += 1;
+    goto L320;
+L320:
+    if (self->cycles + 1 > end) { self->PC = 0x320; return; }
+    self->cycles += 1;
+    if (V[5] == V[8]) {
+        goto L324;
+    }
+    goto L322;
+L322:
+    if (self->cycles + 1 > end) { self->PC = 0x322; return; }
+    V[8] += 0xB3;
+    self->cycles += 1;
+    goto L324;
+L324:
+    if (self->cycles + 1 > end) { self->PC = 0x324; return; }
+    self->cycles += 1;
+    self->PC = 0x260 + V[0];
+    goto dispatch;
+L32E:
+    if (self->cycles + 3 > end) { self->PC = 0x32E; return; }
+    V[9] += 0x0C;
+    V[4] += 0x00;
+    self->cycles += 2;
+    if (self->SC >= 15) { self->PC = 0x332; return; }
+    self->stack[++self->SC] = 0x332;
+    self->cycles += 1;
+    goto L280;
+L334:
+    if (self->cycles + 1 > end) { self->PC = 0x334; return; }
+    if (!Chip8Aot_helper(self, 0x334)) { return; }
+    goto L336;
+L336:
+    if (self->cycles + 1 > end) { self->PC = 0x336; return; }
+    if (!Chip8Aot_helper(self, 0x336)) { return; }
+    goto L338;
+L338:
+    if (self->cycles + 1 > end) { self->PC = 0x338; return; }
+    self->cycles += 1;
+    if (V[9] != 0x00) {
+        goto L33C;
+    }
+    goto L33A;
+L33A:
+    if (self->cycles + 1 > end) { self->PC = 0x33A; return; }
+    V[0] += 0x51;
+    self->cycles += 1;
+    goto L33C;
+L33C:
+    if (self->cycles + 1 > end) { self->PC = 0x33C; return; }
+    self->cycles += 1;
+    if (V[3] == 0x15) {
+        self->PC = 0x340;
+        return;
+    }
+    goto L33E;
+L33E:
+    if (self->cycles + 1 > end) { self->PC = 0x33E; return; }
+    if (!Chip8Aot_helper(self, 0x33E)) { return; }
+    self->PC = 0x340;
+    return;
+}
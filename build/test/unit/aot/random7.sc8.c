@@ -0,0 +1,128 @@
+/* Generated by AotCompile from "random7" (SUPER-CHIP, 4 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[352] = {
+    0xFC, 0x30, 0xDD, 0x01, 0x00, 0xFE, 0x68, 0x9D, 0x00, 0xEE, 0x00, 0xFE,
+    0xF4, 0x1E, 0x12, 0x86, 0x74, 0x65, 0x74, 0xBF, 0x60, 0x00, 0x6E, 0x35,
+    0xB2, 0x80, 0xC7, 0xCF, 0x00, 0xFB, 0xE4, 0x9E, 0x12, 0x2A, 0xA2, 0xD6,
+    0x60, 0x00, 0x74, 0x00, 0x12, 0x9E, 0x7D, 0x26, 0xA2, 0xF5, 0xE3, 0x9E,
+    0x63, 0xB1, 0xFF, 0x0A, 0x86, 0x1E, 0xB2, 0xA0, 0xE6, 0xA1, 0x00, 0xFC,
+    0x51, 0x70, 0x76, 0x88, 0x79, 0x59, 0x31, 0x7F, 0x12, 0x68, 0x77, 0xD2,
+    0x6F, 0x11, 0x63, 0xEB, 0x86, 0xF7, 0xDA, 0xCA, 0x6C, 0x1A, 0x7E, 0xE1,
+    0x5B, 0x00, 0x77, 0xE5, 0xB2, 0x10, 0x80, 0xA3, 0x58, 0x60, 0xB2, 0x60,
+    0xA3, 0x25, 0xB3, 0x10, 0x81, 0xA5, 0x4F, 0x00, 0x7B, 0x00, 0x7D, 0x00,
+    0x71, 0xD3, 0x9C, 0x50, 0x72, 0xC7, 0x7B, 0x00, 0xCC, 0xB3, 0x34, 0xD8,
+    0x60, 0x00, 0x7E, 0x34, 0x39, 0xE6, 0xB2, 0x30, 0x13, 0x40, 0xDD, 0x9A,
+    0x7A, 0xC7, 0xE6, 0xA1, 0x83, 0x85, 0x70, 0x36, 0x74, 0xA2, 0x87, 0x92,
+    0x8E, 0x15, 0x5A, 0x90, 0xC0, 0x8C, 0x60, 0x00, 0x70, 0x83, 0x77, 0x9A,
+    0x53, 0xC0, 0x53, 0xE0, 0x6D, 0x3A, 0x12, 0x4C, 0x73, 0xF7, 0xCF, 0x2D,
+    0x72, 0x14, 0x82, 0x14, 0xCA, 0xE8, 0xDA, 0x31, 0x3F, 0x0D, 0xD5, 0x98,
+    0x81, 0x95, 0x5A, 0x10, 0x00, 0xFF, 0x77, 0xB9, 0xB2, 0xA0, 0xE5, 0x9E,
+    0x3F, 0xE8, 0x32, 0x3F, 0x63, 0x02, 0x62, 0x45, 0xA3, 0x4D, 0xA2, 0x60,
+    0x4C, 0x00, 0x63, 0xCF, 0xF1, 0x55, 0x8E, 0xD5, 0xED, 0xA1, 0x93, 0xE0,
+    0x7F, 0xD6, 0x7E, 0x99, 0xF2, 0x55, 0x12, 0x24, 0xDC, 0xFB, 0x5C, 0x50,
+    0x00, 0xFC, 0x50, 0x30, 0x77, 0x88, 0xDD, 0xD7, 0x88, 0xA2, 0x12, 0x2E,
+    0x79, 0x00, 0x7C, 0x92, 0x3C, 0x54, 0x7B, 0xC2, 0x4B, 0x03, 0x00, 0xEE,
+    0x73, 0xF7, 0x79, 0x69, 0x72, 0x7B, 0x59, 0x90, 0x71, 0x61, 0x62, 0x07,
+    0x22, 0x00, 0x77, 0xBA, 0xA2, 0xCA, 0x12, 0xD0, 0x79, 0x41, 0x7D, 0xAE,
+    0x72, 0x00, 0xE7, 0x9E, 0xEC, 0x9E, 0xC6, 0x46, 0x81, 0xD3, 0x59, 0xA0,
+    0xDA, 0x72, 0x5E, 0x70, 0x00, 0xE0, 0x7F, 0x84, 0x3C, 0xEA, 0x7F, 0x50,
+    0x34, 0x93, 0x90, 0x10, 0xA2, 0xED, 0x8E, 0x2E, 0x12, 0xA8, 0x30, 0x0C,
+    0x72, 0x2C, 0xD9, 0x91, 0x85, 0x42, 0x13, 0x02, 0x00, 0xE0, 0xEB, 0x9E,
+    0xC3, 0xE2, 0x76, 0x00, 0x77, 0x00, 0x22, 0x90, 0xC9, 0x56, 0x71, 0x86,
+    0x7A, 0x28, 0x3B, 0xFC, 0x6C, 0xE7, 0x60, 0x00, 0x7B, 0x0A, 0x96, 0xD0,
+    0x7C, 0x14, 0x3C, 0xA1,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random7",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = true,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x202: goto L202;
+        case 0x204: goto L204;
+        case 0x206: goto L206;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    if (!Chip8Aot_helper(self, 0x200)) { return; }
+    goto L202;
+L202:
+    if (self->cycles + 1 > end) { self->PC = 0x202; return; }
+    if (!Chip8Aot_helper(self, 0x202)) { return; }
+    goto L204;
+L204:
+    if (self->cycles + 1 > end) { self->PC = 0x204; return; }
+    if (!Chip8Aot_helper(self, 0x204)) { return; }
+    goto L206;
+L206:
+    if (self->cycles + 2 > end) { self->PC = 0x206; return; }
+    V[8] = 0x9D;
+    self->cycles += 1;
+    if (self->SC < 0) { self->PC = 0x208; return; }
+    self->PC = self->stack[self->SC--] + 2;
+    self->cycles += 1;
+    goto dispatch;
+}
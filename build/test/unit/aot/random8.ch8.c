@@ -0,0 +1,153 @@
+/* Generated by AotCompile from "random8" (CHIP-8, 7 blocks); do not edit */
+#include "Chip8Aot.h"
+
+static void run(Chip8Proc *self, uint64_t end);
+
+static const uint8_t program[384] = {
+    0x00, 0xC2, 0xDF, 0xD1, 0xE3, 0x9E, 0x6D, 0xC7, 0x77, 0x01, 0x88, 0xD2,
+    0xE7, 0x9E, 0x82, 0xA5, 0x63, 0x1E, 0xB3, 0x50, 0x5B, 0xB0, 0x13, 0x34,
+    0x92, 0x40, 0x12, 0x72, 0xF7, 0x65, 0xD7, 0x5C, 0x71, 0x1A, 0x97, 0x90,
+    0x3A, 0xE8, 0xB3, 0x60, 0xE2, 0xA1, 0x92, 0xC0, 0xE2, 0x9E, 0x75, 0x00,
+    0x74, 0x08, 0x7A, 0xB7, 0x84, 0x40, 0x41, 0x03, 0x66, 0x92, 0x60, 0x00,
+    0x3D, 0xA0, 0x7C, 0x91, 0x99, 0x40, 0x7E, 0xAF, 0x93, 0x20, 0x60, 0x00,
+    0x00, 0xE0, 0xD2, 0x1E, 0x12, 0x18, 0x7D, 0x3D, 0xF1, 0x0A, 0x78, 0x8F,
+    0x38, 0xA5, 0x00, 0xC2, 0x95, 0x00, 0x75, 0x89, 0x95, 0xB0, 0x7B, 0x11,
+    0xB2, 0xF0, 0x60, 0x00, 0x12, 0x72, 0x6D, 0x3D, 0x74, 0x00, 0x12, 0x38,
+    0x43, 0x03, 0x57, 0x40, 0x7B, 0x51, 0x12, 0x9E, 0xD0, 0xCF, 0xE1, 0x9E,
+    0x70, 0x95, 0x00, 0xE0, 0x12, 0xBC, 0x7B, 0x78, 0x7E, 0x3C, 0xB3, 0x70,
+    0x13, 0x28, 0x75, 0x3D, 0xFB, 0x65, 0xA3, 0x59, 0x73, 0x67, 0xA2, 0x82,
+    0x00, 0xFE, 0x75, 0xA9, 0x5A, 0x00, 0x4B, 0x01, 0x8C, 0x0E, 0xB2, 0xC0,
+    0xF7, 0x0A, 0x00, 0xFF, 0x9C, 0xB0, 0x71, 0xA1, 0x9E, 0x40, 0x70, 0x3C,
+    0xA2, 0x68, 0x75, 0x00, 0x86, 0x40, 0xDE, 0xDC, 0x34, 0xA3, 0x00, 0xFF,
+    0x79, 0xA8, 0xC7, 0x30, 0x60, 0x00, 0x12, 0xC2, 0xE4, 0x9E, 0x22, 0x30,
+    0x66, 0xAE, 0x9E, 0x60, 0x64, 0xA6, 0x3A, 0x7E, 0x70, 0x97, 0x7B, 0x00,
+    0x4A, 0x01, 0xB3, 0x50, 0x9E, 0x00, 0xA2, 0x3E, 0x74, 0xCB, 0x74, 0x4F,
+    0x71, 0x57, 0x70, 0xC8, 0xB3, 0x00, 0x3A, 0x54, 0x8C, 0xEE, 0xD1, 0x41,
+    0xCA, 0x72, 0x90, 0x90, 0xC2, 0x3F, 0x7C, 0xBE, 0x5B, 0xF0, 0x78, 0x00,
+    0xF5, 0x15, 0x7B, 0xE2, 0x7D, 0x3E, 0x73, 0x24, 0x73, 0x1C, 0xDF, 0xB9,
+    0x7C, 0x6E, 0x73, 0x51, 0xB2, 0x40, 0x97, 0x70, 0x6E, 0xE8, 0x00, 0xEE,
+    0xEF, 0x9E, 0x50, 0x20, 0xF7, 0x15, 0x6C, 0xA2, 0xC8, 0x90, 0x67, 0x28,
+    0x00, 0xE0, 0x68, 0x35, 0x54, 0xE0, 0x87, 0x87, 0xB2, 0xE0, 0x90, 0x10,
+    0x00, 0xE0, 0xE7, 0xA1, 0xC9, 0xC1, 0x9D, 0x50, 0x76, 0x00, 0x82, 0x82,
+    0x12, 0x46, 0x9F, 0xF0, 0xB2, 0xF0, 0x00, 0xEE, 0x58, 0xF0, 0x12, 0x8C,
+    0x7D, 0xD4, 0x98, 0x70, 0x76, 0x15, 0x60, 0x00, 0x7A, 0x5E, 0x60, 0x00,
+    0x3F, 0xBD, 0x6C, 0x0E, 0x49, 0x00, 0x3D, 0xE8, 0x50, 0xF0, 0x7C, 0x4F,
+    0xFC, 0x15, 0xD2, 0x07, 0x76, 0x82, 0x00, 0xFE, 0x7E, 0x87, 0x80, 0x11,
+    0x68, 0xB5, 0xDE, 0xED, 0x53, 0x70, 0x00, 0xFC, 0x82, 0x12, 0x5E, 0x60,
+    0xA2, 0xFA, 0x82, 0x33, 0xB3, 0x60, 0xF1, 0x75, 0x45, 0x00, 0xF7, 0x29,
+    0xCF, 0xBF, 0x00, 0xC2, 0x71, 0x00, 0x12, 0x2C, 0x56, 0xA0, 0xE1, 0x9E,
+};
+
+static const uint8_t covered[512] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static Chip8AotModule module = {
+    .name = "random8",
+    .program = program,
+    .size = sizeof(program),
+    .superMode = false,
+    .covered = covered,
+    .run = run
+};
+
+__attribute__((constructor)) static void registerModule(void) {
+    Chip8Aot_register(&module);
+}
+
+static void run(Chip8Proc *self, uint64_t end) {
+    uint8_t *V = self->V;
+dispatch:
+    switch (self->PC) {
+        case 0x200: goto L200;
+        case 0x202: goto L202;
+        case 0x204: goto L204;
+        case 0x206: goto L206;
+        case 0x208: goto L208;
+        case 0x20E: goto L20E;
+        case 0x210: goto L210;
+        default: return;
+    }
+L200:
+    if (self->cycles + 1 > end) { self->PC = 0x200; return; }
+    if (!Chip8Aot_helper(self, 0x200)) { return; }
+    goto L202;
+L202:
+    if (self->cycles + 1 > end) { self->PC = 0x202; return; }
+    if (!Chip8Aot_helper(self, 0x202)) { return; }
+    goto L204;
+L204:
+    if (self->cycles + 1 > end) { self->PC = 0x204; return; }
+    self->cycles += 1;
+    if ((self->keys >> (V[3] & 0xF) & 1)) {
+        goto L208;
+    }
+    goto L206;
+L206:
+    if (self->cycles + 1 > end) { self->PC = 0x206; return; }
+    V[13] = 0xC7;
+    self->cycles += 1;
+    goto L208;
+L208:
+    if (self->cycles + 3 > end) { self->PC = 0x208; return; }
+    V[7] += 0x01;
+    V[8] &= V[13];
+    self->cycles += 3;
+    if ((self->keys >> (V[7] & 0xF) & 1)) {
+        goto L210;
+    }
+    goto L20E;
+L20E:
+    if (self->cycles + 1 > end) { self->PC = 0x20E; return; }
+    { int old = V[2]; V[2] -= V[10]; V[15] = old >= V[2]; }
+    self->cycles += 1;
+    goto L210;
+L210:
+    if (self->cycles + 2 > end) { self->PC = 0x210; return; }
+    V[3] = 0x1E;
+    self->cycles += 2;
+    self->PC = 0x350 + V[0];
+    goto dispatch;
+}
@@ -0,0 +1,283 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Chip8Core.h"
+#include "Chip8Jit.h"
+#include "Chip8Lockstep.h"
+#include "Chip8RandomProgram.h"
+#include "Chip8Rom.h"
+#include "Chip8State.h"
+
+/*
+ * Fuzz target for the core. Each input is a flags byte, a byte giving the
+ * instructions per frame (plus one), then the program. The program runs
+ * for up to FUZZ_FRAMES frames, pressing a key whenever it waits for one.
+ *
+ * Built with LIBFUZZER defined, this is a libFuzzer target; otherwise main
+ * replays the inputs named on the command line, or runs random programs.
+ *
+ * A run costs a reset plus whatever the input executes. Built with -O2
+ * and no sanitizers, inputs that stop at once (as most mutated ones do)
+ * manage about 240k runs a second per core; main's random programs run
+ * about 1200 instructions each, or 60k runs a second on the interpreters.
+ * Inputs taking the JIT pay for translating each block, and lockstep
+ * inputs run up to CHIP8_LANES lanes and their references.
+ */
+
+#define FUZZ_HEADER_SIZE 2
+#define FUZZ_FRAMES 16
+// Flags byte
+#define FUZZ_SUPER 0x01         // Start in SUPER-CHIP mode
+#define FUZZ_JIT 0x02           // Run translated code
+#define FUZZ_DIFFERENTIAL 0x04  // Check every frame against Chip8_advance
+#define FUZZ_LOCKSTEP 0x08      // Run a lockstep group of as many lanes as
+                                // the high nibble plus one, checking each
+                                // lane against Chip8_advance
+#define FUZZ_REWIND 0x10        // Without FUZZ_LOCKSTEP: record every frame
+                                // for rewinding, and run every fourth one
+                                // twice, rewinding after the first time
+// Bytes of history kept by FUZZ_REWIND, and frames between its keyframes
+#define FUZZ_REWIND_BUDGET (64 * 1024)
+#define FUZZ_REWIND_KEY_INTERVAL 4
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+static void Fuzz_setup(void);
+static bool Fuzz_frame(Chip8Proc *proc, unsigned frame, unsigned ipf);
+static void Fuzz_compare(const Chip8Proc *proc, const Chip8Proc *reference,
+        unsigned frame);
+static void Fuzz_lockstep(const Chip8Proc *template, const uint8_t *program,
+        size_t length, unsigned ipf, int count);
+
+// Processors from Chip8_init, in CHIP-8 and SUPER-CHIP mode, that every
+// run is reset to
+static Chip8Proc templates[2];
+// The processor under test, with and without the JIT, and the reference
+static Chip8Proc threaded, translated, reference;
+// The lanes of a lockstep group, and each lane run on its own
+static Chip8Proc lanes[CHIP8_LANES], laneReferences[CHIP8_LANES];
+// History of the processor under test for FUZZ_REWIND. Every frame popped
+// was pushed by the same run, so it is never cleared between runs.
+static Chip8Rewind history;
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool ready;
+    if (!ready) {
+        Fuzz_setup();
+        ready = true;
+    }
+    if (size < FUZZ_HEADER_SIZE) {
+        return 0;
+    }
+    uint8_t flags = data[0];
+    unsigned ipf = data[1] + 1;
+    const uint8_t *program = data + FUZZ_HEADER_SIZE;
+    size_t length = size - FUZZ_HEADER_SIZE;
+    if (length > CHIP8_MAX_ROM_SIZE) {
+        length = CHIP8_MAX_ROM_SIZE;
+    }
+    const Chip8Proc *template = &templates[flags & FUZZ_SUPER ? 1 : 0];
+    if (flags & FUZZ_LOCKSTEP) {
+        int count = (flags >> 4) + 1;
+        Fuzz_lockstep(template, program, length, ipf,
+                count < CHIP8_LANES ? count : CHIP8_LANES);
+        return 0;
+    }
+    Chip8Proc *proc = flags & FUZZ_JIT ? &translated : &threaded;
+    bool differential = flags & FUZZ_DIFFERENTIAL;
+    bool rewind = flags & FUZZ_REWIND;
+    Chip8_reset(proc, template, program, length);
+    if (differential) {
+        Chip8_reset(&reference, template, program, length);
+        reference.referenceMode = true;
+    }
+
+    for (unsigned frame = 0; frame < FUZZ_FRAMES; ++frame) {
+        if (rewind) {
+            Chip8Rewind_push(&history, proc);
+            if (frame % 4 == 3) {
+                // The frame must run the same from the restored state
+                Fuzz_frame(proc, frame, ipf);
+                Chip8Rewind_pop(&history, proc);
+                Chip8Rewind_push(&history, proc);
+            }
+        }
+        bool running = Fuzz_frame(proc, frame, ipf);
+        if (differential) {
+            Fuzz_frame(&reference, frame, ipf);
+            Fuzz_compare(proc, &reference, frame);
+        }
+        if (!running) {
+            break;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Create the templates and the processors once, so that each run only
+ * resets them
+ */
+static void Fuzz_setup(void) {
+    static const uint8_t empty[1];
+    for (int super = 0; super < 2; ++super) {
+        Chip8_initAt(&templates[super], empty, 0, NULL, NULL, super);
+    }
+    threaded = templates[0];
+    translated = templates[0];
+    reference = templates[0];
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        lanes[lane] = templates[0];
+        laneReferences[lane] = templates[0];
+    }
+    Chip8Rewind_init(&history, FUZZ_REWIND_BUDGET, FUZZ_REWIND_KEY_INTERVAL);
+    // Without a JIT on this host, FUZZ_JIT inputs run threaded code
+    Chip8Jit_enable(&translated);
+}
+
+/*
+ * Run one frame: a key press if the processor waits for one, ipf
+ * instructions and a timer tick. Returns false once it has trapped.
+ */
+static bool Fuzz_frame(Chip8Proc *proc, unsigned frame, unsigned ipf) {
+    if (proc->waitKey >= 0) {
+        Chip8_keyEvent(proc, frame & 0xF, true);
+    }
+    bool running = Chip8_execute(proc, ipf);
+    Chip8_tick(proc);
+    return running;
+}
+
+/*
+ * Abort, for the fuzzer to report the input, if proc and reference differ
+ * in anything a program can observe (idleCycles is bookkeeping only)
+ */
+static void Fuzz_compare(const Chip8Proc *proc, const Chip8Proc *reference,
+        unsigned frame) {
+#define FIELD(name) { #name, offsetof(Chip8Proc, name), \
+        sizeof(((Chip8Proc *) NULL)->name) },
+    static const struct { const char *name; size_t offset, size; } fields[] = {
+        CHIP8_OBSERVABLE_FIELDS(FIELD)
+    };
+#undef FIELD
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); ++f) {
+        const uint8_t *a = (const uint8_t *) proc + fields[f].offset,
+                      *b = (const uint8_t *) reference + fields[f].offset;
+        if (memcmp(a, b, fields[f].size) != 0) {
+            fprintf(stderr, "%s differs from the reference after frame %u "
+                    "(PC %03X, reference PC %03X)\n", fields[f].name, frame,
+                    proc->PC, reference->PC);
+            abort();
+        }
+    }
+}
+
+/*
+ * Run count lanes of program as one lockstep group, and check every lane
+ * after each frame against the same processor run on its own through
+ * Chip8_advance. Each lane is seeded and holds a key of its own, so Cxnn
+ * and Ex9E/ExA1 split the group. No key is pressed while running, as a
+ * lane waiting for one leaves the group for good.
+ */
+static void Fuzz_lockstep(const Chip8Proc *template, const uint8_t *program,
+        size_t length, unsigned ipf, int count) {
+    Chip8Proc *procs[CHIP8_LANES];
+    for (int lane = 0; lane < count; ++lane) {
+        Chip8Proc *pair[] = { &lanes[lane], &laneReferences[lane] };
+        for (int p = 0; p < 2; ++p) {
+            Chip8_reset(pair[p], template, program, length);
+            Chip8_seed(pair[p], lane);
+            Chip8_keyEvent(pair[p], lane & 0xF, true);
+        }
+        laneReferences[lane].referenceMode = true;
+        procs[lane] = &lanes[lane];
+    }
+    static Chip8Lockstep group;
+    Chip8Lockstep_init(&group, procs, count);
+
+    for (unsigned frame = 0; frame < FUZZ_FRAMES; ++frame) {
+        bool running = Chip8Lockstep_execute(&group, ipf);
+        Chip8Lockstep_sync(&group);
+        for (int lane = 0; lane < count; ++lane) {
+            Chip8_execute(&laneReferences[lane], ipf);
+            Chip8_tick(&lanes[lane]);
+            Chip8_tick(&laneReferences[lane]);
+            Fuzz_compare(&lanes[lane], &laneReferences[lane], frame);
+        }
+        if (!running) {
+            break;
+        }
+    }
+}
+
+#ifndef LIBFUZZER
+
+// Random inputs run when no files are given, and their largest program
+#define DEFAULT_RUNS 1000000
+#define RANDOM_PROGRAM_SIZE 256
+
+static int Fuzz_replay(const char *path);
+static size_t Fuzz_generate(uint8_t *input, uint32_t *state);
+
+int main(int argc, char **argv) {
+    // fuzz <input>...   replay inputs, such as crashes libFuzzer saved
+    // fuzz [runs]       run random programs and report the rate
+    if (argc > 1 && (argv[1][0] < '0' || argv[1][0] > '9')) {
+        int status = EXIT_SUCCESS;
+        for (int a = 1; a < argc; ++a) {
+            if (Fuzz_replay(argv[a]) != 0) {
+                status = EXIT_FAILURE;
+            }
+        }
+        return status;
+    }
+    unsigned long runs = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_RUNS;
+    uint8_t input[FUZZ_HEADER_SIZE + RANDOM_PROGRAM_SIZE];
+    uint32_t state = 1;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long r = 0; r < runs; ++r) {
+        LLVMFuzzerTestOneInput(input, Fuzz_generate(input, &state));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec)
+        + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%lu runs in %.3fs (%.0f per second)\n", runs, seconds,
+            seconds > 0 ? runs / seconds : 0);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Run the input saved in the file at path
+ */
+static int Fuzz_replay(const char *path) {
+    static uint8_t input[FUZZ_HEADER_SIZE + CHIP8_MAX_ROM_SIZE];
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    size_t size = fread(input, 1, sizeof(input), file);
+    fclose(file);
+    LLVMFuzzerTestOneInput(input, size);
+    printf("%s: ok\n", path);
+    return 0;
+}
+
+/*
+ * Fill input with random flags, frame length and program (see
+ * Chip8RandomProgram), mostly of valid instructions so that runs get past
+ * the first few. Returns its size.
+ */
+static size_t Fuzz_generate(uint8_t *input, uint32_t *state) {
+    input[0] = Chip8RandomProgram_next(state);
+    input[1] = Chip8RandomProgram_next(state);
+    size_t size = 2 * (1 + Chip8RandomProgram_next(state)
+            % (RANDOM_PROGRAM_SIZE / 2));
+    Chip8RandomProgram_fill(input + FUZZ_HEADER_SIZE, size, state);
+    return FUZZ_HEADER_SIZE + size;
+}
+
+#endif
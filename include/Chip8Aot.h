@@ -0,0 +1,76 @@
+#ifndef CHIP_8_AOT_H
+#define CHIP_8_AOT_H
+
+#include "Chip8Core.h"
+
+/*
+ * A ROM translated to C ahead of time by the AotCompile tool and linked
+ * into the program. Each generated module registers itself before main,
+ * and Chip8Aot_attach hands it to processors loaded with its ROM.
+ *
+ * The translator follows the ROM's control flow from 0x200 through jumps,
+ * calls, returns and skips, and compiles every basic block it reaches.
+ * Anything it could not see ahead of time runs on Chip8_advance: the
+ * target of a Bnnn computed jump, instructions left out of the module
+ * (such as 00FD or invalid ones) and the tail of a budget too short for a
+ * whole block. A write that changes the translated code drops the module
+ * from the processor, which carries on in the interpreter.
+ */
+typedef struct Chip8AotModule {
+    // Name of the ROM it was translated from
+    const char *name;
+    // The program translated, which a processor must be loaded with
+    const uint8_t *program;
+    size_t size;
+    // Quirk setting the code was translated for
+    bool superMode;
+    // Bit a % 8 of covered[a / 8] is set for every ram byte at address a
+    // that translated code was compiled from
+    const uint8_t *covered;
+    // Run translated code from PC until cycles reaches end, an instruction
+    // traps or waits for a key, or PC leaves translated code. Returns with
+    // PC at the next instruction to execute.
+    void (*run)(Chip8Proc *self, uint64_t end);
+    // Next registered module
+    struct Chip8AotModule *next;
+} Chip8AotModule;
+
+/*
+ * Make module available to Chip8Aot_attach; generated modules call this
+ * from a constructor
+ */
+void Chip8Aot_register(Chip8AotModule *module);
+
+/*
+ * Attach the module translated from program, if one is registered for the
+ * processor's quirk setting, so Chip8_execute runs it. self must have
+ * been loaded with program and not run since.
+ * Returns false, attaching nothing, if there is none.
+ */
+bool Chip8Aot_attach(Chip8Proc *self, const uint8_t *program, size_t size);
+
+/*
+ * Advance the processor by up to budget steps in its module's translated
+ * code, falling back to Chip8_advance for anything not translated.
+ * Returns false if the processor has trapped (see Chip8Proc.trap), true
+ * otherwise.
+ */
+bool Chip8Aot_execute(Chip8Proc *self, uint64_t budget);
+
+/*
+ * Drop the processor's module if ram[addr, addr + len) no longer holds
+ * the code it was translated from
+ */
+void Chip8Aot_invalidate(Chip8Proc *self, int addr, int len);
+
+/*
+ * Generated code: execute the instruction at pc with the interpreter.
+ * Returns false if translated code must stop: the instruction trapped or
+ * waits for a key, or it dropped the module.
+ */
+static inline bool Chip8Aot_helper(Chip8Proc *self, uint16_t pc) {
+    self->PC = pc;
+    return Chip8_advance(self) && self->waitKey < 0 && self->aot != NULL;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef CHIP_8_ATOMIC_H
+#define CHIP_8_ATOMIC_H
+
+/*
+ * Atomic members of the structures threads share, spelled so that their
+ * headers also compile as C++ (for the unit tests), which has no _Atomic.
+ * std::atomic of these types has the size and alignment of _Atomic.
+ */
+#ifdef __cplusplus
+extern "C++" {
+#include <atomic>
+}
+#define CHIP8_ATOMIC(type) std::atomic<type>
+#else
+#include <stdatomic.h>
+#define CHIP8_ATOMIC(type) _Atomic type
+#endif
+
+#endif
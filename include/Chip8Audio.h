@@ -0,0 +1,93 @@
+#ifndef CHIP_8_AUDIO_H
+#define CHIP_8_AUDIO_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Chip8Atomic.h"
+
+// Output sample rate unless another is asked for, and the buzzer's pitch
+#define CHIP8_AUDIO_DEFAULT_RATE 48000
+#define CHIP8_AUDIO_TONE_HZ 440
+// Samples the ring holds (a power of two, about a third of a second at
+// the default rate), and samples the audio thread hands a sink at once
+#define CHIP8_AUDIO_RING_SIZE 16384
+#define CHIP8_AUDIO_PERIOD 256
+
+typedef enum Chip8AudioSink {
+    // Discards samples, but takes them at the sample rate in real time
+    // like a sound card would, so underruns show up
+    CHIP8_AUDIO_NULL,
+    // Writes samples to a 16-bit mono WAV file as soon as they are
+    // produced. A paced run keeps every one; a headless run outruns it.
+    CHIP8_AUDIO_WAV,
+    // Writes samples to a WAV file from the emulation thread, inside
+    // Chip8Audio_frame, with no audio thread: slower, but every sample of
+    // a headless run is kept
+    CHIP8_AUDIO_WAV_OFFLINE
+} Chip8AudioSink;
+
+/*
+ * Buzzer output. The emulation thread renders each 60Hz frame into a
+ * lock-free ring as a square wave while S is nonzero and silence
+ * otherwise, so a tone lasts exactly S frames' worth of samples. An audio
+ * thread started by Chip8Audio_open takes the samples out and feeds the
+ * sink.
+ *
+ * The emulation thread never waits: samples that do not fit in the ring
+ * are dropped and counted. A real-time sink that finds the ring short of a
+ * period plays silence in its place and counts an underrun.
+ */
+typedef struct Chip8Audio {
+    // Written by the emulation thread only
+    alignas(64) CHIP8_ATOMIC(uint32_t) head;
+    unsigned rate;
+    // Square wave phase, and its step per sample, in 1/2^32 cycles
+    uint32_t phase, phaseStep;
+    // Sixtieths of a sample carried to the next frame, for rates that are
+    // not a multiple of 60
+    unsigned remainder;
+    // Samples rendered, and those dropped because the ring was full
+    uint64_t produced, dropped;
+
+    // Written by the audio thread only
+    alignas(64) CHIP8_ATOMIC(uint32_t) tail;
+    // Samples handed to the sink, and periods it was short of
+    uint64_t consumed, underruns;
+    Chip8AudioSink sink;
+    int fd;
+    // Set once the WAV file could not be written; errno of the failure
+    bool failed;
+    int error;
+
+    pthread_t thread;
+    CHIP8_ATOMIC(bool) stop;
+    int16_t ring[CHIP8_AUDIO_RING_SIZE];
+} Chip8Audio;
+
+/*
+ * Start output at rate samples per second to sink (path names the WAV
+ * file, NULL for the null sink).
+ * Returns false with errno set if the file or the audio thread cannot be
+ * created.
+ */
+bool Chip8Audio_open(Chip8Audio *self, Chip8AudioSink sink, const char *path,
+        unsigned rate);
+
+/*
+ * Emulation thread: render one 60Hz frame, the tone if sounding is set and
+ * silence otherwise (written out at once for CHIP8_AUDIO_WAV_OFFLINE)
+ */
+void Chip8Audio_frame(Chip8Audio *self, bool sounding);
+
+/*
+ * Stop the audio thread, once a WAV sink has written everything rendered,
+ * and close the sink.
+ * Returns false with errno set if any of a WAV file could not be written.
+ */
+bool Chip8Audio_close(Chip8Audio *self);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CHIP_8_BATCH_H
+#define CHIP_8_BATCH_H
+
+#include "Chip8Core.h"
+#include "Chip8Rom.h"
+
+/*
+ * Why a batch run of one ROM stopped
+ */
+typedef enum Chip8ExitReason {
+    CHIP8_EXIT_HALTED,      // Reached 00FD
+    CHIP8_EXIT_BUDGET,      // Used up the instruction budget
+    CHIP8_EXIT_FAULT,       // Stopped on any other trap
+    CHIP8_EXIT_BLOCKED,     // Waiting for a key (Fx0A) with no input
+    CHIP8_EXIT_LOAD_ERROR   // The ROM is empty or too large (Chip8Rom_valid)
+} Chip8ExitReason;
+
+/*
+ * Settings shared by every ROM in a batch
+ */
+typedef struct Chip8BatchConfig {
+    // Instructions each ROM may execute
+    uint64_t budget;
+    // Instructions per 60Hz timer tick
+    unsigned ipf;
+    // Worker threads (0 to use one per online CPU)
+    unsigned threads;
+    // Seed for every processor's random number generator
+    uint32_t seed;
+    bool superMode;
+    // Run translated code instead of the threaded interpreter
+    bool jit;
+} Chip8BatchConfig;
+
+/*
+ * Outcome of one ROM
+ */
+typedef struct Chip8BatchResult {
+    Chip8ExitReason reason;
+    // Trap the processor stopped on, with the address and opcode raising it
+    Chip8Trap trap;
+    uint16_t trapPC, trapOpcode;
+    // Instructions executed
+    uint64_t cycles;
+    // Chip8_screenHash of the final framebuffer
+    uint64_t screenHash;
+} Chip8BatchResult;
+
+/*
+ * Run each of the count ROMs headlessly, spreading them over a
+ * work-stealing pool of threads, and store the outcome of roms[i] in
+ * results[i]
+ */
+void Chip8Batch_run(const Chip8Rom *roms,
+        size_t count,
+        const Chip8BatchConfig *config,
+        Chip8BatchResult *results);
+
+/*
+ * 64-bit FNV-1a hash of the processor's framebuffer
+ */
+uint64_t Chip8_screenHash(const Chip8Proc *self);
+
+/*
+ * Short name of an exit reason, for reports
+ */
+const char *Chip8_exitReasonName(Chip8ExitReason reason);
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef CHIP_8_BYTES_H
+#define CHIP_8_BYTES_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/*
+ * Byte-level helpers shared by the file formats (traces, captures, ROM
+ * packs, WAV files): little-endian integers, LEB128 varints, whole-buffer
+ * writes and the FNV-1a hash
+ */
+
+static inline void Chip8Bytes_putLE16(uint8_t *out, uint16_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+}
+
+static inline void Chip8Bytes_putLE32(uint8_t *out, uint32_t value) {
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static inline void Chip8Bytes_putLE64(uint8_t *out, uint64_t value) {
+    Chip8Bytes_putLE32(out, value);
+    Chip8Bytes_putLE32(out + 4, value >> 32);
+}
+
+static inline uint16_t Chip8Bytes_getLE16(const uint8_t *in) {
+    return in[0] | in[1] << 8;
+}
+
+static inline uint32_t Chip8Bytes_getLE32(const uint8_t *in) {
+    return in[0] | in[1] << 8 | in[2] << 16 | (uint32_t) in[3] << 24;
+}
+
+static inline uint64_t Chip8Bytes_getLE64(const uint8_t *in) {
+    return Chip8Bytes_getLE32(in)
+        | (uint64_t) Chip8Bytes_getLE32(in + 4) << 32;
+}
+
+/*
+ * Write value as a varint at out (at most 10 bytes).
+ * Returns the byte after it.
+ */
+static inline uint8_t *Chip8Bytes_putVarint(uint8_t *out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = value | 0x80;
+        value >>= 7;
+    }
+    *out++ = value;
+    return out;
+}
+
+/*
+ * Read a varint from data[*offset..size), advancing *offset past it.
+ * Returns false if it runs past the end or is longer than 64 bits.
+ */
+static inline bool Chip8Bytes_getVarint(const uint8_t *data, size_t size,
+        size_t *offset, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*offset == size) {
+            return false;
+        }
+        uint8_t byte = data[(*offset)++];
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Write all size bytes to fd; a single write() unless the file takes it in
+ * parts.
+ * Returns false (with errno set) if a write fails.
+ */
+static inline bool Chip8Bytes_writeAll(int fd, const void *data,
+        size_t size) {
+    const uint8_t *bytes = data;
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+/*
+ * 64-bit FNV-1a hash of size bytes
+ */
+static inline uint64_t Chip8Bytes_hash(const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef CHIP_8_CAPTURE_H
+#define CHIP_8_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CHIP8_CAPTURE_MAGIC "CHIP8CAP"
+#define CHIP8_CAPTURE_VERSION 1
+#define CHIP8_CAPTURE_HEADER_SIZE 16
+
+// Bytes buffered before a write(); at least a few times the largest record
+#define CHIP8_CAPTURE_BUFFER_SIZE (256 * 1024)
+
+/*
+ * Streaming capture of every presented frame, for regression tests.
+ *
+ * The file starts with "CHIP8CAP" and the little-endian 32-bit version and
+ * flags (0). Each frame is then one record:
+ *   varint  instructions retired since the previous frame
+ *   varint  payload size in bytes
+ *   payload the frame XOR the previous one (blank before the first), as
+ *           the 128 words of the framebuffer in order: runs of a zero count
+ *           byte and a literal count byte, each followed by that many
+ *           literal words; words after the last run are zero
+ * A literal word is a mask byte, whose bit b is set if byte b of the word
+ * (least significant first) is not 0, followed by those bytes.
+ * Varints are LEB128. A frame that repeats the previous one has no payload.
+ */
+typedef struct Chip8Capture {
+    int fd;
+    // Framebuffer and cycle count of the last frame recorded, and the
+    // frames recorded so far
+    uint64_t previous[64][2];
+    uint64_t cycles;
+    uint64_t frames;
+    // Set once a write has failed; later frames are dropped
+    bool failed;
+    size_t length;
+    uint8_t buffer[CHIP8_CAPTURE_BUFFER_SIZE];
+} Chip8Capture;
+
+/*
+ * Create the capture file at path and write its header.
+ * Returns false with errno set if it cannot be created.
+ */
+bool Chip8Capture_open(Chip8Capture *self, const char *path);
+
+/*
+ * Record a frame presented after cycles instructions. Rows outside
+ * dirtyRows must not have changed since the previous frame.
+ */
+void Chip8Capture_frame(Chip8Capture *self, uint64_t screen[64][2],
+        uint64_t dirtyRows, uint64_t cycles);
+
+/*
+ * Write out what is buffered and close the file.
+ * Returns false with errno set if any of the capture could not be written.
+ */
+bool Chip8Capture_close(Chip8Capture *self);
+
+/*
+ * Sequential reader over a capture file, mapped whole
+ */
+typedef struct Chip8CaptureReader {
+    const uint8_t *data;
+    size_t size, offset;
+    // Current frame and its cycle count, once Chip8CaptureReader_next has
+    // returned true, and the frames read so far
+    uint64_t screen[64][2];
+    uint64_t cycles;
+    uint64_t frames;
+    // Set if a record is truncated or malformed
+    bool corrupt;
+} Chip8CaptureReader;
+
+/*
+ * Map the capture at path and check its header.
+ * Returns false with errno set if it cannot be read or is not a capture
+ * (EINVAL).
+ */
+bool Chip8CaptureReader_open(Chip8CaptureReader *self, const char *path);
+
+/*
+ * Step to the next frame.
+ * Returns false at the end of the capture, or if it is corrupt.
+ */
+bool Chip8CaptureReader_next(Chip8CaptureReader *self);
+
+void Chip8CaptureReader_close(Chip8CaptureReader *self);
+
+#endif
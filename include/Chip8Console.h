@@ -0,0 +1,17 @@
+#ifndef CHIP_8_CONSOLE_H
+#define CHIP_8_CONSOLE_H
+
+#include <stdio.h>
+
+#include "Chip8Core.h"
+
+/*
+ * Debugger console: read commands from in, one per line, and run proc
+ * under them, writing results to out, until "q" or the end of in. proc
+ * must have a Chip8Debug attached. "c" runs 60Hz frames of ipf
+ * instructions flat out until the processor stops, a minute of them or
+ * Ctrl-C; "h" lists the rest.
+ */
+void Chip8Console_run(Chip8Proc *proc, unsigned ipf, FILE *in, FILE *out);
+
+#endif
@@ -1,15 +1,60 @@
 #ifndef CHIP_8_CORE_H
 #define CHIP_8_CORE_H
 
+#include <stdalign.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+// Seed of every processor's random number generator after Chip8_init
+#define CHIP8_DEFAULT_SEED 1
+// Programs are loaded at 0x200 and must end by 0xFFF
+#define CHIP8_MAX_ROM_SIZE (0x1000 - 0x200)
+// Fx29 points I into the 5-row hex font, which starts here
+#define CHIP8_FONT_5_START 0x000
+
+/*
+ * Predecoded form of the instruction starting at one ram address
+ */
+typedef struct Chip8Decoded {
+    // Handler index, 0 while the address has not been decoded
+    uint8_t op;
+    // Register operands
+    uint8_t x, y;
+    // Low byte of the instruction (n is nn & 0xF, nnn is x << 8 | nn)
+    uint8_t nn;
+} Chip8Decoded;
+
+/*
+ * Why a processor stopped. Every trap leaves the processor intact with PC
+ * at the instruction that raised it.
+ */
+typedef enum Chip8Trap {
+    CHIP8_TRAP_NONE,            // Still running
+    CHIP8_TRAP_EXIT,            // Reached 00FD
+    CHIP8_TRAP_INVALID_OPCODE,  // Unknown or unimplemented instruction
+    CHIP8_TRAP_STACK_OVERFLOW,  // 2nnn with 16 return addresses stacked
+    CHIP8_TRAP_STACK_UNDERFLOW, // 00EE with an empty stack
+    CHIP8_TRAP_ODD_SCROLL,      // 00Cn with odd n in lores mode
+    CHIP8_TRAP_BAD_FONT_CHAR,   // Fx30 with Vx above 9
+    CHIP8_TRAP_BAD_FLAG_REG,    // Fx75/Fx85 with x above 7
+    CHIP8_TRAP_BAD_PC,          // PC ran off the end of ram
+    CHIP8_TRAP_BAD_ADDRESS,     // Dxyn, Fx33, Fx55 or Fx65 past the end of ram
+    CHIP8_TRAP_BREAK            // Stopped by a debugger (see Chip8Debug)
+} Chip8Trap;
+
+/*
+ * A processor. What the interpreters touch on most instructions comes first,
+ * in its first two cache lines; ram, the screen and the predecode cache
+ * each start a line of their own after it, and what is only looked at once
+ * a frame comes last. The whole is aligned to a cache line, so a processor
+ * on the heap needs aligned_alloc (or a Chip8Pool), not malloc.
+ */
 typedef struct Chip8Proc {
 
     /*** Registers ***/
     // 16 general-purpose 8-bit registers
-    uint8_t V[16];
+    alignas(64) uint8_t V[16];
     // 16-bit register primarily for storing addresses
     uint16_t I;
     // Special 8-bit registers for the delay & sound timers
@@ -28,43 +73,243 @@ typedef struct Chip8Proc {
     // Array of 16 16-bit values
     uint16_t stack[16];
 
+    /*** Input ***/
+    // Keys held down (bit k is key k)
+    uint16_t keys;
+    // Register Fx0A stores the next key press in, -1 when not waiting.
+    // Nothing is executed while the processor waits.
+    int8_t waitKey;
+
+    /*** Counters ***/
+    // Number of instructions retired so far, and how many of them idle-loop
+    // detection skipped over (see Chip8_skipIdle)
+    uint64_t cycles, idleCycles;
+    // xorshift32 state of this processor's random number generator (Cxnn),
+    // never 0; see Chip8_seed
+    uint32_t randState;
+    // Rows changed since the last Chip8_present (bit r is row r)
+    uint64_t dirtyRows;
+
+    /*** Mode Flag ***/
+    bool superMode;
+    bool largeScreen;
+    // Make Chip8_execute use the plain switch interpreter (Chip8_advance)
+    bool referenceMode;
+
+    /*** Trap State ***/
+    // Why the processor stopped, CHIP8_TRAP_NONE while it can still run
+    Chip8Trap trap;
+    // Address and opcode of the instruction that raised the trap
+    uint16_t trapPC, trapOpcode;
+
     /*** Memory ***/
-    uint8_t ram[4096];
+    alignas(64) uint8_t ram[4096];
 
     /*** Screen ***/
-    // 128x64 bool array (row-major)
-    bool screen[64 * 128];
+    // 128x64 1-bit framebuffer (row-major), two 64-bit words per row
+    // Column c of a row is bit (63 - c % 64) of word c / 64
+    alignas(64) uint64_t screen[64][2];
+
+    /*** Predecode Cache ***/
+    // One entry per ram address, invalidated when that ram is written
+    alignas(64) Chip8Decoded decoded[4096];
+    // Addresses [decodedLow, decodedHigh) span every entry decoded so far,
+    // for Chip8_reset to clear
+    uint16_t decodedLow, decodedHigh;
+
+    /*** Attachments ***/
+    // Native translation state, NULL unless the JIT is enabled
+    struct Chip8Jit *jit;
+    // Code compiled ahead of time from this processor's program, NULL for
+    // none (see Chip8Aot_attach)
+    const struct Chip8AotModule *aot;
+    // Recording of this run's inputs, NULL for none (see Chip8Trace_open)
+    struct Chip8Trace *trace;
+    // Breakpoints and watchpoints, NULL for none (see Chip8Debug)
+    struct Chip8Debug *debug;
+#ifdef CHIP8_PROFILE
+    // Profile of everything run through Chip8_advance, NULL for none
+    struct Chip8Profile *profile;
+#endif
 
     /*** External Interaction ***/
-    void (*sendScreen)(bool *screen);
+    // Receives the framebuffer once per presented frame, with the rows that
+    // changed since the previous one
+    void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows);
+    // Told when the buzzer starts (Fx18) and stops (S reaching 0)
     void (*setSound)(bool isPlaying, struct Chip8Proc *self);
 
-    /*** Mode Flag ***/
-    bool superMode;
-    bool largeScreen;
-
 } Chip8Proc;
 
+/*
+ * Settings for Chip8_run
+ */
+typedef struct Chip8RunConfig {
+    // Instructions executed per 60Hz frame
+    unsigned ipf;
+    // Don't sleep between frames, run as fast as possible
+    bool headless;
+    // Stop after this many instructions (0 for no limit)
+    uint64_t maxCycles;
+    // Record every frame into this rewind history (NULL for none)
+    struct Chip8Rewind *rewind;
+    // Deliver key events from this queue (NULL for none). Without one, the
+    // run stops if the processor waits for a key (Fx0A).
+    struct Chip8Input *input;
+    // Render the buzzer into this audio output each frame (NULL for none)
+    struct Chip8Audio *audio;
+} Chip8RunConfig;
+
+/*
+ * Results of Chip8_run
+ */
+typedef struct Chip8RunStats {
+    // Instructions executed and 60Hz frames elapsed during the run
+    uint64_t cycles, frames;
+    // Instructions among cycles skipped over as idle loops
+    uint64_t idleCycles;
+    // Wall-clock time of the run and the instructions per second achieved
+    double seconds, ips;
+    // False if the run stopped because the processor trapped (see trap)
+    bool running;
+} Chip8RunStats;
+
 /*
  * Create a new Chip8Proc, copy program into the processor's memory, and
- * store the provided funciton pointers for output use
+ * store the provided funciton pointers for output use.
+ * Only the first CHIP8_MAX_ROM_SIZE bytes of a longer program are loaded;
+ * check it with Chip8Rom_valid to refuse it instead.
  */
-Chip8Proc Chip8_init(uint8_t *program,
+Chip8Proc Chip8_init(const uint8_t *program,
         size_t progSize,
-        void (*sendScreen)(bool *screen),
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
         void (*setSound)(bool isPlaying, Chip8Proc *self),
         bool superMode);
 
 /*
- * Advance the Chip8 processor by one step.
+ * Chip8_init into self, without the temporary and copy of returning a
+ * whole processor
+ */
+void Chip8_initAt(Chip8Proc *self,
+        const uint8_t *program,
+        size_t progSize,
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
+        void (*setSound)(bool isPlaying, Chip8Proc *self),
+        bool superMode);
+
+/*
+ * Put self back in the state Chip8_init would create it in for program,
+ * with the callbacks, mode and seed of fresh, a processor fresh from
+ * Chip8_init (whose own program does not matter). Only what running can
+ * have changed is rewritten, so this is much cheaper than Chip8_init for
+ * running many short programs. Translated code, a debugger (and a
+ * profile) attached to self stay attached, but a module compiled ahead of
+ * time and a trace do not. A program longer than CHIP8_MAX_ROM_SIZE is cut
+ * short as by Chip8_init.
+ */
+void Chip8_reset(Chip8Proc *self, const Chip8Proc *fresh,
+        const uint8_t *program, size_t progSize);
+
+/*
+ * Reseed the processor's random number generator. Chip8_init seeds it with
+ * CHIP8_DEFAULT_SEED, so a program given the same input always runs the
+ * same way.
+ */
+void Chip8_seed(Chip8Proc *self, uint32_t seed);
+
+/*
+ * Advance the Chip8 processor by one step, or none while it waits for a
+ * key (see waitKey).
  * Does not decrement timers.
- * Returns false if the processor has exited (00FD), true otherwise.
+ * Returns false if the processor has trapped (see trap), true otherwise.
  */
 bool Chip8_advance(Chip8Proc *self);
 
 /*
- * Run the Chip8 processor
+ * Advance the Chip8 processor by one step, as Chip8_advance.
+ * Returns the trap the processor is stopped on, CHIP8_TRAP_NONE if it can
+ * keep running.
+ */
+Chip8Trap Chip8_step(Chip8Proc *self);
+
+/*
+ * Short description of a trap, for error messages
+ */
+const char *Chip8_trapName(Chip8Trap trap);
+
+/*
+ * Advance the Chip8 processor by up to budget steps using its module
+ * compiled ahead of time if one is attached, else the JIT if it is
+ * enabled, else the predecoded, threaded interpreter (or Chip8_advance if
+ * referenceMode is set, a profile is attached or a debugger is armed).
+ * Stops early once the processor waits for a key (Fx0A).
+ * With a sampling trace attached, the budget is split at each sample due.
+ * Does not decrement timers.
+ * Returns false if the processor has trapped (see trap), true otherwise.
+ */
+bool Chip8_execute(Chip8Proc *self, uint64_t budget);
+
+/*
+ * Advance the Chip8 processor by up to budget steps with the predecoded,
+ * threaded interpreter, whatever engine is attached; the JIT hands it the
+ * tail of a budget too short for the next translated block.
+ * Stops early once the processor waits for a key (Fx0A).
+ * Returns false if the processor has trapped (see trap), true otherwise.
+ */
+bool Chip8_executeThreaded(Chip8Proc *self, uint64_t budget);
+
+/*
+ * Drop the predecoded entries and translated code overlapping
+ * ram[addr, addr + len), after an instruction has written there
+ */
+void Chip8_invalidate(Chip8Proc *self, int addr, int len);
+
+/*
+ * If PC is at the head of an idle loop that cannot end before the next
+ * timer tick or key event, leave the processor exactly as budget steps of
+ * it would, without running them, and count them in idleCycles (but not
+ * cycles). The loops recognised are a 1nnn to itself, Fx07/3x00/1nnn back
+ * with D nonzero, and Ex9E/1nnn back or ExA1/1nnn back waiting on Vx.
+ * Returns false, changing nothing, if PC is not at such a loop.
+ */
+bool Chip8_skipIdle(Chip8Proc *self, uint64_t budget);
+
+/*
+ * Press (or release) key 0x0-0xF. A press completes a waiting Fx0A.
+ * Recorded to the trace, if one is attached.
+ */
+void Chip8_keyEvent(Chip8Proc *self, uint8_t key, bool pressed);
+
+/*
+ * Hand the framebuffer to presentFrame if anything was drawn since the last
+ * call, then clear the damage. Chip8_run calls this once per vblank.
+ */
+void Chip8_present(Chip8Proc *self);
+
+/*
+ * Decrement the delay and sound timers, as happens at 60Hz.
+ * Calls setSound(false, self) when the sound timer runs out.
+ * Recorded to the trace, if one is attached.
+ */
+void Chip8_tick(Chip8Proc *self);
+
+/*
+ * Run the Chip8 processor until it exits or reaches config->maxCycles,
+ * executing config->ipf instructions and one timer tick per frame.
+ * Frames are paced at 60Hz against absolute deadlines unless
+ * config->headless is set. Key events from config->input are delivered
+ * before each frame, and as they arrive while sleeping; while the
+ * processor waits for a key, frames (and timer ticks) are paced at 60Hz
+ * even when headless. A frame of audio goes to config->audio before each
+ * tick, so a tone lasts exactly as many frames as S counts down.
+ */
+Chip8RunStats Chip8_run(Chip8Proc *self, const Chip8RunConfig *config);
+
+/*
+ * Read the pixel at (row, col) of a packed framebuffer
  */
-void Chip8_run(Chip8Proc *self);
+static inline bool Chip8_getPixel(uint64_t screen[64][2], int row, int col) {
+    return screen[row][col >> 6] >> (63 - (col & 63)) & 1;
+}
 
 #endif
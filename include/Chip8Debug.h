@@ -0,0 +1,157 @@
+#ifndef CHIP_8_DEBUG_H
+#define CHIP_8_DEBUG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Chip8Core.h"
+
+// Register conditions armed at once, at most
+#define CHIP8_DEBUG_CONDITIONS 16
+
+// Kinds of ram access a watchpoint stops on
+#define CHIP8_WATCH_READ 0x1
+#define CHIP8_WATCH_WRITE 0x2
+
+/*
+ * What a condition tests: V0-VF are 0x0-0xF
+ */
+typedef enum Chip8Register {
+    CHIP8_REG_I = 0x10,
+    CHIP8_REG_D,
+    CHIP8_REG_S,
+    CHIP8_REG_SC
+} Chip8Register;
+
+typedef enum Chip8Compare {
+    CHIP8_CMP_EQ, CHIP8_CMP_NE, CHIP8_CMP_LT, CHIP8_CMP_LE, CHIP8_CMP_GT,
+    CHIP8_CMP_GE
+} Chip8Compare;
+
+/*
+ * Stop when a register compares with a value as given, at addr or before
+ * any instruction if addr is -1
+ */
+typedef struct Chip8Condition {
+    bool used;
+    int16_t addr;
+    uint8_t reg;
+    Chip8Compare cmp;
+    uint16_t value;
+} Chip8Condition;
+
+/*
+ * Why a processor last stopped on CHIP8_TRAP_BREAK
+ */
+typedef enum Chip8StopKind {
+    CHIP8_STOP_NONE,
+    CHIP8_STOP_BREAKPOINT,  // PC reached a breakpoint
+    CHIP8_STOP_CONDITION,   // A condition held (see Chip8DebugStop.index)
+    CHIP8_STOP_READ,        // The instruction at PC reads watched ram
+    CHIP8_STOP_WRITE        // The instruction at PC writes watched ram
+} Chip8StopKind;
+
+typedef struct Chip8DebugStop {
+    Chip8StopKind kind;
+    // The watched address accessed, or the condition that held
+    uint16_t addr;
+    int index;
+} Chip8DebugStop;
+
+/*
+ * Breakpoints, watchpoints and register conditions for one processor.
+ *
+ * While any is armed and the Chip8Debug is attached as proc->debug,
+ * Chip8_execute runs everything through Chip8_advance, which checks one
+ * bitmap bit per instruction and, for Dxyn, Fx33, Fx55 and Fx65, the
+ * watch bitmap for the bytes accessed. With none armed the fast engines
+ * run as usual. A stop traps the processor with CHIP8_TRAP_BREAK before
+ * the instruction at PC has changed anything; Chip8Debug_resume clears it
+ * and lets that instruction through once.
+ */
+typedef struct Chip8Debug {
+    // Bit a % 64 of word a / 64 is set for a breakpoint at a, or for any
+    // condition bound to a
+    uint64_t stopAt[64];
+    uint64_t breakAt[64];
+    // Watched ram addresses, for reads and writes
+    uint64_t watchRead[64], watchWrite[64];
+    Chip8Condition conditions[CHIP8_DEBUG_CONDITIONS];
+    // Conditions tested before every instruction (addr -1)
+    unsigned unbound;
+    // Breakpoints, watched addresses and conditions armed
+    unsigned armed;
+    // The cycle count whose instruction is let through after a stop,
+    // UINT64_MAX for none
+    uint64_t resumeAt;
+    Chip8DebugStop stop;
+} Chip8Debug;
+
+// True if instructions should go through Chip8_advance to be checked
+#define CHIP8_DEBUGGING(proc) \
+    ((proc)->debug != NULL && (proc)->debug->armed != 0)
+
+/*
+ * Start self with nothing armed
+ */
+void Chip8Debug_init(Chip8Debug *self);
+
+/*
+ * Arm (or disarm) a breakpoint at addr.
+ * Returns false with errno set to EINVAL if addr is outside of ram.
+ */
+bool Chip8Debug_setBreak(Chip8Debug *self, uint16_t addr, bool set);
+
+/*
+ * Watch (or stop watching) len bytes of ram from addr for the accesses
+ * in kinds (CHIP8_WATCH_READ and/or CHIP8_WATCH_WRITE).
+ * Returns false with errno set to EINVAL if they run outside of ram.
+ */
+bool Chip8Debug_setWatch(Chip8Debug *self, uint16_t addr, int len,
+        int kinds, bool set);
+
+/*
+ * Arm a condition: stop when reg compares with value by cmp, at addr or
+ * before any instruction if addr is -1.
+ * Returns its index, or -1 with errno set to ENOSPC if all
+ * CHIP8_DEBUG_CONDITIONS are in use, or EINVAL for a bad addr or reg.
+ */
+int Chip8Debug_addCondition(Chip8Debug *self, int addr, uint8_t reg,
+        Chip8Compare cmp, uint16_t value);
+
+/*
+ * Disarm the condition at index.
+ * Returns false with errno set to EINVAL if there is none.
+ */
+bool Chip8Debug_removeCondition(Chip8Debug *self, int index);
+
+/*
+ * If proc is stopped on CHIP8_TRAP_BREAK, clear the trap and let the
+ * instruction at PC run once without stopping
+ */
+void Chip8Debug_resume(Chip8Proc *proc);
+
+/*
+ * For Chip8_advance, before the instruction at PC: true if a breakpoint or
+ * condition stops it there, noted in the stop
+ */
+bool Chip8Debug_stops(Chip8Proc *proc);
+
+/*
+ * For Chip8_advance, before the instruction at PC accesses len bytes of
+ * ram from addr: true if a watchpoint for the access kind stops it, noted
+ * in the stop
+ */
+bool Chip8Debug_watches(Chip8Proc *proc, uint16_t addr, int len, int kind);
+
+/*
+ * Name of a register, such as "V3" or "I"
+ */
+const char *Chip8_registerName(uint8_t reg);
+
+/*
+ * Value of a register of proc, as conditions see it
+ */
+int Chip8_registerValue(const Chip8Proc *proc, uint8_t reg);
+
+#endif
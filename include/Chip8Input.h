@@ -0,0 +1,74 @@
+#ifndef CHIP_8_INPUT_H
+#define CHIP_8_INPUT_H
+
+#include <stdalign.h>
+
+#include "Chip8Atomic.h"
+#include "Chip8Core.h"
+
+// Events the queue holds; a power of two
+#define CHIP8_INPUT_QUEUE_SIZE 64
+
+typedef struct Chip8KeyEvent {
+    // Monotonic time the event was pushed, in nanoseconds
+    uint64_t stamp;
+    uint8_t key;
+    bool pressed;
+} Chip8KeyEvent;
+
+/*
+ * Lock-free queue of key events from one host input thread (the producer)
+ * to the thread running the processor (the consumer), usually through
+ * Chip8RunConfig.input.
+ *
+ * head and tail count events pushed and popped, and live on their own
+ * cache lines so the two threads never write the same line. The consumer
+ * may sleep until an event arrives (Chip8Input_wait); the producer only
+ * makes a system call to wake it when it is asleep.
+ */
+typedef struct Chip8Input {
+    // Written by the producer only
+    alignas(64) CHIP8_ATOMIC(uint32_t) head;
+    // Events pushed while the queue was full
+    uint64_t dropped;
+
+    // Written by the consumer only
+    alignas(64) CHIP8_ATOMIC(uint32_t) tail;
+    // Set while the consumer is asleep in Chip8Input_wait
+    CHIP8_ATOMIC(uint32_t) sleeping;
+    // Events delivered, and the total and largest latency from push to
+    // delivery, in nanoseconds
+    uint64_t delivered, latencyTotal, latencyMax;
+
+    Chip8KeyEvent events[CHIP8_INPUT_QUEUE_SIZE];
+} Chip8Input;
+
+void Chip8Input_init(Chip8Input *self);
+
+/*
+ * Producer: queue a key press or release, waking the consumer if it is
+ * asleep.
+ * Returns false (and counts the event as dropped) if the queue is full.
+ */
+bool Chip8Input_push(Chip8Input *self, uint8_t key, bool pressed);
+
+/*
+ * Consumer: hand every queued event to proc through Chip8_keyEvent, in
+ * order, and account for its latency.
+ * Returns the number of events delivered.
+ */
+int Chip8Input_deliver(Chip8Input *self, Chip8Proc *proc);
+
+/*
+ * Consumer: sleep until an event is queued or the monotonic clock reaches
+ * deadline (in nanoseconds).
+ * Returns true if an event is queued.
+ */
+bool Chip8Input_wait(Chip8Input *self, uint64_t deadline);
+
+/*
+ * Monotonic time in nanoseconds, the clock of stamps and deadlines
+ */
+uint64_t Chip8Input_now(void);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef CHIP_8_JIT_H
+#define CHIP_8_JIT_H
+
+#include "Chip8Core.h"
+
+/*
+ * Allocate native translation state for the processor, so Chip8_execute
+ * runs translated basic blocks.
+ * Returns false if the host cannot run generated code (not x86-64).
+ */
+bool Chip8Jit_enable(Chip8Proc *self);
+
+/*
+ * Release the processor's translation state; Chip8_execute goes back to
+ * the interpreter
+ */
+void Chip8Jit_disable(Chip8Proc *self);
+
+/*
+ * Advance the processor by up to budget steps using translated blocks,
+ * falling back to Chip8_advance for anything that is not translated, and
+ * to the threaded interpreter for a tail of the budget too short for the
+ * next block.
+ * Returns false if the processor has trapped (see Chip8Proc.trap), true
+ * otherwise.
+ */
+bool Chip8Jit_execute(Chip8Proc *self, uint64_t budget);
+
+/*
+ * Drop every translated block if ram[addr, addr + len) was translated
+ */
+void Chip8Jit_invalidate(Chip8Proc *self, int addr, int len);
+
+#endif
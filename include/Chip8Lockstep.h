@@ -0,0 +1,79 @@
+#ifndef CHIP_8_LOCKSTEP_H
+#define CHIP_8_LOCKSTEP_H
+
+#include "Chip8Core.h"
+
+// Instances per group: one byte per lane of a vector register (the
+// benchmark harness is built with -mavx2; see BENCH_ARCH in the Makefile)
+#if defined(__AVX2__)
+#define CHIP8_LANES 32
+#else
+#define CHIP8_LANES 16
+#endif
+
+// One register across all lanes (maps onto one SSE/AVX2 register)
+typedef uint8_t Chip8Lane8 __attribute__((vector_size(CHIP8_LANES)));
+typedef uint16_t Chip8Lane16 __attribute__((vector_size(2 * CHIP8_LANES)));
+
+/*
+ * A group of processors running the same program in lockstep.
+ *
+ * While every running lane is at the same PC (converged), V and I live
+ * here in structure-of-arrays form, ALU ops, loads and skips run as vector
+ * operations, Fx33, Fx55 and Fx65 move bytes between them and each lane's
+ * ram, calls and returns run on a stack shared by the lanes, and
+ * everything else runs per lane through Chip8_advance, with only the
+ * registers the instruction uses copied to and from the lane's Chip8Proc.
+ * Once the lanes' PCs differ (diverged), each lane's Chip8Proc holds its
+ * whole state and lanes step individually until they meet again.
+ */
+typedef struct Chip8Lockstep {
+    // V[r][lane] is register Vr of that lane
+    Chip8Lane8 V[16];
+    Chip8Lane16 I;
+    // 0xFF for lanes that are still running
+    Chip8Lane8 active;
+    // Shared PC while converged
+    uint16_t PC;
+    bool converged;
+    // Stack of every running lane while converged with stackShared set
+    // (the lanes met with the same stack); else each proc holds its own
+    uint16_t stack[16];
+    int8_t SC;
+    bool stackShared;
+    // Addresses [storedLow, storedHigh) span every ram byte a lane has
+    // stored to; opcodes there are compared across lanes before being run
+    // as one
+    uint16_t storedLow, storedHigh;
+    // Vector steps not yet added to each running lane's cycles
+    uint64_t pendingCycles;
+
+    // Holds everything else: timers, stack, ram, screen, callbacks
+    Chip8Proc *procs[CHIP8_LANES];
+
+    // Steps run as vector operations, per lane while converged, and
+    // per lane while diverged
+    uint64_t vectorSteps, laneSteps, divergedSteps;
+} Chip8Lockstep;
+
+/*
+ * Group count (<= CHIP8_LANES) initialized processors; unused lanes are
+ * left stopped
+ */
+void Chip8Lockstep_init(Chip8Lockstep *self, Chip8Proc **procs, int count);
+
+/*
+ * Advance every running lane by up to budget steps. A lane stops when it
+ * traps or waits for a key (Fx0A), which only its own Chip8Proc can
+ * resume.
+ * Returns false once every lane has stopped.
+ */
+bool Chip8Lockstep_execute(Chip8Lockstep *self, uint64_t budget);
+
+/*
+ * Write the vector state back to the lanes' Chip8Procs, so they can be
+ * inspected or run on their own
+ */
+void Chip8Lockstep_sync(Chip8Lockstep *self);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef CHIP_8_POOL_H
+#define CHIP_8_POOL_H
+
+#include <stddef.h>
+
+#include "Chip8Core.h"
+
+// Processors in each slab unless Chip8Pool_init is given a size
+#define CHIP8_POOL_DEFAULT_SLAB 16
+
+/*
+ * Slab allocator of processors for running many programs. Processors are
+ * carved out of cache-line-aligned slabs, and a processor released back to
+ * the pool is handed out again by Chip8_reset rather than Chip8_init, so
+ * once the pool holds as many processors as are in use at once, acquiring
+ * and releasing them allocates nothing and rewrites only what the last
+ * program changed.
+ */
+typedef struct Chip8Pool {
+    // Every processor acquired starts as this one loaded with its program;
+    // Chip8_seed it to change their seed
+    Chip8Proc fresh;
+    // Slabs allocated, newest first, and how many processors of the newest
+    // have ever been handed out
+    struct Chip8PoolSlab *slabs;
+    size_t slabUsed, slabSize;
+    // Released processors, most recent last, with room for every processor
+    // in the slabs
+    Chip8Proc **released;
+    size_t releasedCount, capacity;
+} Chip8Pool;
+
+/*
+ * Create an empty pool of processors with the given callbacks and mode,
+ * allocated slabSize at a time (0 for CHIP8_POOL_DEFAULT_SLAB)
+ */
+void Chip8Pool_init(Chip8Pool *self, size_t slabSize,
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
+        void (*setSound)(bool isPlaying, Chip8Proc *self),
+        bool superMode);
+
+/*
+ * Hand out a processor in the state Chip8_init would create it in for
+ * program, with the pool's callbacks, mode and seed. The one released
+ * most recently is reused first, keeping translated code or a debugger
+ * attached to it (see Chip8_reset).
+ */
+Chip8Proc *Chip8Pool_acquire(Chip8Pool *self, const uint8_t *program,
+        size_t progSize);
+
+/*
+ * Give proc, from Chip8Pool_acquire, back to the pool
+ */
+void Chip8Pool_release(Chip8Pool *self, Chip8Proc *proc);
+
+/*
+ * Free every processor of the pool, with any translated code still
+ * attached to them. Debuggers attached to them are left to their owners.
+ */
+void Chip8Pool_free(Chip8Pool *self);
+
+#endif
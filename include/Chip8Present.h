@@ -0,0 +1,93 @@
+#ifndef CHIP_8_PRESENT_H
+#define CHIP_8_PRESENT_H
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Chip8Atomic.h"
+
+/*
+ * One published framebuffer
+ */
+typedef struct Chip8Frame {
+    uint64_t screen[64][2];
+    // Rows that differ from the frame rendered before it, filled in by the
+    // render thread
+    uint64_t dirtyRows;
+    // Processor cycle count, and monotonic time in nanoseconds, when it was
+    // published
+    uint64_t cycles, stamp;
+} Chip8Frame;
+
+/*
+ * Presentation pipeline: the emulation thread publishes each presented
+ * frame into a lock-free triple buffer and carries on, and a render thread
+ * started by Chip8Presenter_open hands the latest frame to a render
+ * callback, at most refreshHz times a second. However slow rendering is,
+ * publishing never waits: a frame not taken before the next is published
+ * is dropped and counted.
+ *
+ * Of the three slots, the emulation thread writes the back one and the
+ * render thread reads the front one. middle holds the index of the third
+ * plus CHIP8_FRAME_FRESH while it holds a frame the render thread has not
+ * taken; each side swaps its slot with it atomically. The render thread
+ * sleeps on sequence until a frame is published (see Chip8Input).
+ */
+typedef struct Chip8Presenter {
+    // Written by the emulation thread only
+    alignas(64) unsigned back;
+    // Frames published, and those dropped before being taken
+    uint64_t published, dropped;
+
+    alignas(64) CHIP8_ATOMIC(uint32_t) middle;
+    // Counts publishes, for the render thread to sleep on
+    CHIP8_ATOMIC(uint32_t) sequence;
+    // Set while the render thread is asleep
+    CHIP8_ATOMIC(uint32_t) sleeping;
+    CHIP8_ATOMIC(bool) stop;
+
+    // Written by the render thread only
+    alignas(64) unsigned front;
+    // Frames rendered, and the total and largest latency from publishing
+    // to rendering them, in nanoseconds; frames taken that changed no row
+    // are not rendered, and count only in unchanged
+    uint64_t presented, latencyTotal, latencyMax;
+    uint64_t unchanged;
+    // Shortest time between renders (0 for none), and the last frame
+    // rendered, to find the rows each frame changes
+    uint64_t interval;
+    uint64_t shown[64][2];
+
+    void (*render)(Chip8Frame *frame, void *context);
+    void *context;
+    pthread_t thread;
+    Chip8Frame frames[3];
+} Chip8Presenter;
+
+// Set in middle while its slot holds a frame not yet taken
+#define CHIP8_FRAME_FRESH 0x4
+
+/*
+ * Start a render thread calling render(frame, context) for the latest
+ * frame published, at most refreshHz times a second (0 for no limit).
+ * Returns false with errno set if the thread cannot be created.
+ */
+bool Chip8Presenter_open(Chip8Presenter *self, unsigned refreshHz,
+        void (*render)(Chip8Frame *frame, void *context), void *context);
+
+/*
+ * Emulation thread: publish a copy of screen, taken after cycles
+ * instructions, without waiting for the render thread
+ */
+void Chip8Presenter_publish(Chip8Presenter *self, uint64_t screen[64][2],
+        uint64_t cycles);
+
+/*
+ * Render the last frame published if it has not been, then stop the
+ * render thread
+ */
+void Chip8Presenter_close(Chip8Presenter *self);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef CHIP_8_PROFILE_H
+#define CHIP_8_PROFILE_H
+
+#include "Chip8Core.h"
+
+/*
+ * Guest profiler, compiled in only with -DCHIP8_PROFILE (make PROFILE=1).
+ *
+ * While a Chip8Profile is attached to a processor, Chip8_execute runs
+ * everything through Chip8_advance, which counts each instruction and the
+ * host time it took against its opcode class and its address, and samples
+ * the guest call stack every samplePeriod instructions.
+ */
+#ifdef CHIP8_PROFILE
+
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+// Distinct call stacks kept; further ones are counted as "[other]"
+#define CHIP8_PROFILE_STACKS 1024
+
+typedef struct Chip8ProfileStack {
+    // Entry points of the program and the active subroutines, outermost
+    // first
+    uint16_t frames[17];
+    uint8_t depth;
+    uint64_t samples;
+} Chip8ProfileStack;
+
+typedef struct Chip8Profile {
+    // Executions and host ticks per opcode class (see Chip8Profile_className)
+    uint64_t count[64], ticks[64];
+    // Executions per instruction address
+    uint64_t pcHits[4096];
+    // Opcode class of every opcode
+    uint8_t classOf[65536];
+
+    // Entry point of the code at each stack level (SC + 1), noted on 2nnn
+    uint16_t entries[17];
+    // Instructions between call stack samples, and until the next one
+    unsigned samplePeriod, untilSample;
+    Chip8ProfileStack stacks[CHIP8_PROFILE_STACKS];
+    uint64_t otherSamples;
+} Chip8Profile;
+
+// True if instructions should go through Chip8_advance to be profiled
+#define CHIP8_PROFILING(proc) ((proc)->profile != NULL)
+
+/*
+ * Host time stamp: the TSC where there is one, nanoseconds otherwise
+ */
+static inline uint64_t Chip8Profile_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/*
+ * Allocate an empty profile sampling the call stack every samplePeriod
+ * instructions (0 to never sample it)
+ */
+Chip8Profile *Chip8Profile_create(unsigned samplePeriod);
+
+void Chip8Profile_free(Chip8Profile *self);
+
+/*
+ * Account for one instruction: opcode, fetched at pc, took ticks and left
+ * the processor in proc's current state
+ */
+void Chip8Profile_record(Chip8Profile *self, const Chip8Proc *proc,
+        uint16_t pc, uint16_t opcode, uint64_t ticks);
+
+/*
+ * Name of opcode class index c, such as "8xy4", NULL past the last class
+ */
+const char *Chip8Profile_className(int c);
+
+/*
+ * Write the sampled call stacks in the folded format read by
+ * flamegraph.pl: one "main;sub_2A4;sub_31C <samples>" line per stack
+ */
+void Chip8Profile_writeFolded(const Chip8Profile *self, FILE *out);
+
+/*
+ * Write the opcode classes by time spent, then the top hottest addresses
+ * with the opcode at each in proc's ram
+ */
+void Chip8Profile_writeReport(const Chip8Profile *self, const Chip8Proc *proc,
+        int top, FILE *out);
+
+#else
+
+#define CHIP8_PROFILING(proc) false
+
+#endif
+
+#endif
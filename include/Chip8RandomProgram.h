@@ -0,0 +1,70 @@
+#ifndef CHIP_8_RANDOM_PROGRAM_H
+#define CHIP_8_RANDOM_PROGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Random programs for the differential checks of the fuzzing harness and
+ * the unit tests, so that both run the same instruction mix
+ */
+
+/*
+ * Next number from a xorshift32 generator (state must not be 0)
+ */
+static inline uint32_t Chip8RandomProgram_next(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/*
+ * Fill program with size bytes (even) of random instructions of every
+ * kind, with jumps, calls and addresses kept inside it so that it loops,
+ * draws, reads keys and rewrites itself rather than running off into
+ * zeroes
+ */
+static inline void Chip8RandomProgram_fill(uint8_t *program, size_t size,
+        uint32_t *state) {
+    static const uint16_t system[] = {
+        0x00E0, 0x00EE, 0x00C2, 0x00FB, 0x00FC, 0x00FE, 0x00FF
+    };
+    static const uint8_t arithmetic[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0xE };
+    static const uint8_t misc[] = {
+        0x07, 0x0A, 0x15, 0x18, 0x1E, 0x29, 0x30, 0x33, 0x55, 0x65, 0x75, 0x85
+    };
+    for (size_t i = 0; i < size; i += 2) {
+        uint32_t bits = Chip8RandomProgram_next(state);
+        uint16_t x = bits >> 8 & 0xF, y = bits >> 12 & 0xF;
+        uint16_t target = 0x200 + (bits >> 16) % (size / 2) * 2;
+        uint16_t op;
+        switch (bits % 20) {
+            case 0: op = system[(bits >> 16) % 7]; break;
+            case 1: op = 0x1000 | target; break;
+            // Calls are rarer than returns, so the stack seldom overflows
+            case 2: op = (bits >> 16) % 4 ? 0x6000 : 0x2000 | target; break;
+            case 3: op = 0x3000 | x << 8 | (bits >> 16 & 0xFF); break;
+            case 4: op = 0x4000 | x << 8 | (bits >> 16 & 3); break;
+            case 5: op = 0x5000 | x << 8 | y << 4; break;
+            case 6: op = 0x6000 | x << 8 | (bits >> 16 & 0xFF); break;
+            case 7: op = 0x7000 | x << 8 | (bits >> 16 & 0xFF); break;
+            case 8: op = 0x8000 | x << 8 | y << 4
+                | arithmetic[(bits >> 16) % 9]; break;
+            case 9: op = 0x9000 | x << 8 | y << 4; break;
+            case 10: op = 0xA000 | (0x200 + (bits >> 16) % size); break;
+            case 11: op = 0xB000 | (target & ~0xFu); break;
+            case 12: op = 0xC000 | x << 8 | (bits >> 16 & 0xFF); break;
+            case 13: op = 0xD000 | x << 8 | y << 4 | (bits >> 16 & 0xF); break;
+            case 14: op = 0xE000 | x << 8 | ((bits >> 16) & 1 ? 0x9E : 0xA1);
+                     break;
+            case 15: op = 0xF000 | x << 8 | misc[(bits >> 16) % 12]; break;
+            case 16: op = (bits >> 16) % 64 ? 0x7000 | x << 8 : 0x00FD; break;
+            default: op = 0x7000 | x << 8 | (bits >> 16 & 0xFF); break;
+        }
+        program[i] = op >> 8;
+        program[i + 1] = op & 0xFF;
+    }
+}
+
+#endif
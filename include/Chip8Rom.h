@@ -0,0 +1,76 @@
+#ifndef CHIP_8_ROM_H
+#define CHIP_8_ROM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Chip8Core.h"
+
+// First bytes of a packed archive
+#define CHIP8_PACK_MAGIC "CHIP8PAK"
+#define CHIP8_PACK_VERSION 1
+
+/*
+ * A program image, mapped read-only from a file or an archive
+ */
+typedef struct Chip8Rom {
+    // The file path, or the name stored in the archive
+    const char *name;
+    const uint8_t *data;
+    size_t size;
+} Chip8Rom;
+
+/*
+ * ROMs loaded from any number of files, directories and packed archives.
+ *
+ * A packed archive maps every ROM of a corpus with a single mmap, so
+ * starting a batch of thousands of ROMs costs a handful of system calls.
+ * Its layout, with little-endian 32-bit fields:
+ *   "CHIP8PAK", version, count,
+ *   count entries of (offset, size, name offset, name length),
+ *   then the names (each NUL-terminated) and the ROM data.
+ * Offsets are from the start of the archive.
+ */
+typedef struct Chip8RomSet {
+    Chip8Rom *roms;
+    size_t count, capacity;
+    // Mappings and names owned by the set, released by Chip8RomSet_free
+    struct Chip8RomMapping {
+        void *addr;
+        size_t size;
+    } *maps;
+    size_t mapCount, mapCapacity;
+    char **names;
+    size_t nameCount, nameCapacity;
+} Chip8RomSet;
+
+void Chip8RomSet_init(Chip8RomSet *self);
+
+/*
+ * Add the ROM at path, every regular file in it if it is a directory (in
+ * name order), or every ROM in it if it is a packed archive.
+ * Returns false with errno set if path cannot be read or an archive is
+ * malformed (EINVAL); ROMs already added are kept.
+ */
+bool Chip8RomSet_add(Chip8RomSet *self, const char *path);
+
+/*
+ * Unmap and free everything in the set
+ */
+void Chip8RomSet_free(Chip8RomSet *self);
+
+/*
+ * Write every ROM in the set to a packed archive at path.
+ * Returns false with errno set if it cannot be written.
+ */
+bool Chip8RomSet_pack(const Chip8RomSet *self, const char *path);
+
+/*
+ * True if the ROM fits the 0x200-0xFFF program window and is not empty
+ */
+static inline bool Chip8Rom_valid(const Chip8Rom *rom) {
+    return rom->size > 0 && rom->size <= CHIP8_MAX_ROM_SIZE;
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef CHIP_8_STATE_H
+#define CHIP_8_STATE_H
+
+#include "Chip8Core.h"
+
+#define CHIP8_STATE_MAGIC   0x38504843 // "CHP8"
+#define CHIP8_STATE_VERSION 3
+
+/*
+ * The fields of Chip8Proc a program can observe, as X(name) for each, for
+ * differential checks to compare (idleCycles is bookkeeping only)
+ */
+#define CHIP8_OBSERVABLE_FIELDS(X) \
+    X(V) X(I) X(D) X(S) X(FR) X(PC) X(SC) X(stack) X(keys) X(waitKey) \
+    X(ram) X(screen) X(cycles) X(randState) X(superMode) X(largeScreen) \
+    X(trap) X(trapPC) X(trapOpcode)
+
+/*
+ * Architectural state of a processor: everything a program can observe,
+ * without the predecode cache, translations or callbacks.
+ * Stored in host byte order; the size is a whole number of 64-bit words.
+ */
+typedef struct Chip8State {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t D, S;
+    uint8_t V[16];
+    uint8_t FR[8];
+    uint16_t I;
+    int16_t PC;
+    int8_t SC;
+    bool superMode, largeScreen;
+    uint8_t trap;
+    uint16_t trapPC, trapOpcode;
+    uint16_t stack[16];
+    uint32_t randState;
+    uint16_t keys;
+    int8_t waitKey;
+    // Always 0; keeps the struct free of padding
+    uint8_t reserved[5];
+    uint64_t cycles;
+    uint64_t screen[64][2];
+    uint8_t ram[4096];
+} Chip8State;
+
+/*
+ * Copy the processor's architectural state into state
+ */
+void Chip8_saveState(const Chip8Proc *self, Chip8State *state);
+
+/*
+ * Restore state into the processor, dropping its decoded and translated
+ * code and marking the whole screen for the next present.
+ * Returns false, leaving the processor untouched, if state was not saved
+ * by this version of Chip8_saveState or holds registers out of range (PC
+ * past where a program can jump, SC or waitKey outside -1..15, an unknown
+ * trap or a return address outside ram).
+ */
+bool Chip8_loadState(Chip8Proc *self, const Chip8State *state);
+
+/*
+ * A rewind history of the last frames within a fixed memory budget.
+ *
+ * Each frame is stored as the XOR of its state against the most recent
+ * keyframe, run-length encoded over 64-bit words, so frames that change
+ * little cost a few bytes. A keyframe (a whole Chip8State) is written
+ * every keyInterval frames, or sooner if a delta would not be smaller.
+ * Once the budget is used up, the oldest keyframe is dropped along with
+ * the deltas that depend on it.
+ */
+typedef struct Chip8Rewind {
+    // Records, each a header followed by a keyframe or a delta
+    uint8_t *ring;
+    size_t capacity;
+    // Byte offsets of the oldest and newest records and of the free space
+    size_t oldest, newest, write;
+    size_t frames;
+    // Frames between keyframes
+    unsigned keyInterval;
+    // Worst-case encoded delta, built here before it is copied into ring
+    uint8_t *scratch;
+    // Frame being saved or restored
+    Chip8State state;
+} Chip8Rewind;
+
+/*
+ * Set up an empty history holding as many frames as fit in budget bytes.
+ * Returns false if budget cannot hold a single keyframe.
+ */
+bool Chip8Rewind_init(Chip8Rewind *self, size_t budget, unsigned keyInterval);
+
+/*
+ * Release the history's memory
+ */
+void Chip8Rewind_free(Chip8Rewind *self);
+
+/*
+ * Record the processor's current state as the newest frame
+ */
+void Chip8Rewind_push(Chip8Rewind *self, const Chip8Proc *proc);
+
+/*
+ * Restore the newest frame into the processor and drop it from the history.
+ * Returns false if the history is empty.
+ */
+bool Chip8Rewind_pop(Chip8Rewind *self, Chip8Proc *proc);
+
+#endif
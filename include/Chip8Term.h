@@ -0,0 +1,64 @@
+#ifndef CHIP_8_TERM_H
+#define CHIP_8_TERM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Worst case output of one frame, a full redraw in either style
+#define CHIP8_TERM_BUFFER_SIZE (64 * 1024)
+
+typedef enum Chip8TermStyle {
+    // Half-block characters, two pixel rows per line (132x34 cells)
+    CHIP8_TERM_COMPACT,
+    // '#' per pixel (130x66 cells)
+    CHIP8_TERM_FULL
+} Chip8TermStyle;
+
+/*
+ * ANSI terminal display.
+ *
+ * The first frame clears the terminal and draws everything; later frames
+ * are compared against what is on the terminal and only the cells that
+ * changed are rewritten, each run of them after a cursor move. Every frame
+ * is built in one buffer and written with a single write().
+ */
+typedef struct Chip8Term {
+    int fd;
+    Chip8TermStyle style;
+    // Shortest time between frames, in nanoseconds (0 for no limit)
+    uint64_t interval;
+    // Monotonic time the next frame may be written at
+    uint64_t nextWrite;
+    // The framebuffer as it is on the terminal, once drawn is set
+    uint64_t shown[64][2];
+    bool drawn;
+    size_t length;
+    char buffer[CHIP8_TERM_BUFFER_SIZE];
+} Chip8Term;
+
+/*
+ * Set up a display writing to fd, showing at most refreshHz frames per
+ * second (0 for every frame)
+ */
+void Chip8Term_init(Chip8Term *self, int fd, Chip8TermStyle style,
+        unsigned refreshHz);
+
+/*
+ * Show the framebuffer, unless the last frame was written less than a
+ * refresh interval ago; the skipped changes go out with the next frame.
+ * Returns false if the terminal could not be written.
+ */
+bool Chip8Term_present(Chip8Term *self, uint64_t screen[64][2]);
+
+/*
+ * Show the framebuffer now, regardless of the refresh rate
+ */
+bool Chip8Term_draw(Chip8Term *self, uint64_t screen[64][2]);
+
+/*
+ * Leave the cursor below the display and show it again
+ */
+void Chip8Term_close(Chip8Term *self);
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef CHIP_8_TRACE_H
+#define CHIP_8_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Chip8Core.h"
+
+#define CHIP8_TRACE_MAGIC "CHIP8TRC"
+#define CHIP8_TRACE_VERSION 1
+#define CHIP8_TRACE_HEADER_SIZE 40
+
+// Bytes buffered before a write()
+#define CHIP8_TRACE_BUFFER_SIZE (64 * 1024)
+
+// Record kinds, the low two bits of each record's first varint
+enum {
+    CHIP8_TRACE_TICK,   // Chip8_tick
+    CHIP8_TRACE_KEY,    // Chip8_keyEvent
+    CHIP8_TRACE_SAMPLE, // Where the processor was
+    CHIP8_TRACE_END     // The end of the run
+};
+
+/*
+ * Recording of one run's inputs, to replay it exactly.
+ *
+ * A processor fresh from Chip8_init is a pure function of its program,
+ * mode and random number generator state (Cxnn draws from it), so only
+ * what arrives from outside is recorded: key events, and the timer ticks,
+ * whose spacing depends on wall-clock time while waiting for a key. Each
+ * is stamped with the instructions retired before it. Optionally, the
+ * PC and opcode about to execute are sampled at every multiple of a
+ * period of instructions, for replay to check it is still in step.
+ *
+ * The file starts with "CHIP8TRC" and the little-endian 32-bit version,
+ * flags (bit 0: SUPER-CHIP), random number generator state, sample period
+ * (0 for none), program size and a reserved 0, then the 64-bit FNV-1a
+ * hash of the program. Each record is then a varint of the instructions
+ * retired since the previous record shifted left by two, ORed with the
+ * kind, followed by:
+ *   TICK    nothing
+ *   KEY     a byte of the key, plus 0x10 for a press
+ *   SAMPLE  16-bit PC and opcode
+ *   END     a byte, 1 if the run ended on a trap; the last record
+ * Varints are LEB128.
+ */
+typedef struct Chip8Trace {
+    int fd;
+    uint32_t period;
+    // Cycle count of the last record and of the next sample due, and the
+    // records written so far
+    uint64_t cycles, nextSample;
+    uint64_t records;
+    // Set once a write has failed; later records are dropped
+    bool failed;
+    size_t length;
+    uint8_t buffer[CHIP8_TRACE_BUFFER_SIZE];
+} Chip8Trace;
+
+/*
+ * Create the trace file at path for proc, fresh from Chip8_init with
+ * program and seeded, sampling every period instructions (0 for never).
+ * The caller attaches it as proc->trace.
+ * Returns false with errno set if it cannot be created.
+ */
+bool Chip8Trace_open(Chip8Trace *self, const char *path,
+        const Chip8Proc *proc, const uint8_t *program, size_t size,
+        uint32_t period);
+
+/*
+ * Record a timer tick, or a key event, after cycles instructions
+ */
+void Chip8Trace_tick(Chip8Trace *self, uint64_t cycles);
+void Chip8Trace_key(Chip8Trace *self, uint64_t cycles, uint8_t key,
+        bool pressed);
+
+/*
+ * Record proc's PC and opcode if a sample is due
+ */
+void Chip8Trace_sample(Chip8Trace *self, const Chip8Proc *proc);
+
+/*
+ * Record the end of proc's run, write out what is buffered and close the
+ * file.
+ * Returns false with errno set if any of the trace could not be written.
+ */
+bool Chip8Trace_close(Chip8Trace *self, const Chip8Proc *proc);
+
+/*
+ * A trace file, mapped whole, and how far it has been replayed
+ */
+typedef struct Chip8TraceReader {
+    const uint8_t *data;
+    size_t size, offset;
+    // From the header
+    bool superMode;
+    uint32_t randState, period, programSize;
+    uint64_t programHash;
+    // Cycle count of the last record read, and the records read
+    uint64_t cycles, records;
+} Chip8TraceReader;
+
+/*
+ * How a replay ended
+ */
+typedef enum Chip8ReplayResult {
+    CHIP8_REPLAY_DONE,      // Reached the end of the run in step
+    CHIP8_REPLAY_MISMATCH,  // The processor is not loaded as traced
+    CHIP8_REPLAY_DIVERGED,  // A sample differs, or the processor trapped
+                            // or waited where the recording did not
+    CHIP8_REPLAY_CORRUPT    // A record is truncated or malformed
+} Chip8ReplayResult;
+
+/*
+ * Map the trace at path and check its header.
+ * Returns false with errno set if it cannot be read or is not a trace
+ * (EINVAL).
+ */
+bool Chip8TraceReader_open(Chip8TraceReader *self, const char *path);
+
+/*
+ * Run proc, fresh from Chip8_init with the traced program and mode, as
+ * fast as it goes, feeding it the recorded ticks and key events at the
+ * same instructions, and presenting a frame at every tick as Chip8_run
+ * does. The random number generator state comes from the trace. Stops at
+ * the end of the run, or where proc and the trace disagree (reader->cycles
+ * is then the cycle count of the record that failed).
+ */
+Chip8ReplayResult Chip8Trace_replay(Chip8TraceReader *self, Chip8Proc *proc,
+        const uint8_t *program, size_t size);
+
+/*
+ * Short description of a replay result, for reports
+ */
+const char *Chip8_replayResultName(Chip8ReplayResult result);
+
+void Chip8TraceReader_close(Chip8TraceReader *self);
+
+#endif
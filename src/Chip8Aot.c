@@ -0,0 +1,76 @@
+#include <string.h>
+
+#include "Chip8Aot.h"
+
+#define PROG_START 0x200
+
+// Modules registered by their constructors, most recent first
+static Chip8AotModule *modules;
+
+static uint8_t Chip8Aot_original(const Chip8AotModule *module, int addr);
+
+void Chip8Aot_register(Chip8AotModule *module) {
+    module->next = modules;
+    modules = module;
+}
+
+bool Chip8Aot_attach(Chip8Proc *self, const uint8_t *program, size_t size) {
+    for (Chip8AotModule *module = modules; module != NULL;
+            module = module->next) {
+        if (module->superMode == self->superMode && module->size == size
+                && memcmp(module->program, program, size) == 0) {
+            self->aot = module;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Chip8Aot_execute(Chip8Proc *self, uint64_t budget) {
+    uint64_t end = self->cycles + budget;
+    while (self->cycles < end && self->waitKey < 0) {
+        // Once the code has been changed, the interpreter runs the rest
+        if (self->aot == NULL) {
+            return Chip8_execute(self, end - self->cycles);
+        }
+        if (Chip8_skipIdle(self, end - self->cycles)) {
+            self->cycles = end;
+            return true;
+        }
+        self->aot->run(self, end);
+        if (self->trap != CHIP8_TRAP_NONE) {
+            return false;
+        }
+        // Stopped short of the end without waiting or being dropped:
+        // single-step what is not translated, or the tail of the budget
+        if (self->cycles < end && self->waitKey < 0 && self->aot != NULL
+                && !Chip8_advance(self)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Chip8Aot_invalidate(Chip8Proc *self, int addr, int len) {
+    const Chip8AotModule *module = self->aot;
+    if (module->superMode != self->superMode) {
+        self->aot = NULL;
+        return;
+    }
+    for (int a = addr; a < addr + len && a < 4096; ++a) {
+        if (module->covered[a / 8] >> a % 8 & 1
+                && self->ram[a] != Chip8Aot_original(module, a)) {
+            self->aot = NULL;
+            return;
+        }
+    }
+}
+
+/*
+ * The byte at addr when a processor is loaded with the module's program
+ * (only meaningful from PROG_START up)
+ */
+static uint8_t Chip8Aot_original(const Chip8AotModule *module, int addr) {
+    size_t offset = addr - PROG_START;
+    return offset < module->size ? module->program[offset] : 0;
+}
@@ -0,0 +1,289 @@
+#define _POSIX_C_SOURCE 200809L // clock_nanosleep, pwrite
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Chip8Audio.h"
+#include "Chip8Bytes.h"
+#include "Chip8Input.h"
+
+#define NS_PER_SEC 1000000000ULL
+#define FRAME_RATE 60
+#define RING_MASK (CHIP8_AUDIO_RING_SIZE - 1)
+// Peak of the square wave, a quarter of full scale
+#define AMPLITUDE 8192
+// Frames a real-time sink waits for before it starts, so it does not
+// underrun straight away
+#define PREFILL_FRAMES 2
+// How long a WAV sink sleeps when the ring is empty
+#define IDLE_NS 1000000
+#define WAV_HEADER_SIZE 44
+
+_Static_assert((CHIP8_AUDIO_RING_SIZE & RING_MASK) == 0,
+        "CHIP8_AUDIO_RING_SIZE must be a power of two");
+
+static void *Chip8Audio_main(void *arg);
+static void Chip8Audio_playRealtime(Chip8Audio *self);
+static void Chip8Audio_drain(Chip8Audio *self);
+static void Chip8Audio_take(Chip8Audio *self, uint32_t count);
+static void Chip8Audio_writeFrame(Chip8Audio *self, uint32_t count,
+        bool sounding);
+static int16_t Chip8Audio_sample(Chip8Audio *self, bool sounding);
+static bool Chip8Audio_writeAll(Chip8Audio *self, const void *data,
+        size_t size);
+static void sleepFor(uint64_t nanos);
+static void sleepUntil(uint64_t deadline);
+
+bool Chip8Audio_open(Chip8Audio *self, Chip8AudioSink sink, const char *path,
+        unsigned rate) {
+    memset(self, 0, sizeof(*self));
+    self->rate = rate;
+    self->phaseStep = (uint32_t) (((uint64_t) CHIP8_AUDIO_TONE_HZ << 32)
+            / rate);
+    self->sink = sink;
+    self->fd = -1;
+    if (sink != CHIP8_AUDIO_NULL) {
+        self->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (self->fd < 0) {
+            return false;
+        }
+        // The sizes are filled in by Chip8Audio_close
+        uint8_t header[WAV_HEADER_SIZE] = "RIFF\0\0\0\0WAVEfmt ";
+        Chip8Bytes_putLE32(header + 16, 16);        // fmt chunk size
+        Chip8Bytes_putLE16(header + 20, 1);         // PCM
+        Chip8Bytes_putLE16(header + 22, 1);         // mono
+        Chip8Bytes_putLE32(header + 24, rate);
+        Chip8Bytes_putLE32(header + 28, 2 * rate);  // bytes per second
+        Chip8Bytes_putLE16(header + 32, 2);         // bytes per sample
+        Chip8Bytes_putLE16(header + 34, 16);        // bits per sample
+        memcpy(header + 36, "data", 4);
+        if (!Chip8Audio_writeAll(self, header, sizeof(header))) {
+            close(self->fd);
+            errno = self->error;
+            return false;
+        }
+    }
+    if (sink == CHIP8_AUDIO_WAV_OFFLINE) {
+        return true;
+    }
+    int error = pthread_create(&self->thread, NULL, Chip8Audio_main, self);
+    if (error != 0) {
+        if (self->fd >= 0) {
+            close(self->fd);
+        }
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+void Chip8Audio_frame(Chip8Audio *self, bool sounding) {
+    self->remainder += self->rate;
+    uint32_t count = self->remainder / FRAME_RATE;
+    self->remainder %= FRAME_RATE;
+    if (self->sink == CHIP8_AUDIO_WAV_OFFLINE) {
+        Chip8Audio_writeFrame(self, count, sounding);
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&self->head, memory_order_relaxed),
+             tail = atomic_load_explicit(&self->tail, memory_order_acquire),
+             room = CHIP8_AUDIO_RING_SIZE - (head - tail);
+    if (count > room) {
+        // Never wait for the audio thread; the end of the frame is lost
+        self->dropped += count - room;
+        count = room;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        self->ring[(head + i) & RING_MASK] =
+            Chip8Audio_sample(self, sounding);
+    }
+    self->produced += count;
+    atomic_store_explicit(&self->head, head + count, memory_order_release);
+}
+
+bool Chip8Audio_close(Chip8Audio *self) {
+    if (self->sink != CHIP8_AUDIO_WAV_OFFLINE) {
+        atomic_store(&self->stop, true);
+        pthread_join(self->thread, NULL);
+    }
+    if (self->fd < 0) {
+        return true;
+    }
+    if (!self->failed) {
+        uint32_t bytes = 2 * self->consumed;
+        uint8_t size[4];
+        Chip8Bytes_putLE32(size, WAV_HEADER_SIZE - 8 + bytes);
+        if (pwrite(self->fd, size, 4, 4) != 4) {
+            self->failed = true;
+            self->error = errno;
+        }
+        Chip8Bytes_putLE32(size, bytes);
+        if (!self->failed && pwrite(self->fd, size, 4, 40) != 4) {
+            self->failed = true;
+            self->error = errno;
+        }
+    }
+    if (close(self->fd) != 0 && !self->failed) {
+        self->failed = true;
+        self->error = errno;
+    }
+    self->fd = -1;
+    errno = self->error;
+    return !self->failed;
+}
+
+/*
+ * Audio thread
+ */
+static void *Chip8Audio_main(void *arg) {
+    Chip8Audio *self = arg;
+    if (self->sink == CHIP8_AUDIO_NULL) {
+        Chip8Audio_playRealtime(self);
+    } else {
+        Chip8Audio_drain(self);
+    }
+    return NULL;
+}
+
+/*
+ * Take a period of samples each time the sample clock reaches it, from
+ * once the ring first holds PREFILL_FRAMES until stopped
+ */
+static void Chip8Audio_playRealtime(Chip8Audio *self) {
+    uint32_t prefill = PREFILL_FRAMES * self->rate / FRAME_RATE;
+    while (atomic_load_explicit(&self->head, memory_order_acquire)
+            - atomic_load_explicit(&self->tail, memory_order_relaxed)
+            < prefill) {
+        if (atomic_load(&self->stop)) {
+            return;
+        }
+        sleepFor(IDLE_NS);
+    }
+    // Deadlines come from the sample count, so they never drift
+    uint64_t start = Chip8Input_now(), periods = 0;
+    while (!atomic_load(&self->stop)) {
+        ++periods;
+        sleepUntil(start + periods * CHIP8_AUDIO_PERIOD * NS_PER_SEC
+                / self->rate);
+        uint32_t available = atomic_load_explicit(&self->head,
+                memory_order_acquire)
+            - atomic_load_explicit(&self->tail, memory_order_relaxed);
+        if (available < CHIP8_AUDIO_PERIOD) {
+            // A sound card would play silence for the missing samples
+            ++self->underruns;
+            Chip8Audio_take(self, available);
+        } else {
+            Chip8Audio_take(self, CHIP8_AUDIO_PERIOD);
+        }
+    }
+}
+
+/*
+ * Take samples as soon as they are in the ring, until stopped with the
+ * ring empty
+ */
+static void Chip8Audio_drain(Chip8Audio *self) {
+    for (;;) {
+        // Read stop first, so nothing rendered before it was set is missed
+        bool stopping = atomic_load(&self->stop);
+        uint32_t available = atomic_load_explicit(&self->head,
+                memory_order_acquire)
+            - atomic_load_explicit(&self->tail, memory_order_relaxed);
+        if (available > 0) {
+            Chip8Audio_take(self, available);
+        } else if (stopping) {
+            return;
+        } else {
+            sleepFor(IDLE_NS);
+        }
+    }
+}
+
+/*
+ * Hand the sink the next count samples of the ring and free their space
+ */
+static void Chip8Audio_take(Chip8Audio *self, uint32_t count) {
+    uint32_t tail = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    if (self->sink == CHIP8_AUDIO_WAV && !self->failed) {
+        uint8_t bytes[2 * CHIP8_AUDIO_PERIOD];
+        for (uint32_t done = 0; done < count && !self->failed; ) {
+            uint32_t chunk = count - done;
+            if (chunk > CHIP8_AUDIO_PERIOD) {
+                chunk = CHIP8_AUDIO_PERIOD;
+            }
+            for (uint32_t i = 0; i < chunk; ++i) {
+                Chip8Bytes_putLE16(bytes + 2 * i,
+                        self->ring[(tail + done + i) & RING_MASK]);
+            }
+            Chip8Audio_writeAll(self, bytes, 2 * chunk);
+            done += chunk;
+        }
+    }
+    self->consumed += count;
+    atomic_store_explicit(&self->tail, tail + count, memory_order_release);
+}
+
+/*
+ * Write the next count samples straight to the WAV file, on the emulation
+ * thread, for CHIP8_AUDIO_WAV_OFFLINE
+ */
+static void Chip8Audio_writeFrame(Chip8Audio *self, uint32_t count,
+        bool sounding) {
+    uint8_t bytes[2 * CHIP8_AUDIO_PERIOD];
+    for (uint32_t done = 0; done < count && !self->failed; ) {
+        uint32_t chunk = count - done;
+        if (chunk > CHIP8_AUDIO_PERIOD) {
+            chunk = CHIP8_AUDIO_PERIOD;
+        }
+        for (uint32_t i = 0; i < chunk; ++i) {
+            Chip8Bytes_putLE16(bytes + 2 * i,
+                    Chip8Audio_sample(self, sounding));
+        }
+        if (Chip8Audio_writeAll(self, bytes, 2 * chunk)) {
+            self->consumed += chunk;
+        }
+        done += chunk;
+    }
+    self->produced += count;
+}
+
+/*
+ * The next sample of the square wave, or silence
+ */
+static int16_t Chip8Audio_sample(Chip8Audio *self, bool sounding) {
+    int16_t sample = 0;
+    if (sounding) {
+        sample = self->phase >> 31 ? -AMPLITUDE : AMPLITUDE;
+    }
+    self->phase += self->phaseStep;
+    return sample;
+}
+
+/*
+ * Write size bytes to the WAV file, noting the error if that fails
+ */
+static bool Chip8Audio_writeAll(Chip8Audio *self, const void *data,
+        size_t size) {
+    if (!Chip8Bytes_writeAll(self->fd, data, size)) {
+        self->failed = true;
+        self->error = errno;
+        return false;
+    }
+    return true;
+}
+
+static void sleepFor(uint64_t nanos) {
+    sleepUntil(Chip8Input_now() + nanos);
+}
+
+static void sleepUntil(uint64_t deadline) {
+    struct timespec ts = {
+        .tv_sec = deadline / NS_PER_SEC,
+        .tv_nsec = deadline % NS_PER_SEC
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)
+            == EINTR);
+}
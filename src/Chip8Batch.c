@@ -0,0 +1,180 @@
+#define _POSIX_C_SOURCE 200809L // sysconf
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "Chip8Aot.h"
+#include "Chip8Batch.h"
+#include "Chip8Bytes.h"
+#include "Chip8Jit.h"
+#include "Chip8Pool.h"
+#include "Guards.h"
+
+/*
+ * One worker and the ROM indices it still owns. The range is packed as
+ * (next << 32 | end) so the owner (taking from the front) and thieves
+ * (taking from the back) can each claim an index with a single CAS.
+ */
+typedef struct Chip8Worker {
+    _Atomic uint64_t range;
+    pthread_t thread;
+    bool started;
+    unsigned id;
+    struct Chip8Batch *batch;
+} Chip8Worker;
+
+typedef struct Chip8Batch {
+    const Chip8Rom *roms;
+    const Chip8BatchConfig *config;
+    Chip8BatchResult *results;
+    Chip8Worker *workers;
+    unsigned workerCount;
+} Chip8Batch;
+
+static void *Chip8Batch_work(void *arg);
+static bool Chip8Batch_take(Chip8Worker *worker, bool fromBack, size_t *index);
+static void Chip8Batch_runOne(Chip8Pool *pool, const Chip8Rom *rom,
+        const Chip8BatchConfig *config, Chip8BatchResult *result);
+
+void Chip8Batch_run(const Chip8Rom *roms,
+        size_t count,
+        const Chip8BatchConfig *config,
+        Chip8BatchResult *results) {
+    unsigned threads = config->threads;
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned) online : 1;
+    }
+    if (threads > count) {
+        threads = count > 0 ? (unsigned) count : 1;
+    }
+
+    Chip8Batch batch = {
+        .roms = roms,
+        .config = config,
+        .results = results,
+        .workers = OOM_GUARD(calloc(threads, sizeof(Chip8Worker)),
+                __FILE__, __LINE__),
+        .workerCount = threads
+    };
+    // Deal out contiguous slices; idle workers steal from the others
+    for (unsigned w = 0; w < threads; ++w) {
+        uint64_t begin = count * w / threads, end = count * (w + 1) / threads;
+        atomic_init(&batch.workers[w].range, begin << 32 | end);
+        batch.workers[w].id = w;
+        batch.workers[w].batch = &batch;
+    }
+    // The calling thread is worker 0. If a thread fails to start, its
+    // slice is stolen by the others.
+    for (unsigned w = 1; w < threads; ++w) {
+        batch.workers[w].started = pthread_create(&batch.workers[w].thread,
+                NULL, Chip8Batch_work, &batch.workers[w]) == 0;
+    }
+    Chip8Batch_work(&batch.workers[0]);
+    for (unsigned w = 1; w < threads; ++w) {
+        if (batch.workers[w].started) {
+            pthread_join(batch.workers[w].thread, NULL);
+        }
+    }
+    free(batch.workers);
+}
+
+uint64_t Chip8_screenHash(const Chip8Proc *self) {
+    return Chip8Bytes_hash(self->screen, sizeof(self->screen));
+}
+
+const char *Chip8_exitReasonName(Chip8ExitReason reason) {
+    switch (reason) {
+        case CHIP8_EXIT_HALTED: return "halted";
+        case CHIP8_EXIT_BUDGET: return "budget";
+        case CHIP8_EXIT_FAULT: return "fault";
+        case CHIP8_EXIT_BLOCKED: return "blocked";
+        case CHIP8_EXIT_LOAD_ERROR: return "load-error";
+    }
+    return "unknown";
+}
+
+/*
+ * Worker thread: drain our own slice, then steal until every slice is empty
+ */
+static void *Chip8Batch_work(void *arg) {
+    Chip8Worker *self = arg;
+    Chip8Batch *batch = self->batch;
+    // One processor per worker, recycled for every ROM it runs, so each
+    // only rewrites what the last one changed
+    Chip8Pool pool;
+    Chip8Pool_init(&pool, 1, NULL, NULL, batch->config->superMode);
+    Chip8_seed(&pool.fresh, batch->config->seed);
+    size_t index;
+    for (;;) {
+        bool found = Chip8Batch_take(self, false, &index);
+        for (unsigned i = 1; !found && i < batch->workerCount; ++i) {
+            Chip8Worker *victim =
+                &batch->workers[(self->id + i) % batch->workerCount];
+            found = Chip8Batch_take(victim, true, &index);
+        }
+        if (!found) {
+            break;
+        }
+        Chip8Batch_runOne(&pool, &batch->roms[index], batch->config,
+                &batch->results[index]);
+    }
+    Chip8Pool_free(&pool);
+    return NULL;
+}
+
+/*
+ * Claim one index from a worker's range, from the front or the back.
+ * Returns false once the range is empty.
+ */
+static bool Chip8Batch_take(Chip8Worker *worker, bool fromBack, size_t *index) {
+    uint64_t range = atomic_load(&worker->range);
+    for (;;) {
+        uint64_t next = range >> 32, end = range & 0xFFFFFFFF;
+        if (next >= end) {
+            return false;
+        }
+        uint64_t claimed = fromBack
+            ? next << 32 | (end - 1)
+            : (next + 1) << 32 | end;
+        if (atomic_compare_exchange_weak(&worker->range, &range, claimed)) {
+            *index = fromBack ? end - 1 : next;
+            return true;
+        }
+    }
+}
+
+/*
+ * Run a single ROM to completion or budget
+ */
+static void Chip8Batch_runOne(Chip8Pool *pool, const Chip8Rom *rom,
+        const Chip8BatchConfig *config, Chip8BatchResult *result) {
+    if (!Chip8Rom_valid(rom)) {
+        *result = (Chip8BatchResult) { .reason = CHIP8_EXIT_LOAD_ERROR };
+        return;
+    }
+
+    Chip8Proc *proc = Chip8Pool_acquire(pool, rom->data, rom->size);
+    Chip8Aot_attach(proc, rom->data, rom->size);
+    // Translated code stays attached from one ROM to the next
+    if (config->jit) {
+        Chip8Jit_enable(proc);
+    }
+    Chip8RunConfig run = {
+        .ipf = config->ipf,
+        .headless = true,
+        .maxCycles = config->budget
+    };
+    Chip8RunStats stats = Chip8_run(proc, &run);
+
+    result->reason = proc->trap == CHIP8_TRAP_NONE
+        ? (proc->waitKey >= 0 ? CHIP8_EXIT_BLOCKED : CHIP8_EXIT_BUDGET)
+        : proc->trap == CHIP8_TRAP_EXIT ? CHIP8_EXIT_HALTED
+        : CHIP8_EXIT_FAULT;
+    result->trap = proc->trap;
+    result->trapPC = proc->trapPC;
+    result->trapOpcode = proc->trapOpcode;
+    result->cycles = stats.cycles;
+    result->screenHash = Chip8_screenHash(proc);
+    Chip8Pool_release(pool, proc);
+}
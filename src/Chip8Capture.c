@@ -0,0 +1,247 @@
+#define _POSIX_C_SOURCE 200809L // posix_madvise
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Chip8Bytes.h"
+#include "Chip8Capture.h"
+
+#define SCREEN_WORDS 128
+// Two varints and a payload of one run pair and one whole word per word
+#define MAX_RECORD_SIZE (2 * 10 + SCREEN_WORDS * (2 + 1 + 8))
+
+static uint8_t *Chip8Capture_encode(const uint64_t delta[SCREEN_WORDS],
+        const uint64_t changed[2], uint8_t *out);
+static int nextBit(const uint64_t bits[2], int from, bool set);
+static int nonzeroBytes(uint64_t value);
+static bool Chip8Capture_flush(Chip8Capture *self);
+
+bool Chip8Capture_open(Chip8Capture *self, const char *path) {
+    self->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (self->fd < 0) {
+        return false;
+    }
+    memset(self->previous, 0, sizeof(self->previous));
+    self->cycles = 0;
+    self->frames = 0;
+    self->failed = false;
+    memcpy(self->buffer, CHIP8_CAPTURE_MAGIC, 8);
+    Chip8Bytes_putLE32(self->buffer + 8, CHIP8_CAPTURE_VERSION);
+    Chip8Bytes_putLE32(self->buffer + 12, 0);
+    self->length = CHIP8_CAPTURE_HEADER_SIZE;
+    return true;
+}
+
+void Chip8Capture_frame(Chip8Capture *self, uint64_t screen[64][2],
+        uint64_t dirtyRows, uint64_t cycles) {
+    if (self->failed) {
+        return;
+    }
+    if (self->length > CHIP8_CAPTURE_BUFFER_SIZE - MAX_RECORD_SIZE
+            && !Chip8Capture_flush(self)) {
+        self->failed = true;
+        return;
+    }
+
+    // XOR only the dirty rows, noting which of the 128 words changed (bit
+    // n % 64 of changed[n / 64] for word n); the rest of delta is unused.
+    // Each changed word takes a byte mask and its nonzero bytes.
+    uint64_t delta[SCREEN_WORDS], changed[2] = { 0, 0 };
+    size_t size = 0;
+    for (uint64_t rows = dirtyRows; rows != 0; rows &= rows - 1) {
+        int r = __builtin_ctzll(rows);
+        for (int w = 0; w < 2; ++w) {
+            int word = 2 * r + w;
+            delta[word] = screen[r][w] ^ self->previous[r][w];
+            self->previous[r][w] = screen[r][w];
+            if (delta[word] != 0) {
+                changed[word / 64] |= 1ULL << word % 64;
+                size += 1 + nonzeroBytes(delta[word]);
+            }
+        }
+    }
+    // and each run of changed words a pair of counts
+    uint64_t starts[2] = {
+        changed[0] & ~(changed[0] << 1),
+        changed[1] & ~(changed[1] << 1 | changed[0] >> 63)
+    };
+    size += 2 * (__builtin_popcountll(starts[0])
+            + __builtin_popcountll(starts[1]));
+
+    uint8_t *out = self->buffer + self->length;
+    out = Chip8Bytes_putVarint(out, cycles - self->cycles);
+    out = Chip8Bytes_putVarint(out, size);
+    out = Chip8Capture_encode(delta, changed, out);
+    self->length = out - self->buffer;
+    self->cycles = cycles;
+    ++self->frames;
+}
+
+bool Chip8Capture_close(Chip8Capture *self) {
+    bool ok = !self->failed && Chip8Capture_flush(self);
+    int saved = errno;
+    if (close(self->fd) != 0 && ok) {
+        return false;
+    }
+    errno = saved;
+    return ok;
+}
+
+bool Chip8CaptureReader_open(Chip8CaptureReader *self, const char *path) {
+    memset(self, 0, sizeof(*self));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
+    }
+    if (st.st_size < CHIP8_CAPTURE_HEADER_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        errno = saved;
+        return false;
+    }
+    self->data = addr;
+    self->size = st.st_size;
+    if (memcmp(self->data, CHIP8_CAPTURE_MAGIC, 8) != 0
+            || Chip8Bytes_getLE32(self->data + 8) != CHIP8_CAPTURE_VERSION) {
+        Chip8CaptureReader_close(self);
+        errno = EINVAL;
+        return false;
+    }
+    // Reads are sequential from here on
+    posix_madvise(addr, self->size, POSIX_MADV_SEQUENTIAL);
+    self->offset = CHIP8_CAPTURE_HEADER_SIZE;
+    return true;
+}
+
+bool Chip8CaptureReader_next(Chip8CaptureReader *self) {
+    if (self->corrupt || self->offset == self->size) {
+        return false;
+    }
+    uint64_t elapsed, size;
+    if (!Chip8Bytes_getVarint(self->data, self->size, &self->offset,
+                &elapsed)
+            || !Chip8Bytes_getVarint(self->data, self->size, &self->offset,
+                &size)
+            || size > self->size - self->offset) {
+        self->corrupt = true;
+        return false;
+    }
+    const uint8_t *in = self->data + self->offset,
+                  *end = in + size;
+    int word = 0;
+    while (in < end) {
+        if (end - in < 2) {
+            self->corrupt = true;
+            return false;
+        }
+        int zeros = in[0], literals = in[1];
+        in += 2;
+        word += zeros;
+        if (word + literals > SCREEN_WORDS) {
+            self->corrupt = true;
+            return false;
+        }
+        for (; literals > 0; --literals, ++word) {
+            if (in == end || end - in - 1 < __builtin_popcount(*in)) {
+                self->corrupt = true;
+                return false;
+            }
+            uint64_t value = 0;
+            for (int b = 0, mask = *in++; b < 8; ++b) {
+                if (mask >> b & 1) {
+                    value |= (uint64_t) *in++ << 8 * b;
+                }
+            }
+            self->screen[word / 2][word % 2] ^= value;
+        }
+    }
+    self->offset += size;
+    ++self->frames;
+    self->cycles += elapsed;
+    return true;
+}
+
+void Chip8CaptureReader_close(Chip8CaptureReader *self) {
+    if (self->data != NULL) {
+        munmap((void *) self->data, self->size);
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+/*
+ * Run-length encode the changed words of a frame delta, as described in
+ * Chip8Capture.h. Returns the end of the payload.
+ */
+static uint8_t *Chip8Capture_encode(const uint64_t delta[SCREEN_WORDS],
+        const uint64_t changed[2], uint8_t *out) {
+    int word = 0, start;
+    while ((start = nextBit(changed, word, true)) < SCREEN_WORDS) {
+        int end = nextBit(changed, start, false);
+        *out++ = start - word;
+        *out++ = end - start;
+        for (word = start; word < end; ++word) {
+            uint8_t *mask = out++;
+            *mask = 0;
+            uint64_t value = delta[word];
+            for (int b = 0; b < 8; ++b, value >>= 8) {
+                if ((value & 0xFF) != 0) {
+                    *mask |= 1 << b;
+                    *out++ = value;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+/*
+ * Index of the first bit at or after from in the 128-bit set that is set
+ * (or clear), 128 if there is none
+ */
+static int nextBit(const uint64_t bits[2], int from, bool set) {
+    for (int half = from / 64; half < 2; ++half) {
+        uint64_t word = set ? bits[half] : ~bits[half];
+        if (half == from / 64) {
+            word &= ~0ULL << from % 64;
+        }
+        if (word != 0) {
+            return half * 64 + __builtin_ctzll(word);
+        }
+    }
+    return SCREEN_WORDS;
+}
+
+/*
+ * Write out the buffer; a single write() unless the file takes it in parts
+ */
+static bool Chip8Capture_flush(Chip8Capture *self) {
+    size_t length = self->length;
+    self->length = 0;
+    return Chip8Bytes_writeAll(self->fd, self->buffer, length);
+}
+
+/*
+ * Number of bytes of value that are not 0
+ */
+static int nonzeroBytes(uint64_t value) {
+    // Sets the top bit of each nonzero byte
+    uint64_t low = 0x7F7F7F7F7F7F7F7FULL;
+    return __builtin_popcountll((((value & low) + low) | value) & ~low);
+}
+
@@ -0,0 +1,393 @@
+#define _POSIX_C_SOURCE 200809L // strtok_r, strcasecmp, sigaction
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "Chip8Console.h"
+#include "Chip8Debug.h"
+
+// Longest command line read
+#define LINE_SIZE 256
+// Most words in a command
+#define MAX_WORDS 6
+// Frames "c" runs at most unless told otherwise, a minute of game time
+#define CONTINUE_FRAMES 3600
+// Frames run between checks for Ctrl-C
+#define CONTINUE_CHUNK 60
+
+static bool Chip8Console_command(Chip8Proc *proc, unsigned ipf,
+        char **words, int count, FILE *out);
+static void Chip8Console_continue(Chip8Proc *proc, unsigned ipf,
+        long frames, FILE *out);
+static void Chip8Console_interrupt(int signal);
+static void Chip8Console_where(const Chip8Proc *proc, FILE *out);
+static void Chip8Console_registers(const Chip8Proc *proc, FILE *out);
+static void Chip8Console_dump(const Chip8Proc *proc, int addr, int len,
+        FILE *out);
+static void Chip8Console_screen(const Chip8Proc *proc, FILE *out);
+static void Chip8Console_list(const Chip8Debug *debug, FILE *out);
+static void Chip8Console_help(FILE *out);
+static bool Chip8Console_number(const char *word, int base, long max,
+        long *value);
+static int Chip8Console_register(const char *word);
+static int Chip8Console_compare(const char *word);
+
+// Set by Ctrl-C while "c" runs
+static volatile sig_atomic_t interrupted;
+
+static const char *compareNames[] = { "==", "!=", "<", "<=", ">", ">=" };
+// Commands taking an address, then an optional length
+static const char *addressCommands[] = { "b", "d", "w", "rw", "aw", "uw",
+    "x" };
+
+void Chip8Console_run(Chip8Proc *proc, unsigned ipf, FILE *in, FILE *out) {
+    char line[LINE_SIZE];
+    Chip8Console_where(proc, out);
+    for (;;) {
+        fputs("(chip8) ", out);
+        fflush(out);
+        if (fgets(line, sizeof(line), in) == NULL) {
+            fputc('\n', out);
+            return;
+        }
+        char *words[MAX_WORDS], *save = NULL;
+        int count = 0;
+        for (char *word = strtok_r(line, " \t\r\n", &save);
+                word != NULL && count < MAX_WORDS;
+                word = strtok_r(NULL, " \t\r\n", &save)) {
+            words[count++] = word;
+        }
+        if (count > 0
+                && !Chip8Console_command(proc, ipf, words, count, out)) {
+            return;
+        }
+    }
+}
+
+/*
+ * Carry out one command.
+ * Returns false to quit.
+ */
+static bool Chip8Console_command(Chip8Proc *proc, unsigned ipf,
+        char **words, int count, FILE *out) {
+    Chip8Debug *debug = proc->debug;
+    const char *command = words[0];
+    long addr = 0, len = 1, value = 0;
+    bool valid = true;
+    for (size_t c = 0; c < sizeof(addressCommands) / sizeof(char *); ++c) {
+        if (count >= 2 && strcmp(command, addressCommands[c]) == 0) {
+            valid = Chip8Console_number(words[1], 16, 0xFFF, &addr)
+                && (count < 3 || Chip8Console_number(words[2], 10,
+                            4096 - addr, &len));
+        }
+    }
+    if (!valid) {
+        fprintf(out, "Bad address or length\n");
+    } else if (strcmp(command, "q") == 0) {
+        return false;
+    } else if (strcmp(command, "h") == 0) {
+        Chip8Console_help(out);
+    } else if (strcmp(command, "c") == 0) {
+        long frames = CONTINUE_FRAMES;
+        if (count >= 2 && !Chip8Console_number(words[1], 10, 1L << 30,
+                    &frames)) {
+            fprintf(out, "Bad frame count\n");
+            return true;
+        }
+        Chip8Console_continue(proc, ipf, frames, out);
+    } else if (strcmp(command, "s") == 0) {
+        long steps = 1;
+        if (count >= 2 && !Chip8Console_number(words[1], 10, 1L << 30,
+                    &steps)) {
+            fprintf(out, "Bad step count\n");
+            return true;
+        }
+        Chip8Debug_resume(proc);
+        for (; steps > 0 && proc->waitKey < 0; --steps) {
+            if (!Chip8_advance(proc)) {
+                break;
+            }
+        }
+        Chip8Console_where(proc, out);
+    } else if (strcmp(command, "r") == 0) {
+        Chip8Console_registers(proc, out);
+    } else if (strcmp(command, "screen") == 0) {
+        Chip8Console_screen(proc, out);
+    } else if (strcmp(command, "l") == 0) {
+        Chip8Console_list(debug, out);
+    } else if (count < 2) {
+        fprintf(out, "Unknown command or missing operand; h for help\n");
+    } else if (strcmp(command, "b") == 0 || strcmp(command, "d") == 0) {
+        Chip8Debug_setBreak(debug, addr, command[0] == 'b');
+    } else if (strcmp(command, "w") == 0 || strcmp(command, "rw") == 0
+            || strcmp(command, "aw") == 0 || strcmp(command, "uw") == 0) {
+        int kinds = command[0] == 'w' ? CHIP8_WATCH_WRITE
+            : command[0] == 'r' ? CHIP8_WATCH_READ
+            : CHIP8_WATCH_READ | CHIP8_WATCH_WRITE;
+        Chip8Debug_setWatch(debug, addr, len, kinds, command[0] != 'u');
+    } else if (strcmp(command, "x") == 0) {
+        Chip8Console_dump(proc, addr, count >= 3 ? len : 16, out);
+    } else if (strcmp(command, "k") == 0 || strcmp(command, "ku") == 0) {
+        if (!Chip8Console_number(words[1], 16, 0xF, &value)) {
+            fprintf(out, "Keys are 0-F\n");
+            return true;
+        }
+        Chip8_keyEvent(proc, value, command[1] != 'u');
+    } else if (strcmp(command, "cond") == 0) {
+        int reg = count == 5 ? Chip8Console_register(words[2]) : -1,
+            cmp = count == 5 ? Chip8Console_compare(words[3]) : -1;
+        bool anywhere = strcmp(words[1], "*") == 0;
+        if (reg < 0 || cmp < 0
+                || !(anywhere || Chip8Console_number(words[1], 16, 0xFFF,
+                        &addr))
+                || !Chip8Console_number(words[4], 16, 0xFFFF, &value)) {
+            fprintf(out, "Usage: cond <addr|*> <reg> <op> <value>\n");
+            return true;
+        }
+        int index = Chip8Debug_addCondition(debug, anywhere ? -1 : addr,
+                reg, cmp, value);
+        if (index < 0) {
+            fprintf(out, "All %d conditions are in use\n",
+                    CHIP8_DEBUG_CONDITIONS);
+        } else {
+            fprintf(out, "Condition %d\n", index);
+        }
+    } else if (strcmp(command, "uncond") == 0) {
+        if (!Chip8Console_number(words[1], 10, CHIP8_DEBUG_CONDITIONS - 1,
+                    &value) || !Chip8Debug_removeCondition(debug, value)) {
+            fprintf(out, "No condition %s\n", words[1]);
+        }
+    } else {
+        fprintf(out, "Unknown command '%s'; h for help\n", command);
+    }
+    return true;
+}
+
+/*
+ * Run up to frames frames until the processor stops: a breakpoint,
+ * watchpoint or condition, a trap, or a wait for a key, which "k" can then
+ * press. Ctrl-C stops it between chunks of CONTINUE_CHUNK frames.
+ */
+static void Chip8Console_continue(Chip8Proc *proc, unsigned ipf,
+        long frames, FILE *out) {
+    Chip8Debug_resume(proc);
+    if (proc->waitKey >= 0) {
+        fprintf(out, "Waiting for a key in V%X; press one with k\n",
+                proc->waitKey);
+        return;
+    }
+    struct sigaction action = { .sa_handler = Chip8Console_interrupt },
+                     saved;
+    sigemptyset(&action.sa_mask);
+    interrupted = 0;
+    sigaction(SIGINT, &action, &saved);
+    uint64_t cycles = 0, ran = 0;
+    while (ran < (uint64_t) frames && !interrupted) {
+        uint64_t chunk = frames - ran < CONTINUE_CHUNK ? frames - ran
+            : CONTINUE_CHUNK;
+        Chip8RunConfig config = {
+            .ipf = ipf, .headless = true, .maxCycles = chunk * ipf
+        };
+        Chip8RunStats stats = Chip8_run(proc, &config);
+        cycles += stats.cycles;
+        ran += stats.frames;
+        if (proc->trap != CHIP8_TRAP_NONE || proc->waitKey >= 0) {
+            break;
+        }
+    }
+    sigaction(SIGINT, &saved, NULL);
+    fprintf(out, "%llu instructions, %llu frames\n",
+            (unsigned long long) cycles, (unsigned long long) ran);
+    if (interrupted) {
+        fprintf(out, "Interrupted; ");
+    } else if (proc->trap == CHIP8_TRAP_NONE && proc->waitKey < 0) {
+        fprintf(out, "Ran %ld frames; ", frames);
+    }
+    Chip8Console_where(proc, out);
+}
+
+static void Chip8Console_interrupt(int signal) {
+    (void) signal;
+    interrupted = 1;
+}
+
+/*
+ * Say where the processor is, and why it stopped if it has
+ */
+static void Chip8Console_where(const Chip8Proc *proc, FILE *out) {
+    const Chip8Debug *debug = proc->debug;
+    const Chip8DebugStop *stop = &debug->stop;
+    if (proc->trap == CHIP8_TRAP_BREAK) {
+        switch (stop->kind) {
+            case CHIP8_STOP_BREAKPOINT:
+                fprintf(out, "Breakpoint");
+                break;
+            case CHIP8_STOP_CONDITION: {
+                const Chip8Condition *condition =
+                    &debug->conditions[stop->index];
+                fprintf(out, "Condition %d, %s %s %X", stop->index,
+                        Chip8_registerName(condition->reg),
+                        compareNames[condition->cmp], condition->value);
+                break;
+            }
+            case CHIP8_STOP_READ:
+            case CHIP8_STOP_WRITE:
+                fprintf(out, "Watchpoint, %s %03X",
+                        stop->kind == CHIP8_STOP_READ ? "read" : "write",
+                        stop->addr);
+                break;
+            case CHIP8_STOP_NONE:
+                fprintf(out, "Stopped");
+                break;
+        }
+        fputs(", ", out);
+    } else if (proc->trap != CHIP8_TRAP_NONE) {
+        fprintf(out, "Trapped: %s, ", Chip8_trapName(proc->trap));
+    } else if (proc->waitKey >= 0) {
+        fprintf(out, "Waiting for a key in V%X, ", proc->waitKey);
+    }
+    uint16_t pc = proc->PC;
+    if (pc <= 0xFFE) {
+        fprintf(out, "PC %03X: %02X%02X\n", pc, proc->ram[pc],
+                proc->ram[pc + 1]);
+    } else {
+        fprintf(out, "PC %03X outside of ram\n", pc);
+    }
+}
+
+static void Chip8Console_registers(const Chip8Proc *proc, FILE *out) {
+    for (int r = 0; r < 16; ++r) {
+        fprintf(out, "V%X %02X%c", r, proc->V[r], r % 8 == 7 ? '\n' : ' ');
+    }
+    fprintf(out, "I %03X  D %02X  S %02X  PC %03X  SC %d  keys %04X  "
+            "cycles %llu\n", proc->I, proc->D, proc->S, proc->PC, proc->SC,
+            proc->keys, (unsigned long long) proc->cycles);
+    for (int s = proc->SC; s >= 0; --s) {
+        fprintf(out, "  #%d returns to %03X\n", s, proc->stack[s] + 2);
+    }
+}
+
+/*
+ * Hex dump of len bytes of ram from addr, 16 to a line
+ */
+static void Chip8Console_dump(const Chip8Proc *proc, int addr, int len,
+        FILE *out) {
+    for (int a = addr; a < addr + len && a < 4096; ++a) {
+        if ((a - addr) % 16 == 0) {
+            fprintf(out, "%s%03X:", a == addr ? "" : "\n", a);
+        }
+        fprintf(out, " %02X", proc->ram[a]);
+    }
+    fputc('\n', out);
+}
+
+/*
+ * The framebuffer in half blocks, two rows to a line
+ */
+static void Chip8Console_screen(const Chip8Proc *proc, FILE *out) {
+    static const char *cells[] = { " ", "▄", "▀", "█" };
+    for (int row = 0; row < 64; row += 2) {
+        for (int col = 0; col < 128; ++col) {
+            uint64_t bit = 1ULL << (63 - col % 64);
+            int top = (proc->screen[row][col / 64] & bit) != 0,
+                bottom = (proc->screen[row + 1][col / 64] & bit) != 0;
+            fputs(cells[top << 1 | bottom], out);
+        }
+        fputc('\n', out);
+    }
+}
+
+/*
+ * Everything armed, with addresses in runs
+ */
+static void Chip8Console_list(const Chip8Debug *debug, FILE *out) {
+    static const char *labels[] = { "Breakpoints", "Read watches",
+        "Write watches" };
+    const uint64_t *sets[] = { debug->breakAt, debug->watchRead,
+        debug->watchWrite };
+    for (int s = 0; s < 3; ++s) {
+        fprintf(out, "%s:", labels[s]);
+        for (int a = 0; a < 4096; ++a) {
+            if (!(sets[s][a / 64] >> a % 64 & 1)) {
+                continue;
+            }
+            int end = a;
+            while (end + 1 < 4096
+                    && sets[s][(end + 1) / 64] >> (end + 1) % 64 & 1) {
+                ++end;
+            }
+            if (end == a) {
+                fprintf(out, " %03X", a);
+            } else {
+                fprintf(out, " %03X-%03X", a, end);
+            }
+            a = end;
+        }
+        fputc('\n', out);
+    }
+    for (int c = 0; c < CHIP8_DEBUG_CONDITIONS; ++c) {
+        const Chip8Condition *condition = &debug->conditions[c];
+        if (!condition->used) {
+            continue;
+        }
+        fprintf(out, "Condition %d: %s %s %X", c,
+                Chip8_registerName(condition->reg),
+                compareNames[condition->cmp], condition->value);
+        if (condition->addr >= 0) {
+            fprintf(out, " at %03X", condition->addr);
+        }
+        fputc('\n', out);
+    }
+}
+
+static void Chip8Console_help(FILE *out) {
+    fputs("Addresses, keys and values are hex; lengths and counts decimal.\n"
+            "  c [N]                    continue until something stops it,\n"
+            "                           for N frames at most (default 3600)\n"
+            "  s [N]                    step N instructions (default 1)\n"
+            "  b ADDR / d ADDR          set / delete a breakpoint\n"
+            "  w ADDR [LEN]             stop before writes to ram\n"
+            "  rw ADDR [LEN]            stop before reads of ram\n"
+            "  aw ADDR [LEN]            stop before either\n"
+            "  uw ADDR [LEN]            stop watching\n"
+            "  cond ADDR|* REG OP VAL   stop when, e.g., cond * V3 == 1F\n"
+            "  uncond N                 delete condition N\n"
+            "  l                        list what is armed\n"
+            "  r                        show the registers and stack\n"
+            "  x ADDR [LEN]             dump ram (default 16 bytes)\n"
+            "  screen                   show the framebuffer\n"
+            "  k KEY / ku KEY           press / release a key\n"
+            "  q                        quit\n", out);
+}
+
+/*
+ * Parse a whole word as a number in base from 0 to max
+ */
+static bool Chip8Console_number(const char *word, int base, long max,
+        long *value) {
+    char *end;
+    *value = strtol(word, &end, base);
+    return end != word && *end == '\0' && *value >= 0 && *value <= max;
+}
+
+/*
+ * Register named by word, such as "V3", "vf", "I" or "SC", -1 for none
+ */
+static int Chip8Console_register(const char *word) {
+    for (int reg = 0; reg <= CHIP8_REG_SC; ++reg) {
+        if (strcasecmp(word, Chip8_registerName(reg)) == 0) {
+            return reg;
+        }
+    }
+    return -1;
+}
+
+static int Chip8Console_compare(const char *word) {
+    for (int cmp = CHIP8_CMP_EQ; cmp <= CHIP8_CMP_GE; ++cmp) {
+        if (strcmp(word, compareNames[cmp]) == 0) {
+            return cmp;
+        }
+    }
+    return -1;
+}
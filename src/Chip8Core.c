@@ -1,49 +1,185 @@
-#include <stdio.h>    
+#include <stddef.h>
 #include <string.h>
-#include <time.h>
 
+#include "Chip8Aot.h"
 #include "Chip8Core.h"
+#include "Chip8Debug.h"
+#include "Chip8Jit.h"
+#include "Chip8Profile.h"
+#include "Chip8Trace.h"
 #include "Guards.h"
 
-#define FONT_5_START  0x000
+#define FONT_5_START  CHIP8_FONT_5_START
 #define FONT_10_START 0x080
 #define PROG_START    0x200
 
-static bool Chip8_drawByte_LS(Chip8Proc *self, int row, int col, uint8_t data);
+// Handler indices stored in Chip8Decoded.op
+enum {
+    OP_DECODE = 0, OP_INVALID, OP_CLS, OP_RET, OP_SCD, OP_SCR, OP_SCL,
+    OP_EXIT, OP_LOW, OP_HIGH, OP_JP, OP_CALL, OP_SE_NN, OP_SNE_NN,
+    OP_SE_XY, OP_LD_NN, OP_ADD_NN, OP_LD_XY, OP_OR, OP_AND, OP_XOR,
+    OP_ADD_XY, OP_SUB, OP_SHR, OP_SUBN, OP_SHL, OP_SNE_XY, OP_LD_I,
+    OP_JP_V0, OP_RND, OP_DRW, OP_LD_X_DT, OP_LD_DT, OP_ADD_I, OP_LD_F,
+    OP_LD_HF, OP_BCD, OP_STORE, OP_LOAD, OP_SAVE_FLAGS, OP_LOAD_FLAGS,
+    OP_SKP, OP_SKNP, OP_LD_K, OP_LD_ST, OP_COUNT
+};
+
+static bool Chip8_interpret(Chip8Proc *self);
+static bool Chip8_executeSampled(Chip8Proc *self, uint64_t budget);
+static bool Chip8_dispatch(Chip8Proc *self, uint64_t budget);
+static bool Chip8_threadedChip8Lores(Chip8Proc *self, uint64_t *budget);
+static bool Chip8_threadedChip8Hires(Chip8Proc *self, uint64_t *budget);
+static bool Chip8_threadedSuperLores(Chip8Proc *self, uint64_t *budget);
+static bool Chip8_threadedSuperHires(Chip8Proc *self, uint64_t *budget);
+static Chip8Decoded Chip8_decode(uint8_t op12, uint8_t op34);
+static bool Chip8_trap(Chip8Proc *self, Chip8Trap trap);
+static inline uint8_t Chip8_random(Chip8Proc *self);
+static bool Chip8_inRam(uint16_t addr, int len);
+static bool Chip8_draw(Chip8Proc *self, int x0, int y0, uint8_t n);
+static bool Chip8_drawLores(Chip8Proc *self, int x0, int y0, uint8_t n);
+static bool Chip8_drawHires(Chip8Proc *self, int x0, int y0, uint8_t n);
+static void Chip8_clear(Chip8Proc *self);
+static void Chip8_setSoundTimer(Chip8Proc *self, uint8_t value);
+static uint16_t Chip8_fetch(const Chip8Proc *self, uint16_t addr);
+static uint64_t Chip8_litRows(const Chip8Proc *self);
+static void Chip8_scrollDown(Chip8Proc *self, uint8_t n);
+static void Chip8_scrollRight(Chip8Proc *self);
+static void Chip8_scrollLeft(Chip8Proc *self);
+static void Chip8_rowMask(uint16_t data, int width, int col, uint64_t mask[2]);
+static bool Chip8_blitRow(Chip8Proc *self, int row, const uint64_t mask[2]);
+static uint16_t Chip8_doubleBits(uint8_t data);
 static uint8_t font5[80], font10[100];
 
-Chip8Proc Chip8_init(uint8_t *program,
+// Threaded interpreter variants (see Chip8Threaded.inc), indexed by
+// superMode and largeScreen
+static bool (*const variants[2][2])(Chip8Proc *self, uint64_t *budget) = {
+    { Chip8_threadedChip8Lores, Chip8_threadedChip8Hires },
+    { Chip8_threadedSuperLores, Chip8_threadedSuperHires }
+};
+
+Chip8Proc Chip8_init(const uint8_t *program,
         size_t progSize,
-        void (*sendScreen)(bool *screen),
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
         void (*setSound)(bool isPlaying, Chip8Proc *self),
         bool superMode) {
-    // Init the new Chip8Proc
-    Chip8Proc proc = {
-        .SC = -1,
-        .sendScreen = sendScreen,
-        .setSound = setSound,
-        .superMode = superMode
-    };
-    // Init the proc's ram
-    memset(proc.ram, 0, 4096);
-    memcpy(proc.ram + FONT_5_START, font5, sizeof(font5));
-    memcpy(proc.ram + FONT_10_START, font10, sizeof(font10));
-    memcpy(proc.ram + PROG_START, program, progSize);
-    proc.PC = 0x200;
-    // Init the screen buffer
-    memset(proc.screen, 0, 64 * 128);
-    // Seed random number generator
-    srand((unsigned int) time(NULL));
+    Chip8Proc proc;
+    Chip8_initAt(&proc, program, progSize, presentFrame, setSound,
+            superMode);
     return proc;
 }
 
+void Chip8_initAt(Chip8Proc *self,
+        const uint8_t *program,
+        size_t progSize,
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
+        void (*setSound)(bool isPlaying, Chip8Proc *self),
+        bool superMode) {
+    // Registers, ram, screen and predecode cache all start zeroed, and
+    // nothing is attached
+    memset(self, 0, sizeof(*self));
+    self->SC = -1;
+    self->presentFrame = presentFrame;
+    self->setSound = setSound;
+    self->superMode = superMode;
+    // Init the proc's ram
+    memcpy(self->ram + FONT_5_START, font5, sizeof(font5));
+    memcpy(self->ram + FONT_10_START, font10, sizeof(font10));
+    if (progSize > CHIP8_MAX_ROM_SIZE) {
+        progSize = CHIP8_MAX_ROM_SIZE;
+    }
+    if (progSize > 0) {
+        memcpy(self->ram + PROG_START, program, progSize);
+    }
+    self->PC = 0x200;
+    // Nothing has been decoded yet
+    self->decodedLow = 4096;
+    self->decodedHigh = 0;
+    Chip8_seed(self, CHIP8_DEFAULT_SEED);
+    self->waitKey = -1;
+}
+
+void Chip8_reset(Chip8Proc *self, const Chip8Proc *fresh,
+        const uint8_t *program, size_t progSize) {
+    // Registers, counters, modes and trap state come before ram
+    memcpy(self, fresh, offsetof(Chip8Proc, ram));
+    memcpy(self->ram, fresh->ram, PROG_START);
+    if (progSize > CHIP8_MAX_ROM_SIZE) {
+        progSize = CHIP8_MAX_ROM_SIZE;
+    }
+    memcpy(self->ram + PROG_START, program, progSize);
+    memset(self->ram + PROG_START + progSize, 0,
+            sizeof(self->ram) - PROG_START - progSize);
+    memset(self->screen, 0, sizeof(self->screen));
+    if (self->decodedLow < self->decodedHigh) {
+        memset(self->decoded + self->decodedLow, 0,
+                (self->decodedHigh - self->decodedLow) * sizeof(Chip8Decoded));
+    }
+    self->decodedLow = 4096;
+    self->decodedHigh = 0;
+
+    // The callbacks, and everything after them; of the attachments before
+    // them, translated code, a debugger and a profile stay
+    memcpy(&self->presentFrame, &fresh->presentFrame,
+            sizeof(Chip8Proc) - offsetof(Chip8Proc, presentFrame));
+    self->aot = NULL;
+    self->trace = NULL;
+    if (self->jit != NULL) {
+        Chip8Jit_invalidate(self, 0, sizeof(self->ram));
+    }
+}
+
+void Chip8_seed(Chip8Proc *self, uint32_t seed) {
+    // Scramble the seed (murmur3's finalizer) so that nearby seeds give
+    // unrelated sequences; xorshift never leaves a state of 0
+    seed ^= seed >> 16;
+    seed *= 0x85EBCA6Bu;
+    seed ^= seed >> 13;
+    seed *= 0xC2B2AE35u;
+    seed ^= seed >> 16;
+    self->randState = seed != 0 ? seed : 1;
+}
+
 bool Chip8_advance(Chip8Proc *self) {
+    // Stop before an instruction at a breakpoint or meeting a condition
+    if (self->debug != NULL && Chip8Debug_stops(self)) {
+        return Chip8_trap(self, CHIP8_TRAP_BREAK);
+    }
+#ifdef CHIP8_PROFILE
+    if (self->profile != NULL && self->PC <= 0xFFE) {
+        uint16_t pc = self->PC,
+                 opcode = self->ram[pc] << 8 | self->ram[pc + 1];
+        uint64_t start = Chip8Profile_ticks();
+        bool running = Chip8_interpret(self);
+        Chip8Profile_record(self->profile, self, pc, opcode,
+                Chip8Profile_ticks() - start);
+        return running;
+    }
+#endif
+    return Chip8_interpret(self);
+}
+
+/*
+ * Chip8_advance without the profiler
+ */
+static bool Chip8_interpret(Chip8Proc *self) {
 
     // NOTE: see https://github.com/Chromatophore/HP48-Superchip for
     // differences between CHIP-8 and SUPERCHIP-48
 
     bool normInc = true, validInst = false;
 
+    // A trapped processor stays stopped until its trap is cleared, and a
+    // waiting one until a key is pressed
+    if (self->trap != CHIP8_TRAP_NONE) {
+        return false;
+    }
+    if (self->waitKey >= 0) {
+        return true;
+    }
+    if (self->PC > 0xFFE) {
+        return Chip8_trap(self, CHIP8_TRAP_BAD_PC);
+    }
+
     // Get instruction broken into nibbles
     uint8_t op12 = self->ram[self->PC], op34 = self->ram[self->PC + 1];
     uint8_t op1 = op12 >> 4,
@@ -61,67 +197,34 @@ bool Chip8_advance(Chip8Proc *self) {
             if (op3 == 0xC) { // 00Cn: Scroll display n lines down
                 validInst = true;
                 if (!self->largeScreen && op4 % 2 != 0) {
-                    fprintf(stderr, "%03X - Aborting - Attempted to scroll "
-                            "by an odd number of pixels in lores mode\n",
-                            self->PC);
-                    exit(EXIT_FAILURE);
+                    return Chip8_trap(self, CHIP8_TRAP_ODD_SCROLL);
                 }
-                // Move data
-                memmove(self->screen + op4 * 128,
-                        self->screen,
-                        128 * (64 - op4));
-                // Clear moved space
-                memset(self->screen, 0, op4 * 128);
-                // Send new framebuffer
-                self->sendScreen(self->screen);
+                Chip8_scrollDown(self, op4);
                 break;
             }
             switch (op34) {
                 case 0xE0: // 00E0: Clear the screen
                     validInst = true;
-                    for (int c = 0; c < 128; ++c) {
-                        for (int r = 0; r < 64; ++r) {
-                            self->screen[r * 128 + c] = false;
-                        }
-                    }
+                    Chip8_clear(self);
                     break;
                 case 0xEE: // 00EE: Return from subroutine
                     validInst = true;
                     if (self->SC >= 0) {
                         self->PC = self->stack[self->SC--];
                     } else {
-                        fprintf(stderr, "%03X - Aborting - Attempted to "
-                                "leave subroutine with empty stack\n",
-                                self->PC);
-                        exit(EXIT_FAILURE);
+                        return Chip8_trap(self, CHIP8_TRAP_STACK_UNDERFLOW);
                     }
                     break;
                 case 0xFB: // 00FB: Scroll 4 small pixels right
                     validInst = true;
-                    // Scroll each line
-                    for (int r = 0; r < 64; ++r) {
-                        memmove(self->screen + 128 * r + 4,
-                                self->screen + 128 * r,
-                                124);
-                        memset(self->screen + 128 * r, 0, 4);
-                    }
-                    // Send new framebuffer
-                    self->sendScreen(self->screen);
+                    Chip8_scrollRight(self);
                     break;
                 case 0xFC: // 00FC: Scroll 4 small pixels left
                     validInst = true;
-                    // Scroll each line
-                    for (int r = 0; r < 64; ++r) {
-                        memmove(self->screen + 128 * r,
-                                self->screen + 128 * r + 4,
-                                124);
-                        memset(self->screen + 128 * r + 124, 0, 4);
-                    }
-                    // Send new framebuffer
-                    self->sendScreen(self->screen);
+                    Chip8_scrollLeft(self);
                     break;
                 case 0xFD: // 00FD: Exit interpreter
-                    return false;
+                    return Chip8_trap(self, CHIP8_TRAP_EXIT);
                 case 0xFE: // 00FE: Switch to lores
                     validInst = true;
                     self->largeScreen = false;
@@ -139,13 +242,13 @@ bool Chip8_advance(Chip8Proc *self) {
             break;
         case 0x2: // 2nnn: Call subroutine at address nnn
             validInst = true;
-            if (self->SC++ < 15) {
-                self->stack[self->SC] = self->PC;
+            // A full stack traps with SC left at 15
+            if (self->SC < 15) {
+                self->stack[++self->SC] = self->PC;
                 self->PC = op2 << 8 | op34;
                 normInc = false;
             } else {
-                fprintf(stderr, "%03X - Aborting - Stack overflow\n", self->PC);
-                exit(EXIT_FAILURE);
+                return Chip8_trap(self, CHIP8_TRAP_STACK_OVERFLOW);
             }
             break;
         case 0x3: // 3xnn: Skip next instruction if Vx == nn
@@ -253,68 +356,33 @@ bool Chip8_advance(Chip8Proc *self) {
             break;
         case 0xC: // Cxnn: Set Vx to rand & nn
             validInst = true;
-            self->V[op2] = rand() & op34;
+            self->V[op2] = Chip8_random(self) & op34;
             break;
-        case 0xD:
-            ; // Empty expression required cuz labels are stupid in C
-            int x0 = self->V[op2], y0 = self->V[op3];
-            if (op4 == 0x0) { // Dxy0: 16x16 draw in largeScreen, draw nothing otherwise
-                // Does NOT replicate Super collision line count
-                // Vf is set to 1 if there is a collision, 0 otherwise
-                self->V[0xF] = false;
-                validInst = true;
-                if (self->largeScreen) {
-                    for (int i = 0; i < 16; ++i) {
-                        if (Chip8_drawByte_LS(self, y0 + i, x0,
-                                    self->ram[self->I + 2 * i])
-                                || Chip8_drawByte_LS(self, y0 + i, x0 + 8,
-                                    self->ram[self->I + 2 * i + 1])) {
-                            self->V[0xF] = true;
-                        }
-                    }
-                } else {
-                    break;
-                }
-            } else { // Dxyn: Draw n-row sprite from ram(I) at (Vx, Vy)
-                // Vf is set to 1 if there is a collision, 0 otherwise
-                self->V[0xF] = false;
-                validInst = true;
-                for (uint8_t r = 0; r < op4; ++r) {
-                    uint8_t rowVal = self->ram[self->I + r];
-                    if (self->largeScreen) {
-                        Chip8_drawByte_LS(self, r + y0, x0, rowVal);
-                    } else {
-                        uint8_t mask = 0x80;
-                        for (uint8_t c = 0; c < 8; ++c, mask >>= 1) {
-                            if (rowVal & mask) {
-                                int row = 2 * (r + y0) % 64,
-                                    col = 2 * (c + x0) % 128;
-                                bool curState = self->screen[row * 128 + col];
-                                if (curState) {
-                                    // If pixel is already on, set flag for collision
-                                    self->V[0xF] = true;
-                                }
-                                self->screen[row * 128 + col] = !curState;
-                                self->screen[(row + 1) * 128 + col] = !curState;
-                                self->screen[row * 128 + col + 1] = !curState;
-                                self->screen[(row + 1) * 128 + col + 1] = !curState;
-                            }
-                        }
-                    }
-                }
+        case 0xD: // Dxyn: Draw n-row sprite from ram(I) at (Vx, Vy)
+            // Dxy0: 16x16 draw in largeScreen, draw nothing otherwise
+            validInst = true;
+            if (self->debug != NULL && Chip8Debug_watches(self, self->I,
+                        op4 != 0 ? op4 : self->largeScreen ? 32 : 0,
+                        CHIP8_WATCH_READ)) {
+                return Chip8_trap(self, CHIP8_TRAP_BREAK);
+            }
+            if (!Chip8_draw(self, self->V[op2], self->V[op3], op4)) {
+                return Chip8_trap(self, CHIP8_TRAP_BAD_ADDRESS);
             }
-            // Send new framebuffer
-            self->sendScreen(self->screen);
             break;
         case 0xE:
             switch (op34) {
-                case 0x9E: // Ex9E: Skip next instruction if key Vx is not pressed
-                    // validInst = true;
-                    // TODO Ex9E
+                case 0x9E: // Ex9E: Skip next instruction if key Vx is pressed
+                    validInst = true;
+                    if (self->keys >> (self->V[op2] & 0xF) & 1) {
+                        self->PC += 2;
+                    }
                     break;
-                case 0xA1: // ExA1: Skip next instruction if key Vx is pressed
-                    // validInst = true;
-                    // TODO ExA1
+                case 0xA1: // ExA1: Skip next instruction if key Vx is not pressed
+                    validInst = true;
+                    if (!(self->keys >> (self->V[op2] & 0xF) & 1)) {
+                        self->PC += 2;
+                    }
                     break;
             }
             break;
@@ -325,16 +393,17 @@ bool Chip8_advance(Chip8Proc *self) {
                     self->V[op2] = self->D;
                     break;
                 case 0x0A: // Fx0A: Wait for keypress, then set Vx to key
-                    // validInst = true;
-                    // TODO Fx0A
+                    validInst = true;
+                    // Retires now; Chip8_keyEvent sets Vx and resumes
+                    self->waitKey = op2;
                     break;
                 case 0x15: // Fx15: Set D to Vx
                     validInst = true;
                     self->D = self->V[op2];
                     break;
-                case 0x18: // Fx18: Set S to Vx, call setSound(true, self)
-                    // validInst = true;
-                    // TODO Fx18
+                case 0x18: // Fx18: Set S to Vx, buzzing while it is nonzero
+                    validInst = true;
+                    Chip8_setSoundTimer(self, self->V[op2]);
                     break;
                 case 0x1E: // Fx1E: Set I to I + Vx, Super has an (ignored) quirk
                     validInst = true;
@@ -347,34 +416,55 @@ bool Chip8_advance(Chip8Proc *self) {
                 case 0x30: // Fx30: Point I to 10-wide sprite for the num char in Vx
                     validInst = true;
                     if (self->V[op2] % 16 > 0x9) {
-                        fprintf(stderr, "%03X - Aborting - Large sprites are only "
-                                "available for characters 0-9\n", self->PC);
-                        exit(EXIT_FAILURE);
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_FONT_CHAR);
                     }
                     self->I = FONT_10_START + 10 * (self->V[op2] % 16);
                     break;
                 case 0x33: // Fx33: Set I, I+1, I+2 to the decimal digits of Vx
                     validInst = true;
+                    if (!Chip8_inRam(self->I, 3)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_ADDRESS);
+                    }
+                    if (self->debug != NULL && Chip8Debug_watches(self,
+                                self->I, 3, CHIP8_WATCH_WRITE)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BREAK);
+                    }
                     int val = self->V[op2];
                     self->ram[self->I] = val / 100;
                     val %= 100;
                     self->ram[self->I + 1] = val / 10;
                     val %= 10;
                     self->ram[self->I + 2] = val;
+                    Chip8_invalidate(self, self->I, 3);
                     break;
                 case 0x55: // Fx55: Store V0...Vx to ram starting at I
                     // When not in superMode, I will be incremented
                     // In superMode, I stays constant
                     validInst = true;
+                    if (!Chip8_inRam(self->I, op2)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_ADDRESS);
+                    }
+                    if (self->debug != NULL && Chip8Debug_watches(self,
+                                self->I, op2, CHIP8_WATCH_WRITE)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BREAK);
+                    }
                     for (int i = 0; i < op2; ++i) {
                         self->ram[self->I + i] = self->V[i];
                     }
+                    Chip8_invalidate(self, self->I, op2);
                     if (!self->superMode) { self->I += op2; }
                     break;
                 case 0x65: // Fx65: Read V0...Vx from ram starting at I
                     // When not in superMode, I will be incremented
                     // In superMode, I stays constant
                     validInst = true;
+                    if (!Chip8_inRam(self->I, op2)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_ADDRESS);
+                    }
+                    if (self->debug != NULL && Chip8Debug_watches(self,
+                                self->I, op2, CHIP8_WATCH_READ)) {
+                        return Chip8_trap(self, CHIP8_TRAP_BREAK);
+                    }
                     for (int i = 0; i < op2; ++i) {
                         self->V[i] = self->ram[self->I + i];
                     }
@@ -383,9 +473,7 @@ bool Chip8_advance(Chip8Proc *self) {
                 case 0x75: // Fx75: Store V0...Vx to flag registers (x < 8, Super only)
                     validInst = true;
                     if (op2 > 7) {
-                        fprintf(stderr, "%03X - Aborting - Fx75 can only store up to V7\n",
-                                self->PC);
-                        exit(EXIT_FAILURE);
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_FLAG_REG);
                     }
                     for (int i = 0; i < op2; ++i) {
                         self->V[i] = self->FR[i];
@@ -394,9 +482,7 @@ bool Chip8_advance(Chip8Proc *self) {
                 case 0x85: // Fx85: Read V0...Vx from flag registers (x < 8, Super only)
                     validInst = true;
                     if (op2 > 7) {
-                        fprintf(stderr, "%03X - Aborting - Fx85 can only read up to V7\n",
-                                self->PC);
-                        exit(EXIT_FAILURE);
+                        return Chip8_trap(self, CHIP8_TRAP_BAD_FLAG_REG);
                     }
                     for (int i = 0; i < op2; ++i) {
                         self->V[i] = self->FR[i];
@@ -408,28 +494,501 @@ bool Chip8_advance(Chip8Proc *self) {
 
     // Throw error if invalid instruction
     if (!validInst) {
-        fprintf(stderr, "%03X - Aborting - Invalid opcode %02X%02X\n",
-                self->PC, op12, op34);
-        exit(EXIT_FAILURE);
+        return Chip8_trap(self, CHIP8_TRAP_INVALID_OPCODE);
     }
 
     // Inc PC if neccessary
     if (normInc) { self->PC += 2; }
+    ++self->cycles;
 
     // Return true to indicate processor is still running
     return true;
 }
 
-static bool Chip8_drawByte_LS(Chip8Proc *self, int row, int col, uint8_t data) {
-    bool anyInverts = false;
-    for (uint8_t mask = 0x80; mask != 0; mask >>= 1, col++) {
-        if (data & mask) {
-            bool *pixel = &self->screen[128 * (row % 64) + (col % 128)];
-            *pixel = !*pixel;
-            if (!*pixel) { anyInverts = true; }
+Chip8Trap Chip8_step(Chip8Proc *self) {
+    Chip8_advance(self);
+    return self->trap;
+}
+
+const char *Chip8_trapName(Chip8Trap trap) {
+    switch (trap) {
+        case CHIP8_TRAP_NONE: return "none";
+        case CHIP8_TRAP_EXIT: return "exit";
+        case CHIP8_TRAP_INVALID_OPCODE: return "invalid opcode";
+        case CHIP8_TRAP_STACK_OVERFLOW: return "stack overflow";
+        case CHIP8_TRAP_STACK_UNDERFLOW:
+            return "attempted to leave subroutine with empty stack";
+        case CHIP8_TRAP_ODD_SCROLL:
+            return "attempted to scroll by an odd number of pixels in lores mode";
+        case CHIP8_TRAP_BAD_FONT_CHAR:
+            return "large sprites are only available for characters 0-9";
+        case CHIP8_TRAP_BAD_FLAG_REG: return "only V0-V7 have flag registers";
+        case CHIP8_TRAP_BAD_PC: return "PC outside of ram";
+        case CHIP8_TRAP_BAD_ADDRESS: return "memory access past the end of ram";
+        case CHIP8_TRAP_BREAK: return "stopped by the debugger";
+    }
+    return "unknown";
+}
+
+bool Chip8_execute(Chip8Proc *self, uint64_t budget) {
+    if (self->trace != NULL && self->trace->period != 0) {
+        return Chip8_executeSampled(self, budget);
+    }
+    return Chip8_dispatch(self, budget);
+}
+
+/*
+ * Chip8_execute in runs that end where each sample of the trace is due
+ */
+static bool Chip8_executeSampled(Chip8Proc *self, uint64_t budget) {
+    uint64_t end = self->cycles + budget;
+    bool running = true;
+    while (running && self->cycles < end && self->waitKey < 0) {
+        Chip8Trace_sample(self->trace, self);
+        uint64_t stop = self->trace->nextSample < end
+            ? self->trace->nextSample : end;
+        running = Chip8_dispatch(self, stop - self->cycles);
+    }
+    return running;
+}
+
+/*
+ * Chip8_execute on whichever engine fits the processor
+ */
+static bool Chip8_dispatch(Chip8Proc *self, uint64_t budget) {
+    if (self->trap != CHIP8_TRAP_NONE) {
+        return false;
+    }
+    if (self->waitKey >= 0) {
+        return true;
+    }
+    if (self->referenceMode || CHIP8_PROFILING(self)
+            || CHIP8_DEBUGGING(self)) {
+        for (; budget > 0 && self->waitKey < 0; --budget) {
+            if (!Chip8_advance(self)) { return false; }
         }
+        return true;
+    }
+    // A processor spinning in an idle loop uses up the budget at once
+    if (Chip8_skipIdle(self, budget)) {
+        self->cycles += budget;
+        return true;
+    }
+    if (self->aot != NULL) {
+        return Chip8Aot_execute(self, budget);
+    }
+    if (self->jit != NULL) {
+        return Chip8Jit_execute(self, budget);
+    }
+    return Chip8_executeThreaded(self, budget);
+}
+
+bool Chip8_executeThreaded(Chip8Proc *self, uint64_t budget) {
+    // Each variant runs until the budget is used up or the screen mode
+    // changes, when the one for the new mode carries on
+    bool running;
+    do {
+        running = variants[self->superMode][self->largeScreen](self, &budget);
+    } while (running && budget > 0 && self->waitKey < 0);
+    return running;
+}
+
+/*
+ * The threaded interpreter, specialised for each quirk profile so that no
+ * handler tests a mode at run time
+ */
+#define VARIANT_NAME Chip8_threadedChip8Lores
+#define VARIANT_SUPER false
+#define VARIANT_LARGE false
+#include "Chip8Threaded.inc"
+
+#define VARIANT_NAME Chip8_threadedChip8Hires
+#define VARIANT_SUPER false
+#define VARIANT_LARGE true
+#include "Chip8Threaded.inc"
+
+#define VARIANT_NAME Chip8_threadedSuperLores
+#define VARIANT_SUPER true
+#define VARIANT_LARGE false
+#include "Chip8Threaded.inc"
+
+#define VARIANT_NAME Chip8_threadedSuperHires
+#define VARIANT_SUPER true
+#define VARIANT_LARGE true
+#include "Chip8Threaded.inc"
+
+bool Chip8_skipIdle(Chip8Proc *self, uint64_t budget) {
+    uint16_t pc = self->PC,
+             op = Chip8_fetch(self, pc),
+             jumpBack = 0x1000 | pc;
+    uint8_t x = op >> 8 & 0xF;
+    if (budget == 0 || self->waitKey >= 0) {
+        return false;
+    }
+    if (op == jumpBack) {
+        // 1nnn to itself
+    } else if ((op & 0xF0FF) == 0xF007 && self->D != 0
+            && Chip8_fetch(self, pc + 2) == (0x3000 | x << 8)
+            && Chip8_fetch(self, pc + 4) == jumpBack) {
+        // Fx07, 3x00, 1nnn back: spins until the delay timer reaches 0
+        self->V[x] = self->D;
+        self->PC = pc + 2 * (budget % 3);
+    } else if (((op & 0xF0FF) == 0xE09E || (op & 0xF0FF) == 0xE0A1)
+            && Chip8_fetch(self, pc + 2) == jumpBack) {
+        // Ex9E or ExA1, 1nnn back: spins until key Vx is pressed (9E) or
+        // released (A1)
+        bool pressed = self->keys >> (self->V[x] & 0xF) & 1;
+        if (pressed != ((op & 0xFF) == 0xA1)) {
+            return false;
+        }
+        self->PC = pc + 2 * (budget % 2);
+    } else {
+        return false;
+    }
+    self->idleCycles += budget;
+    return true;
+}
+
+void Chip8_keyEvent(Chip8Proc *self, uint8_t key, bool pressed) {
+    key &= 0xF;
+    if (self->trace != NULL) {
+        Chip8Trace_key(self->trace, self->cycles, key, pressed);
     }
-    return anyInverts;
+    if (!pressed) {
+        self->keys &= ~(1 << key);
+        return;
+    }
+    self->keys |= 1 << key;
+    if (self->waitKey >= 0) {
+        self->V[self->waitKey] = key;
+        self->waitKey = -1;
+    }
+}
+
+void Chip8_present(Chip8Proc *self) {
+    if (self->dirtyRows != 0 && self->presentFrame != NULL) {
+        self->presentFrame(self->screen, self->dirtyRows);
+    }
+    self->dirtyRows = 0;
+}
+
+/*
+ * Decode one instruction into its handler index and operands
+ */
+static Chip8Decoded Chip8_decode(uint8_t op12, uint8_t op34) {
+    static const uint8_t aluOps[16] = {
+        OP_LD_XY, OP_OR, OP_AND, OP_XOR, OP_ADD_XY, OP_SUB, OP_SHR, OP_SUBN,
+        [0xE] = OP_SHL
+    };
+    uint8_t op1 = op12 >> 4, op4 = op34 & 0x0F;
+    Chip8Decoded d = {
+        .op = OP_INVALID,
+        .x = op12 & 0x0F,
+        .y = op34 >> 4,
+        .nn = op34
+    };
+    switch (op1) {
+        case 0x0:
+            if (op12 != 0x00) {
+                break;
+            }
+            if (d.y == 0xC) {
+                d.op = OP_SCD;
+                break;
+            }
+            switch (op34) {
+                case 0xE0: d.op = OP_CLS; break;
+                case 0xEE: d.op = OP_RET; break;
+                case 0xFB: d.op = OP_SCR; break;
+                case 0xFC: d.op = OP_SCL; break;
+                case 0xFD: d.op = OP_EXIT; break;
+                case 0xFE: d.op = OP_LOW; break;
+                case 0xFF: d.op = OP_HIGH; break;
+            }
+            break;
+        case 0x1: d.op = OP_JP; break;
+        case 0x2: d.op = OP_CALL; break;
+        case 0x3: d.op = OP_SE_NN; break;
+        case 0x4: d.op = OP_SNE_NN; break;
+        case 0x5: if (op4 == 0x0) { d.op = OP_SE_XY; } break;
+        case 0x6: d.op = OP_LD_NN; break;
+        case 0x7: d.op = OP_ADD_NN; break;
+        case 0x8: if (aluOps[op4]) { d.op = aluOps[op4]; } break;
+        case 0x9: if (op4 == 0x0) { d.op = OP_SNE_XY; } break;
+        case 0xA: d.op = OP_LD_I; break;
+        case 0xB: d.op = OP_JP_V0; break;
+        case 0xC: d.op = OP_RND; break;
+        case 0xD: d.op = OP_DRW; break;
+        case 0xE:
+            switch (op34) {
+                case 0x9E: d.op = OP_SKP; break;
+                case 0xA1: d.op = OP_SKNP; break;
+            }
+            break;
+        case 0xF:
+            switch (op34) {
+                case 0x07: d.op = OP_LD_X_DT; break;
+                case 0x0A: d.op = OP_LD_K; break;
+                case 0x15: d.op = OP_LD_DT; break;
+                case 0x18: d.op = OP_LD_ST; break;
+                case 0x1E: d.op = OP_ADD_I; break;
+                case 0x29: d.op = OP_LD_F; break;
+                case 0x30: d.op = OP_LD_HF; break;
+                case 0x33: d.op = OP_BCD; break;
+                case 0x55: d.op = OP_STORE; break;
+                case 0x65: d.op = OP_LOAD; break;
+                case 0x75: d.op = OP_SAVE_FLAGS; break;
+                case 0x85: d.op = OP_LOAD_FLAGS; break;
+            }
+            break;
+    }
+    return d;
+}
+
+void Chip8_invalidate(Chip8Proc *self, int addr, int len) {
+    // The instruction starting one byte earlier also reads ram[addr]; only
+    // entries decoded so far need dropping, so stores to data skip the loop
+    int low = addr - 1 > self->decodedLow ? addr - 1 : self->decodedLow;
+    int high = addr + len < self->decodedHigh ? addr + len : self->decodedHigh;
+    for (int a = low; a < high; ++a) {
+        self->decoded[a].op = OP_DECODE;
+    }
+    if (addr == 0) {
+        self->decoded[0xFFF].op = OP_DECODE;
+    }
+    if (self->jit != NULL) {
+        Chip8Jit_invalidate(self, addr, len);
+    }
+    if (self->aot != NULL) {
+        Chip8Aot_invalidate(self, addr, len);
+    }
+}
+
+/*
+ * Stop the processor at the current PC, recording why and the opcode there
+ * Returns false so callers can return it as their running state
+ */
+static bool Chip8_trap(Chip8Proc *self, Chip8Trap trap) {
+    uint16_t pc = self->PC;
+    self->trap = trap;
+    self->trapPC = pc;
+    self->trapOpcode = pc <= 0xFFE ? self->ram[pc] << 8 | self->ram[pc + 1] : 0;
+    return false;
+}
+
+/*
+ * Next random byte for Cxnn, from a per-processor xorshift32 generator.
+ * The state is multiplied before taking its top byte, so every output bit
+ * depends on the whole state.
+ */
+static inline uint8_t Chip8_random(Chip8Proc *self) {
+    uint32_t x = self->randState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->randState = x;
+    return (x * 0x9E3779BBu) >> 24;
+}
+
+/*
+ * True if ram[addr, addr + len) lies inside ram
+ */
+static bool Chip8_inRam(uint16_t addr, int len) {
+    return addr + len <= 4096;
+}
+
+/*
+ * Draw an n-row sprite from ram(I) at (x0, y0), setting Vf on collision
+ * Dxy0 draws a 16x16 sprite in largeScreen, and nothing otherwise
+ * Does NOT replicate Super collision line count
+ * Returns false, drawing nothing, if the sprite runs past the end of ram
+ */
+static bool Chip8_draw(Chip8Proc *self, int x0, int y0, uint8_t n) {
+    return self->largeScreen ? Chip8_drawHires(self, x0, y0, n)
+        : Chip8_drawLores(self, x0, y0, n);
+}
+
+/*
+ * Chip8_draw on the lores screen, where each pixel covers a 2x2 block of
+ * the framebuffer
+ */
+static bool Chip8_drawLores(Chip8Proc *self, int x0, int y0, uint8_t n) {
+    uint64_t mask[2];
+    bool hit = false;
+    if (!Chip8_inRam(self->I, n)) {
+        return false;
+    }
+    for (uint8_t r = 0; r < n; ++r) {
+        int row = 2 * (r + y0) % 64;
+        Chip8_rowMask(Chip8_doubleBits(self->ram[self->I + r]), 16, 2 * x0,
+                mask);
+        hit |= Chip8_blitRow(self, row, mask);
+        hit |= Chip8_blitRow(self, row + 1, mask);
+    }
+    self->V[0xF] = hit;
+    return true;
+}
+
+/*
+ * Chip8_draw on the hires screen
+ */
+static bool Chip8_drawHires(Chip8Proc *self, int x0, int y0, uint8_t n) {
+    uint64_t mask[2];
+    bool hit = false;
+    if (!Chip8_inRam(self->I, n == 0x0 ? 32 : n)) {
+        return false;
+    }
+    if (n == 0x0) {
+        for (int i = 0; i < 16; ++i) {
+            Chip8_rowMask(self->ram[self->I + 2 * i] << 8
+                    | self->ram[self->I + 2 * i + 1], 16, x0, mask);
+            hit |= Chip8_blitRow(self, y0 + i, mask);
+        }
+    } else {
+        for (uint8_t r = 0; r < n; ++r) {
+            Chip8_rowMask(self->ram[self->I + r], 8, x0, mask);
+            hit |= Chip8_blitRow(self, r + y0, mask);
+        }
+    }
+    self->V[0xF] = hit;
+    return true;
+}
+
+/*
+ * Clear the screen
+ */
+static void Chip8_clear(Chip8Proc *self) {
+    self->dirtyRows |= Chip8_litRows(self);
+    memset(self->screen, 0, sizeof(self->screen));
+}
+
+/*
+ * Big-endian instruction word at addr, 0 (which no idle loop contains) past
+ * the end of ram
+ */
+static uint16_t Chip8_fetch(const Chip8Proc *self, uint16_t addr) {
+    if (addr > 0xFFE) {
+        return 0;
+    }
+    return self->ram[addr] << 8 | self->ram[addr + 1];
+}
+
+/*
+ * Load the sound timer, telling setSound when the buzzer starts or stops
+ */
+static void Chip8_setSoundTimer(Chip8Proc *self, uint8_t value) {
+    bool wasPlaying = self->S > 0;
+    self->S = value;
+    if (self->setSound != NULL && (value > 0) != wasPlaying) {
+        self->setSound(value > 0, self);
+    }
+}
+
+/*
+ * Bitmap of the rows with at least one lit pixel
+ */
+static uint64_t Chip8_litRows(const Chip8Proc *self) {
+    uint64_t rows = 0;
+    for (int r = 0; r < 64; ++r) {
+        if (self->screen[r][0] | self->screen[r][1]) {
+            rows |= 1ULL << r;
+        }
+    }
+    return rows;
+}
+
+/*
+ * Scroll the display n lines down
+ */
+static void Chip8_scrollDown(Chip8Proc *self, uint8_t n) {
+    // Mark the rows whose contents will differ
+    for (int r = 0; r < 64; ++r) {
+        const uint64_t *above = r >= n ? self->screen[r - n] : (uint64_t[2]) {0};
+        if (above[0] != self->screen[r][0] || above[1] != self->screen[r][1]) {
+            self->dirtyRows |= 1ULL << r;
+        }
+    }
+    // Move whole rows down
+    memmove(self->screen + n,
+            self->screen,
+            sizeof(self->screen[0]) * (64 - n));
+    // Clear moved space
+    memset(self->screen, 0, sizeof(self->screen[0]) * n);
+}
+
+/*
+ * Scroll the display 4 small pixels right
+ */
+static void Chip8_scrollRight(Chip8Proc *self) {
+    // Every lit row changes when shifted
+    self->dirtyRows |= Chip8_litRows(self);
+    // Shift each line as one 128-bit value
+    for (int r = 0; r < 64; ++r) {
+        uint64_t *line = self->screen[r];
+        line[1] = line[1] >> 4 | line[0] << 60;
+        line[0] >>= 4;
+    }
+}
+
+/*
+ * Scroll the display 4 small pixels left
+ */
+static void Chip8_scrollLeft(Chip8Proc *self) {
+    // Every lit row changes when shifted
+    self->dirtyRows |= Chip8_litRows(self);
+    // Shift each line as one 128-bit value
+    for (int r = 0; r < 64; ++r) {
+        uint64_t *line = self->screen[r];
+        line[0] = line[0] << 4 | line[1] >> 60;
+        line[1] <<= 4;
+    }
+}
+
+/*
+ * Build the 128-bit row mask for a width-bit sprite row (MSB leftmost) drawn
+ * at column col, wrapping around the right edge of the screen
+ */
+static void Chip8_rowMask(uint16_t data, int width, int col, uint64_t mask[2]) {
+    uint64_t hi = (uint64_t) data << (64 - width), lo = 0;
+    col %= 128;
+    if (col >= 64) { // Rotating by 64 just swaps the two words
+        lo = hi;
+        hi = 0;
+        col -= 64;
+    }
+    if (col != 0) {
+        mask[0] = hi >> col | lo << (64 - col);
+        mask[1] = lo >> col | hi << (64 - col);
+    } else {
+        mask[0] = hi;
+        mask[1] = lo;
+    }
+}
+
+/*
+ * XOR a row mask into the framebuffer, returning true if any lit pixel was
+ * turned off (a collision)
+ */
+static bool Chip8_blitRow(Chip8Proc *self, int row, const uint64_t mask[2]) {
+    uint64_t *line = self->screen[row % 64];
+    if (mask[0] | mask[1]) {
+        self->dirtyRows |= 1ULL << row % 64;
+    }
+    bool collision = ((line[0] & mask[0]) | (line[1] & mask[1])) != 0;
+    line[0] ^= mask[0];
+    line[1] ^= mask[1];
+    return collision;
+}
+
+/*
+ * Double every bit of a lores sprite byte to span two hires columns
+ */
+static uint16_t Chip8_doubleBits(uint8_t data) {
+    uint16_t bits = data;
+    bits = (bits | bits << 4) & 0x0F0F;
+    bits = (bits | bits << 2) & 0x3333;
+    bits = (bits | bits << 1) & 0x5555;
+    return bits | bits << 1;
 }
 
 /*** Font data to be copied into the low ram addresses ***/
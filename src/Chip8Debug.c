@@ -0,0 +1,212 @@
+#include <errno.h>
+#include <string.h>
+
+#include "Chip8Debug.h"
+
+static bool Chip8Debug_test(const uint64_t bits[64], int addr);
+static bool Chip8Debug_flip(uint64_t bits[64], int addr, bool set);
+static bool Chip8Debug_holds(const Chip8Proc *proc,
+        const Chip8Condition *condition);
+static bool Chip8Debug_stop(Chip8Proc *proc, Chip8StopKind kind,
+        uint16_t addr, int index);
+
+void Chip8Debug_init(Chip8Debug *self) {
+    memset(self, 0, sizeof(*self));
+    self->resumeAt = UINT64_MAX;
+}
+
+bool Chip8Debug_setBreak(Chip8Debug *self, uint16_t addr, bool set) {
+    if (addr >= 4096) {
+        errno = EINVAL;
+        return false;
+    }
+    if (Chip8Debug_flip(self->breakAt, addr, set)) {
+        self->armed += set ? 1 : -1;
+    }
+    // A condition bound to addr keeps it checked
+    bool bound = false;
+    for (int c = 0; c < CHIP8_DEBUG_CONDITIONS; ++c) {
+        bound |= self->conditions[c].used
+            && self->conditions[c].addr == addr;
+    }
+    Chip8Debug_flip(self->stopAt, addr, set || bound);
+    return true;
+}
+
+bool Chip8Debug_setWatch(Chip8Debug *self, uint16_t addr, int len,
+        int kinds, bool set) {
+    if (len < 0 || addr + len > 4096) {
+        errno = EINVAL;
+        return false;
+    }
+    for (int a = addr; a < addr + len; ++a) {
+        if (kinds & CHIP8_WATCH_READ
+                && Chip8Debug_flip(self->watchRead, a, set)) {
+            self->armed += set ? 1 : -1;
+        }
+        if (kinds & CHIP8_WATCH_WRITE
+                && Chip8Debug_flip(self->watchWrite, a, set)) {
+            self->armed += set ? 1 : -1;
+        }
+    }
+    return true;
+}
+
+int Chip8Debug_addCondition(Chip8Debug *self, int addr, uint8_t reg,
+        Chip8Compare cmp, uint16_t value) {
+    if (addr < -1 || addr >= 4096 || reg > CHIP8_REG_SC
+            || cmp > CHIP8_CMP_GE) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (int c = 0; c < CHIP8_DEBUG_CONDITIONS; ++c) {
+        Chip8Condition *condition = &self->conditions[c];
+        if (condition->used) {
+            continue;
+        }
+        *condition = (Chip8Condition) {
+            .used = true, .addr = addr, .reg = reg, .cmp = cmp,
+            .value = value
+        };
+        if (addr < 0) {
+            ++self->unbound;
+        } else {
+            Chip8Debug_flip(self->stopAt, addr, true);
+        }
+        ++self->armed;
+        return c;
+    }
+    errno = ENOSPC;
+    return -1;
+}
+
+bool Chip8Debug_removeCondition(Chip8Debug *self, int index) {
+    if (index < 0 || index >= CHIP8_DEBUG_CONDITIONS
+            || !self->conditions[index].used) {
+        errno = EINVAL;
+        return false;
+    }
+    Chip8Condition *condition = &self->conditions[index];
+    condition->used = false;
+    --self->armed;
+    if (condition->addr < 0) {
+        --self->unbound;
+    } else {
+        // Recompute whether anything else stops at its address
+        Chip8Debug_setBreak(self, condition->addr,
+                Chip8Debug_test(self->breakAt, condition->addr));
+    }
+    return true;
+}
+
+void Chip8Debug_resume(Chip8Proc *proc) {
+    if (proc->trap != CHIP8_TRAP_BREAK) {
+        return;
+    }
+    proc->trap = CHIP8_TRAP_NONE;
+    if (proc->debug != NULL) {
+        proc->debug->resumeAt = proc->cycles;
+        proc->debug->stop.kind = CHIP8_STOP_NONE;
+    }
+}
+
+bool Chip8Debug_stops(Chip8Proc *proc) {
+    Chip8Debug *self = proc->debug;
+    uint16_t pc = proc->PC;
+    if (proc->trap != CHIP8_TRAP_NONE || proc->waitKey >= 0 || pc > 0xFFE
+            || (self->unbound == 0 && !Chip8Debug_test(self->stopAt, pc))
+            || proc->cycles == self->resumeAt) {
+        return false;
+    }
+    if (Chip8Debug_test(self->breakAt, pc)) {
+        return Chip8Debug_stop(proc, CHIP8_STOP_BREAKPOINT, pc, -1);
+    }
+    for (int c = 0; c < CHIP8_DEBUG_CONDITIONS; ++c) {
+        const Chip8Condition *condition = &self->conditions[c];
+        if (condition->used && (condition->addr < 0 || condition->addr == pc)
+                && Chip8Debug_holds(proc, condition)) {
+            return Chip8Debug_stop(proc, CHIP8_STOP_CONDITION, pc, c);
+        }
+    }
+    return false;
+}
+
+bool Chip8Debug_watches(Chip8Proc *proc, uint16_t addr, int len, int kind) {
+    Chip8Debug *self = proc->debug;
+    const uint64_t *bits = kind == CHIP8_WATCH_READ ? self->watchRead
+        : self->watchWrite;
+    if (proc->cycles == self->resumeAt) {
+        return false;
+    }
+    for (int a = addr; a < addr + len && a < 4096; ++a) {
+        if (Chip8Debug_test(bits, a)) {
+            return Chip8Debug_stop(proc, kind == CHIP8_WATCH_READ
+                    ? CHIP8_STOP_READ : CHIP8_STOP_WRITE, a, -1);
+        }
+    }
+    return false;
+}
+
+const char *Chip8_registerName(uint8_t reg) {
+    static const char *names[] = {
+        "V0", "V1", "V2", "V3", "V4", "V5", "V6", "V7",
+        "V8", "V9", "VA", "VB", "VC", "VD", "VE", "VF",
+        "I", "D", "S", "SC"
+    };
+    return reg <= CHIP8_REG_SC ? names[reg] : "?";
+}
+
+int Chip8_registerValue(const Chip8Proc *proc, uint8_t reg) {
+    switch (reg) {
+        case CHIP8_REG_I: return proc->I;
+        case CHIP8_REG_D: return proc->D;
+        case CHIP8_REG_S: return proc->S;
+        case CHIP8_REG_SC: return proc->SC;
+        default: return proc->V[reg & 0xF];
+    }
+}
+
+static bool Chip8Debug_test(const uint64_t bits[64], int addr) {
+    return bits[addr / 64] >> addr % 64 & 1;
+}
+
+/*
+ * Set or clear bit addr.
+ * Returns true if that changed it.
+ */
+static bool Chip8Debug_flip(uint64_t bits[64], int addr, bool set) {
+    uint64_t bit = 1ULL << addr % 64;
+    bool was = bits[addr / 64] & bit;
+    if (set) {
+        bits[addr / 64] |= bit;
+    } else {
+        bits[addr / 64] &= ~bit;
+    }
+    return was != set;
+}
+
+static bool Chip8Debug_holds(const Chip8Proc *proc,
+        const Chip8Condition *condition) {
+    int value = Chip8_registerValue(proc, condition->reg);
+    switch (condition->cmp) {
+        case CHIP8_CMP_EQ: return value == condition->value;
+        case CHIP8_CMP_NE: return value != condition->value;
+        case CHIP8_CMP_LT: return value < condition->value;
+        case CHIP8_CMP_LE: return value <= condition->value;
+        case CHIP8_CMP_GT: return value > condition->value;
+        case CHIP8_CMP_GE: return value >= condition->value;
+    }
+    return false;
+}
+
+/*
+ * Note why proc stops; always true, for Chip8Debug_stops and
+ * Chip8Debug_watches to return
+ */
+static bool Chip8Debug_stop(Chip8Proc *proc, Chip8StopKind kind,
+        uint16_t addr, int index) {
+    proc->debug->stop = (Chip8DebugStop) {
+        .kind = kind, .addr = addr, .index = index
+    };
+    return true;
+}
@@ -0,0 +1,141 @@
+#define _GNU_SOURCE // syscall
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "Chip8Input.h"
+
+#define NS_PER_SEC 1000000000ULL
+#define QUEUE_MASK (CHIP8_INPUT_QUEUE_SIZE - 1)
+
+_Static_assert((CHIP8_INPUT_QUEUE_SIZE & QUEUE_MASK) == 0,
+        "CHIP8_INPUT_QUEUE_SIZE must be a power of two");
+
+static void Chip8Input_sleep(Chip8Input *self, uint32_t head,
+        uint64_t deadline);
+static void Chip8Input_wake(Chip8Input *self);
+
+void Chip8Input_init(Chip8Input *self) {
+    memset(self, 0, sizeof(*self));
+}
+
+bool Chip8Input_push(Chip8Input *self, uint8_t key, bool pressed) {
+    uint32_t head = atomic_load_explicit(&self->head, memory_order_relaxed),
+             tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+    if (head - tail == CHIP8_INPUT_QUEUE_SIZE) {
+        ++self->dropped;
+        return false;
+    }
+    self->events[head & QUEUE_MASK] = (Chip8KeyEvent) {
+        .stamp = Chip8Input_now(),
+        .key = key,
+        .pressed = pressed
+    };
+    // Sequentially consistent, so either the consumer sees the new head
+    // before sleeping or this sees it asleep
+    atomic_store(&self->head, head + 1);
+    if (atomic_load(&self->sleeping)) {
+        Chip8Input_wake(self);
+    }
+    return true;
+}
+
+int Chip8Input_deliver(Chip8Input *self, Chip8Proc *proc) {
+    uint32_t tail = atomic_load_explicit(&self->tail, memory_order_relaxed),
+             head = atomic_load_explicit(&self->head, memory_order_acquire);
+    if (tail == head) {
+        return 0;
+    }
+    uint64_t now = Chip8Input_now();
+    uint16_t pressed = 0;
+    int count = 0;
+    for (; tail != head; ++tail, ++count) {
+        const Chip8KeyEvent *event = &self->events[tail & QUEUE_MASK];
+        // A key tapped within one delivery is left held until the next,
+        // so the program gets to see it
+        if (!event->pressed && pressed >> (event->key & 0xF) & 1) {
+            break;
+        }
+        if (event->pressed) {
+            pressed |= 1 << (event->key & 0xF);
+        }
+        Chip8_keyEvent(proc, event->key, event->pressed);
+        uint64_t latency = now - event->stamp;
+        self->latencyTotal += latency;
+        if (latency > self->latencyMax) {
+            self->latencyMax = latency;
+        }
+    }
+    atomic_store_explicit(&self->tail, tail, memory_order_release);
+    self->delivered += count;
+    return count;
+}
+
+bool Chip8Input_wait(Chip8Input *self, uint64_t deadline) {
+    uint32_t tail = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    for (;;) {
+        atomic_store(&self->sleeping, 1);
+        uint32_t head = atomic_load(&self->head);
+        if (head != tail || Chip8Input_now() >= deadline) {
+            atomic_store(&self->sleeping, 0);
+            return head != tail;
+        }
+        Chip8Input_sleep(self, head, deadline);
+    }
+}
+
+uint64_t Chip8Input_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * NS_PER_SEC + ts.tv_nsec;
+}
+
+#ifdef __linux__
+
+/*
+ * Block while head is unchanged, until deadline on the monotonic clock
+ */
+static void Chip8Input_sleep(Chip8Input *self, uint32_t head,
+        uint64_t deadline) {
+    struct timespec ts = {
+        .tv_sec = deadline / NS_PER_SEC,
+        .tv_nsec = deadline % NS_PER_SEC
+    };
+    // FUTEX_WAIT_BITSET takes an absolute timeout
+    syscall(SYS_futex, (uint32_t *) &self->head,
+            FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, head, &ts, NULL,
+            FUTEX_BITSET_MATCH_ANY);
+}
+
+static void Chip8Input_wake(Chip8Input *self) {
+    syscall(SYS_futex, (uint32_t *) &self->head,
+            FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, NULL, NULL, 0);
+}
+
+#else
+
+/*
+ * Without futexes, events wait for the deadline
+ */
+static void Chip8Input_sleep(Chip8Input *self, uint32_t head,
+        uint64_t deadline) {
+    (void) self;
+    (void) head;
+    struct timespec ts = {
+        .tv_sec = deadline / NS_PER_SEC,
+        .tv_nsec = deadline % NS_PER_SEC
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)
+            == EINTR);
+}
+
+static void Chip8Input_wake(Chip8Input *self) {
+    (void) self;
+}
+
+#endif
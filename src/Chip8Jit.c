@@ -0,0 +1,863 @@
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Chip8Jit.h"
+#include "Guards.h"
+
+// Bytes of executable memory per processor
+#define CODE_SIZE  (1 << 20)
+// Instructions per block, and an upper bound on the code one block needs
+#define MAX_BLOCK  64
+#define MAX_BYTES  (MAX_BLOCK * 96 + 256)
+// Blocks translated at once: the one asked for, then successors it jumps to
+#define MAX_BATCH  16
+// Jumps to blocks not translated yet, kept to be patched once they are
+#define MAX_LINKS  1024
+
+// Displacements of the processor fields generated code works on
+#define OFF_V(x)   ((int32_t) (offsetof(Chip8Proc, V) + (x)))
+#define OFF_I      ((int32_t) offsetof(Chip8Proc, I))
+#define OFF_D      ((int32_t) offsetof(Chip8Proc, D))
+#define OFF_RAM    ((int32_t) offsetof(Chip8Proc, ram))
+#define OFF_PC     ((int32_t) offsetof(Chip8Proc, PC))
+#define OFF_SC     ((int32_t) offsetof(Chip8Proc, SC))
+#define OFF_STACK  ((int32_t) offsetof(Chip8Proc, stack))
+#define OFF_KEYS   ((int32_t) offsetof(Chip8Proc, keys))
+#define OFF_CYCLES ((int32_t) offsetof(Chip8Proc, cycles))
+
+// x86-64 register numbers used in ModRM fields
+#define EAX 0
+#define ECX 1
+#define EDX 2
+#define R12 4
+
+// Generated code keeps the processor in rbx, its cycle count in r12 and the
+// cycle count to stop at in r13. The trampoline at the start of the code
+// loads them and jumps to a block; blocks jump straight to one another
+// while the budget lasts, and leave through the trampoline's exit, which
+// stores r12 back and returns why the code stopped.
+typedef int (*Chip8JitEnter)(Chip8Proc *self, uint64_t end,
+        const uint8_t *entry);
+
+// Why generated code returned, with PC at the next instruction to run
+enum {
+    // Out of budget, or at code not translated yet
+    EXIT_NONE,
+    // After a short backward 1nnn, which may close an idle loop
+    EXIT_IDLE,
+    // At an instruction past the stack or ram bounds, for Chip8_advance to
+    // trap on
+    EXIT_STEP
+};
+
+typedef struct Chip8JitBlock {
+    // Code of the block, NULL if its first instruction is never translated
+    const uint8_t *entry;
+    // Instructions in the block, at most as many as any run of it retires
+    uint16_t length;
+    bool valid;
+} Chip8JitBlock;
+
+// Generated code indexes the blocks by address, 16 bytes apart
+_Static_assert(sizeof(Chip8JitBlock) == 16, "Chip8JitBlock is 16 bytes");
+
+// A jump to the exit in place of one to the block at target
+typedef struct Chip8JitLink {
+    uint32_t site;
+    uint16_t target;
+    bool patched;
+} Chip8JitLink;
+
+struct Chip8Jit {
+    uint8_t *code;
+    // Bytes of code in use, and those the trampoline takes at the start
+    size_t used, base;
+    Chip8JitEnter enter;
+    // Offset of the trampoline's exit
+    uint32_t exit;
+    // Quirk setting the blocks were translated for
+    bool superMode;
+    // Set whenever blocks are dropped, so a block calling a helper that
+    // writes ram knows to return immediately
+    bool flushed;
+    // Nonzero for every ram byte that belongs to a translated block
+    uint8_t covered[4096];
+    Chip8JitBlock blocks[4096];
+    // Addresses [low, high) span every block translated, for a flush to
+    // clear
+    uint16_t low, high;
+    Chip8JitLink links[MAX_LINKS];
+    size_t linkCount;
+};
+
+// Where a block is being translated to
+typedef struct Chip8JitEmitter {
+    uint8_t *p;
+    const Chip8Proc *self;
+    struct Chip8Jit *jit;
+    uint16_t start;
+    const uint8_t *entry;
+    // Instructions retired natively that r12 does not count yet
+    int pending;
+} Chip8JitEmitter;
+
+// How an instruction was translated
+enum { EMIT_NONE, EMIT_NATIVE, EMIT_HELPER, EMIT_END };
+
+#if defined(__x86_64__)
+
+static void Chip8Jit_flush(struct Chip8Jit *jit);
+static void Chip8Jit_emitTrampoline(struct Chip8Jit *jit);
+static void Chip8Jit_translate(Chip8Proc *self, uint16_t start);
+static void Chip8Jit_emitBlock(const Chip8Proc *self, uint16_t start);
+static int Chip8Jit_emitOp(Chip8JitEmitter *e, uint16_t pc);
+static void Chip8Jit_cover(struct Chip8Jit *jit, int addr, int len);
+static bool Chip8Jit_mayIdle(struct Chip8Jit *jit, const Chip8Proc *self,
+        uint16_t pc, uint16_t target);
+static uint32_t Chip8Jit_helper(Chip8Proc *self, uint32_t pc);
+static uint32_t Chip8Jit_written(Chip8Proc *self, uint32_t addr,
+        uint32_t len);
+
+bool Chip8Jit_enable(Chip8Proc *self) {
+    if (self->jit != NULL) {
+        return true;
+    }
+    struct Chip8Jit *jit = OOM_GUARD(calloc(1, sizeof(struct Chip8Jit)),
+            __FILE__, __LINE__);
+    jit->code = mmap(NULL, CODE_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (jit->code == MAP_FAILED) {
+        free(jit);
+        return false;
+    }
+    Chip8Jit_emitTrampoline(jit);
+    mprotect(jit->code, CODE_SIZE, PROT_READ | PROT_EXEC);
+    jit->superMode = self->superMode;
+    jit->low = 4096;
+    self->jit = jit;
+    return true;
+}
+
+void Chip8Jit_disable(Chip8Proc *self) {
+    if (self->jit == NULL) {
+        return;
+    }
+    munmap(self->jit->code, CODE_SIZE);
+    free(self->jit);
+    self->jit = NULL;
+}
+
+bool Chip8Jit_execute(Chip8Proc *self, uint64_t budget) {
+    struct Chip8Jit *jit = self->jit;
+    if (jit->superMode != self->superMode) {
+        Chip8Jit_flush(jit);
+        jit->superMode = self->superMode;
+    }
+    uint64_t end = self->cycles + budget;
+    while (self->cycles < end) {
+        // Key instructions are never translated, so only Chip8_advance
+        // starts a wait
+        if (self->waitKey >= 0) {
+            return true;
+        }
+        uint16_t pc = self->PC;
+        Chip8JitBlock *block = pc <= 0xFFE ? &jit->blocks[pc] : NULL;
+        if (block != NULL && !block->valid) {
+            Chip8Jit_translate(self, pc);
+        }
+        // Single-step anything untranslated, and leave a tail of the
+        // budget too short for the block to the interpreter
+        if (block == NULL || block->length == 0) {
+            if (!Chip8_advance(self)) { return false; }
+            continue;
+        }
+        if (block->length > end - self->cycles) {
+            return Chip8_executeThreaded(self, end - self->cycles);
+        }
+        int exit = jit->enter(self, end, block->entry);
+        if (self->trap != CHIP8_TRAP_NONE) { return false; }
+        if (exit == EXIT_STEP && !Chip8_advance(self)) {
+            return false;
+        }
+        // A processor spinning in an idle loop uses up the budget at once
+        if (exit == EXIT_IDLE && Chip8_skipIdle(self, end - self->cycles)) {
+            self->cycles = end;
+            return true;
+        }
+    }
+    return true;
+}
+
+void Chip8Jit_invalidate(Chip8Proc *self, int addr, int len) {
+    struct Chip8Jit *jit = self->jit;
+    // Only bytes in [low, high) can be covered, so a reset or a store away
+    // from translated code checks nothing
+    int start = addr > jit->low ? addr : jit->low,
+        end = addr + len < jit->high ? addr + len : jit->high;
+    for (int a = start; a < end; ++a) {
+        if (jit->covered[a]) {
+            Chip8Jit_flush(jit);
+            return;
+        }
+    }
+}
+
+/*
+ * Drop every translated block, keeping the trampoline
+ */
+static void Chip8Jit_flush(struct Chip8Jit *jit) {
+    if (jit->low < jit->high) {
+        memset(jit->blocks + jit->low, 0,
+                (jit->high - jit->low) * sizeof(Chip8JitBlock));
+        memset(jit->covered + jit->low, 0, jit->high - jit->low);
+    }
+    jit->low = 4096;
+    jit->high = 0;
+    jit->used = jit->base;
+    jit->linkCount = 0;
+    jit->flushed = true;
+}
+
+/*** Instruction encoding ***/
+
+static void emit8(uint8_t **p, uint8_t v) { *(*p)++ = v; }
+static void emit16(uint8_t **p, uint16_t v) { memcpy(*p, &v, 2); *p += 2; }
+static void emit32(uint8_t **p, uint32_t v) { memcpy(*p, &v, 4); *p += 4; }
+static void emit64(uint8_t **p, uint64_t v) { memcpy(*p, &v, 8); *p += 8; }
+
+// ModRM + disp32 addressing [rbx + disp] with reg (or opcode extension)
+static void emitMem(uint8_t **p, int reg, int32_t disp) {
+    emit8(p, 0x80 | reg << 3 | 3);
+    emit32(p, (uint32_t) disp);
+}
+
+// movzx reg, byte [rbx + V[x]]
+static void loadV(uint8_t **p, int reg, int x) {
+    emit8(p, 0x0F); emit8(p, 0xB6); emitMem(p, reg, OFF_V(x));
+}
+
+// mov byte [rbx + V[x]], reg8
+static void storeV(uint8_t **p, int reg, int x) {
+    emit8(p, 0x88); emitMem(p, reg, OFF_V(x));
+}
+
+// mov word [rbx + PC], imm16
+static void storePC(uint8_t **p, uint16_t pc) {
+    emit8(p, 0x66); emit8(p, 0xC7); emitMem(p, EAX, OFF_PC); emit16(p, pc);
+}
+
+// jmp rel32 to target
+static void emitJump(uint8_t **p, const uint8_t *target) {
+    emit8(p, 0xE9); emit32(p, (uint32_t) (target - (*p + 4)));
+}
+
+// Point the rel8 of the short jump ending at from to the current position
+static void patchShort(uint8_t *from, const uint8_t *p) {
+    from[-1] = p - from;
+}
+
+// Leave the generated code with PC at pc (19 bytes; the first 5 are
+// patched into a jump once the block at pc is translated)
+static void emitExit(Chip8JitEmitter *e, uint16_t pc, int why) {
+    storePC(&e->p, pc);
+    emit8(&e->p, 0xB8); emit32(&e->p, why);         // mov eax, why
+    emitJump(&e->p, e->jit->code + e->jit->exit);
+}
+
+// add r12, the instructions retired natively since the last retire
+static void emitRetire(Chip8JitEmitter *e) {
+    if (e->pending > 0) {
+        emit8(&e->p, 0x49); emit8(&e->p, 0x83); emit8(&e->p, 0xC4);
+        emit8(&e->p, e->pending);
+        e->pending = 0;
+    }
+}
+
+// Continue at the block at target, once it is translated
+static void emitLink(Chip8JitEmitter *e, uint16_t target) {
+    struct Chip8Jit *jit = e->jit;
+    if (target == e->start) {
+        emitJump(&e->p, e->entry);
+        return;
+    }
+    if (target <= 0xFFE && jit->blocks[target].valid) {
+        if (jit->blocks[target].entry != NULL) {
+            emitJump(&e->p, jit->blocks[target].entry);
+        } else {
+            emitExit(e, target, EXIT_NONE);
+        }
+        return;
+    }
+    if (target <= 0xFFE && jit->linkCount < MAX_LINKS) {
+        jit->links[jit->linkCount++] = (Chip8JitLink) {
+            .site = e->p - jit->code,
+            .target = target
+        };
+    }
+    emitExit(e, target, EXIT_NONE);
+}
+
+// Leave the generated code with PC at pc, for Chip8_advance to trap on the
+// instruction there
+static void emitStep(Chip8JitEmitter *e, uint16_t pc) {
+    int pending = e->pending;
+    emitRetire(e);
+    e->pending = pending;
+    emitExit(e, pc, EXIT_STEP);
+}
+
+// Continue at ecx: in its block if it is translated, else through the exit
+static void emitIndirect(Chip8JitEmitter *e) {
+    uint8_t **p = &e->p, *out, *missing;
+    emit8(p, 0x66); emit8(p, 0x89); emitMem(p, ECX, OFF_PC);
+    emit8(p, 0x81); emit8(p, 0xF9); emit32(p, 0xFFE);   // cmp ecx, 0xFFE
+    emit8(p, 0x77); emit8(p, 0); out = *p;              // ja out
+    emit8(p, 0x48); emit8(p, 0xB8);                     // mov rax, blocks
+    emit64(p, (uint64_t) (uintptr_t) e->jit->blocks);
+    emit8(p, 0xC1); emit8(p, 0xE1); emit8(p, 4);        // shl ecx, 4
+    emit8(p, 0x48); emit8(p, 0x8B); emit8(p, 0x04); emit8(p, 0x08);
+    emit8(p, 0x48); emit8(p, 0x85); emit8(p, 0xC0);     // test rax, rax
+    emit8(p, 0x74); emit8(p, 0); missing = *p;          // jz out
+    emit8(p, 0xFF); emit8(p, 0xE0);                     // jmp rax
+    patchShort(out, *p);
+    patchShort(missing, *p);
+    emit8(p, 0x31); emit8(p, 0xC0);                     // xor eax, eax
+    emitJump(p, e->jit->code + e->jit->exit);
+}
+
+// Copy V0...V(count-1) to or from ram[eax...], in the widest moves that
+// fit: 8, 4, 2, then 1 bytes
+static void emitMoves(uint8_t **p, int count, bool toRam) {
+    for (int i = 0, width = 8; i < count; width /= 2) {
+        if (count - i < width) {
+            continue;
+        }
+        // mov rcx / ecx / cx / cl, [rbx + rax + ram + i] or [rbx + V[i]]
+        if (width == 2) { emit8(p, 0x66); }
+        if (width == 8) { emit8(p, 0x48); }
+        emit8(p, width == 1 ? 0x8A : 0x8B);
+        if (toRam) {
+            emitMem(p, ECX, OFF_V(i));
+        } else {
+            emit8(p, 0x8C); emit8(p, 0x03); emit32(p, OFF_RAM + i);
+        }
+        // and back the other way
+        if (width == 2) { emit8(p, 0x66); }
+        if (width == 8) { emit8(p, 0x48); }
+        emit8(p, width == 1 ? 0x88 : 0x89);
+        if (toRam) {
+            emit8(p, 0x8C); emit8(p, 0x03); emit32(p, OFF_RAM + i);
+        } else {
+            emitMem(p, ECX, OFF_V(i));
+        }
+        i += width;
+    }
+}
+
+// Check that ram[I, I + len) is in ram, leaving I in eax, else leave for
+// Chip8_advance to trap on the instruction at pc
+static void emitRamCheck(Chip8JitEmitter *e, uint16_t pc, int len) {
+    uint8_t **p = &e->p, *ok;
+    // movzx eax, word [I]; cmp eax, 4096 - len; jbe ok
+    emit8(p, 0x0F); emit8(p, 0xB7); emitMem(p, EAX, OFF_I);
+    emit8(p, 0x3D); emit32(p, 4096 - len);
+    emit8(p, 0x76); emit8(p, 0); ok = *p;
+    emitStep(e, pc);
+    patchShort(ok, *p);
+}
+
+// Retire the instruction at pc, which wrote ram[eax, eax + len), and drop
+// what the processor has cached of it; leave if that was translated code
+static void emitWritten(Chip8JitEmitter *e, uint16_t pc, int len) {
+    uint8_t **p = &e->p, *next;
+    ++e->pending;
+    emitRetire(e);
+    emit8(p, 0x89); emit8(p, 0xC6);                     // mov esi, eax
+    emit8(p, 0xBA); emit32(p, len);                     // mov edx, len
+    emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0xDF);     // mov rdi, rbx
+    emit8(p, 0x48); emit8(p, 0xB8);                     // mov rax, written
+    emit64(p, (uint64_t) (uintptr_t) &Chip8Jit_written);
+    emit8(p, 0xFF); emit8(p, 0xD0);                     // call rax
+    emit8(p, 0x85); emit8(p, 0xC0);                     // test eax, eax
+    emit8(p, 0x74); emit8(p, 0); next = *p;             // jz next
+    emitExit(e, pc + 2, EXIT_NONE);
+    patchShort(next, *p);
+}
+
+// Retire the skip at pc, then continue at pc + 4 if the flags of the
+// comparison emitted by compare satisfy jcc condition cc, else at pc + 2
+static void emitSkip(Chip8JitEmitter *e, uint16_t pc, uint8_t cc) {
+    uint8_t *taken;
+    emit8(&e->p, cc); emit8(&e->p, 0); taken = e->p;
+    emitLink(e, pc + 2);
+    patchShort(taken, e->p);
+    emitLink(e, pc + 4);
+}
+
+/*
+ * Emit the code every processor enters blocks through, at the start of the
+ * code
+ */
+static void Chip8Jit_emitTrampoline(struct Chip8Jit *jit) {
+    uint8_t *p = jit->code;
+    emit8(&p, 0x53);                                    // push rbx
+    emit8(&p, 0x41); emit8(&p, 0x54);                   // push r12
+    emit8(&p, 0x41); emit8(&p, 0x55);                   // push r13
+    emit8(&p, 0x48); emit8(&p, 0x89); emit8(&p, 0xFB);  // mov rbx, rdi
+    emit8(&p, 0x49); emit8(&p, 0x89); emit8(&p, 0xF5);  // mov r13, rsi
+    emit8(&p, 0x4C); emit8(&p, 0x8B); emitMem(&p, R12, OFF_CYCLES);
+    emit8(&p, 0xFF); emit8(&p, 0xE2);                   // jmp rdx
+    jit->exit = p - jit->code;
+    emit8(&p, 0x4C); emit8(&p, 0x89); emitMem(&p, R12, OFF_CYCLES);
+    emit8(&p, 0x41); emit8(&p, 0x5D);                   // pop r13
+    emit8(&p, 0x41); emit8(&p, 0x5C);                   // pop r12
+    emit8(&p, 0x5B);                                    // pop rbx
+    emit8(&p, 0xC3);                                    // ret
+    jit->enter = (Chip8JitEnter) (void *) jit->code;
+    jit->used = jit->base = p - jit->code;
+}
+
+/*
+ * Translate the basic block starting at start, then the blocks it jumps to
+ * that are not translated yet, so that one pair of mprotect calls covers
+ * a whole loop
+ */
+static void Chip8Jit_translate(Chip8Proc *self, uint16_t start) {
+    struct Chip8Jit *jit = self->jit;
+    if (jit->used + MAX_BYTES > CODE_SIZE) {
+        Chip8Jit_flush(jit);
+    }
+    mprotect(jit->code, CODE_SIZE, PROT_READ | PROT_WRITE);
+    Chip8Jit_emitBlock(self, start);
+    int batch = 1;
+    for (size_t l = 0; l < jit->linkCount && batch < MAX_BATCH
+            && jit->used + MAX_BYTES <= CODE_SIZE; ++l) {
+        if (!jit->blocks[jit->links[l].target].valid) {
+            Chip8Jit_emitBlock(self, jit->links[l].target);
+            ++batch;
+        }
+    }
+    mprotect(jit->code, CODE_SIZE, PROT_READ | PROT_EXEC);
+}
+
+/*
+ * Translate the basic block starting at start, record it, and patch the
+ * jumps waiting for it
+ */
+static void Chip8Jit_emitBlock(const Chip8Proc *self, uint16_t start) {
+    struct Chip8Jit *jit = self->jit;
+    uint8_t *entry = jit->code + jit->used, *head;
+    Chip8JitEmitter e = {
+        .p = entry, .self = self, .jit = jit, .start = start, .entry = entry
+    };
+
+    // Leave before the block if the budget cannot take all of it:
+    // lea rax, [r12 + length]; cmp rax, r13; jbe body
+    emit8(&e.p, 0x49); emit8(&e.p, 0x8D); emit8(&e.p, 0x44);
+    emit8(&e.p, 0x24); emit8(&e.p, 0);
+    head = e.p;
+    emit8(&e.p, 0x4C); emit8(&e.p, 0x39); emit8(&e.p, 0xE8);
+    emit8(&e.p, 0x76); emit8(&e.p, 0);
+    uint8_t *body = e.p;
+    emitExit(&e, start, EXIT_NONE);
+    patchShort(body, e.p);
+
+    int length = 0, kind = EMIT_NATIVE;
+    uint16_t pc = start;
+    while (length < MAX_BLOCK && pc <= 0xFFE) {
+        uint8_t *mark = e.p;
+        int pending = e.pending;
+        kind = Chip8Jit_emitOp(&e, pc);
+        if (kind == EMIT_NONE) {
+            e.p = mark;
+            e.pending = pending;
+            break;
+        }
+        Chip8Jit_cover(jit, pc, 2);
+        ++length;
+        pc += 2;
+        if (kind == EMIT_END) {
+            break;
+        }
+    }
+    if (kind != EMIT_END) {
+        emitRetire(&e);
+        emitLink(&e, pc);
+    }
+
+    Chip8JitBlock *block = &jit->blocks[start];
+    block->valid = true;
+    block->length = length;
+    if (length == 0) {
+        // Rewriting the instruction may make it translatable
+        Chip8Jit_cover(jit, start, 2);
+        return;
+    }
+    head[-1] = length;
+    block->entry = entry;
+    jit->used += e.p - entry;
+    for (size_t l = 0; l < jit->linkCount; ++l) {
+        Chip8JitLink *link = &jit->links[l];
+        if (link->target == start && !link->patched) {
+            uint8_t *site = jit->code + link->site;
+            emitJump(&site, entry);
+            link->patched = true;
+        }
+    }
+}
+
+/*
+ * Emit native code for the instruction at pc
+ */
+static int Chip8Jit_emitOp(Chip8JitEmitter *e, uint16_t pc) {
+    const Chip8Proc *self = e->self;
+    uint8_t **p = &e->p, *ok;
+    uint8_t op12 = self->ram[pc], op34 = self->ram[pc + 1];
+    uint8_t op1 = op12 >> 4,
+            op2 = op12 & 0x0F,
+            op3 = op34 >> 4,
+            op4 = op34 & 0x0F;
+    uint16_t nnn = op2 << 8 | op34;
+
+    switch (op1) {
+        case 0x0:
+            if (op12 != 0x00) {
+                return EMIT_NONE;
+            }
+            if (op3 == 0xC) { // 00Cn
+                goto helper;
+            }
+            switch (op34) {
+                case 0xE0: case 0xFB: case 0xFC: case 0xFE: case 0xFF:
+                    goto helper;
+                case 0xEE: // 00EE: Return from subroutine
+                    // movsx eax, byte [SC]; test eax, eax; jns ok
+                    emit8(p, 0x0F); emit8(p, 0xBE); emitMem(p, EAX, OFF_SC);
+                    emit8(p, 0x85); emit8(p, 0xC0);
+                    emit8(p, 0x79); emit8(p, 0); ok = *p;
+                    emitStep(e, pc);
+                    patchShort(ok, *p);
+                    // movzx ecx, word [rbx + rax * 2 + stack]
+                    emit8(p, 0x0F); emit8(p, 0xB7); emit8(p, 0x8C);
+                    emit8(p, 0x43); emit32(p, OFF_STACK);
+                    emit8(p, 0xFF); emit8(p, 0xC8);     // dec eax
+                    emit8(p, 0x88); emitMem(p, EAX, OFF_SC);
+                    emit8(p, 0x83); emit8(p, 0xC1); emit8(p, 2); // add ecx, 2
+                    ++e->pending;
+                    emitRetire(e);
+                    emitIndirect(e);
+                    return EMIT_END;
+            }
+            return EMIT_NONE;
+        case 0x1: // 1nnn
+            ++e->pending;
+            emitRetire(e);
+            if (Chip8Jit_mayIdle(e->jit, self, pc, nnn)) {
+                emitExit(e, nnn, EXIT_IDLE);
+            } else {
+                emitLink(e, nnn);
+            }
+            return EMIT_END;
+        case 0x2: // 2nnn
+            // movsx eax, byte [SC]; cmp eax, 15; jl ok
+            emit8(p, 0x0F); emit8(p, 0xBE); emitMem(p, EAX, OFF_SC);
+            emit8(p, 0x83); emit8(p, 0xF8); emit8(p, 15);
+            emit8(p, 0x7C); emit8(p, 0); ok = *p;
+            emitStep(e, pc);
+            patchShort(ok, *p);
+            emit8(p, 0xFF); emit8(p, 0xC0);             // inc eax
+            emit8(p, 0x88); emitMem(p, EAX, OFF_SC);
+            // mov word [rbx + rax * 2 + stack], pc
+            emit8(p, 0x66); emit8(p, 0xC7); emit8(p, 0x84);
+            emit8(p, 0x43); emit32(p, OFF_STACK); emit16(p, pc);
+            ++e->pending;
+            emitRetire(e);
+            emitLink(e, nnn);
+            return EMIT_END;
+        case 0x3: // 3xnn: cmp byte [Vx], nn
+        case 0x4: // 4xnn
+            ++e->pending;
+            emitRetire(e);
+            emit8(p, 0x80); emitMem(p, 7, OFF_V(op2)); emit8(p, op34);
+            emitSkip(e, pc, op1 == 0x3 ? 0x74 : 0x75);  // je / jne
+            return EMIT_END;
+        case 0x5: // 5xy0
+        case 0x9: // 9xy0
+            if (op4 != 0x0) {
+                return EMIT_NONE;
+            }
+            ++e->pending;
+            emitRetire(e);
+            loadV(p, EAX, op2);
+            loadV(p, ECX, op3);
+            emit8(p, 0x39); emit8(p, 0xC8);             // cmp eax, ecx
+            emitSkip(e, pc, op1 == 0x5 ? 0x74 : 0x75);  // je / jne
+            return EMIT_END;
+        case 0x6: // 6xnn: mov byte [Vx], nn
+            emit8(p, 0xC6); emitMem(p, 0, OFF_V(op2)); emit8(p, op34);
+            break;
+        case 0x7: // 7xnn: add byte [Vx], nn
+            emit8(p, 0x80); emitMem(p, 0, OFF_V(op2)); emit8(p, op34);
+            break;
+        case 0x8:
+            switch (op4) {
+                case 0x0: // 8xy0
+                    loadV(p, EAX, op3);
+                    storeV(p, EAX, op2);
+                    break;
+                case 0x1: // 8xy1
+                case 0x2: // 8xy2
+                case 0x3: // 8xy3
+                    loadV(p, EAX, op2);
+                    loadV(p, ECX, op3);
+                    // or / and / xor al, cl
+                    emit8(p, op4 == 0x1 ? 0x08 : op4 == 0x2 ? 0x20 : 0x30);
+                    emit8(p, 0xC8);
+                    storeV(p, EAX, op2);
+                    break;
+                case 0x4: // 8xy4: Vf = sum >= 255, then Vx = sum
+                    loadV(p, EAX, op2);
+                    loadV(p, ECX, op3);
+                    emit8(p, 0x01); emit8(p, 0xC8);     // add eax, ecx
+                    emit8(p, 0x3D); emit32(p, 255);     // cmp eax, 255
+                    emit8(p, 0x0F); emit8(p, 0x93); emit8(p, 0xC2); // setae dl
+                    storeV(p, EDX, 0xF);
+                    storeV(p, EAX, op2);
+                    break;
+                case 0x5: // 8xy5: Vx -= Vy, then Vf = old >= Vx
+                case 0x7: // 8xy7: Vx = Vy - Vx, then Vf = Vy(old) >= Vx
+                    if (op4 == 0x5) {
+                        loadV(p, EDX, op2);
+                        loadV(p, EAX, op2);
+                        loadV(p, ECX, op3);
+                    } else {
+                        loadV(p, EDX, op3);
+                        loadV(p, EAX, op3);
+                        loadV(p, ECX, op2);
+                    }
+                    emit8(p, 0x28); emit8(p, 0xC8);     // sub al, cl
+                    storeV(p, EAX, op2);
+                    emit8(p, 0x0F); emit8(p, 0xB6); emit8(p, 0xC0); // movzx eax, al
+                    emit8(p, 0x39); emit8(p, 0xC2);     // cmp edx, eax
+                    emit8(p, 0x0F); emit8(p, 0x93); emit8(p, 0xC1); // setae cl
+                    storeV(p, ECX, 0xF);
+                    break;
+                case 0x6: // 8xy6
+                case 0xE: // 8xyE
+                    loadV(p, EAX, self->superMode ? op2 : op3);
+                    emit8(p, 0x24); emit8(p, op4 == 0x6 ? 0x01 : 0x80); // and al
+                    storeV(p, EAX, 0xF);
+                    if (self->superMode) {
+                        // shr / shl byte [Vx], 1
+                        emit8(p, 0xD0); emitMem(p, op4 == 0x6 ? 5 : 4, OFF_V(op2));
+                    } else {
+                        loadV(p, EAX, op3);
+                        // shr / shl al, 1
+                        emit8(p, 0xD0); emit8(p, op4 == 0x6 ? 0xE8 : 0xE0);
+                        storeV(p, EAX, op2);
+                    }
+                    break;
+                default:
+                    return EMIT_NONE;
+            }
+            break;
+        case 0xA: // Annn: mov word [I], nnn
+            emit8(p, 0x66); emit8(p, 0xC7); emitMem(p, 0, OFF_I); emit16(p, nnn);
+            break;
+        case 0xB: // Bnnn
+            loadV(p, EAX, 0x0);
+            // lea ecx, [rax + nnn]
+            emit8(p, 0x8D); emit8(p, 0x88); emit32(p, nnn);
+            ++e->pending;
+            emitRetire(e);
+            emitIndirect(e);
+            return EMIT_END;
+        case 0xC: // Cxnn
+        case 0xD: // Dxyn
+            goto helper;
+        case 0xE: // Ex9E / ExA1: test the bit of key Vx
+            if (op34 != 0x9E && op34 != 0xA1) {
+                return EMIT_NONE;
+            }
+            ++e->pending;
+            emitRetire(e);
+            loadV(p, EAX, op2);
+            emit8(p, 0x83); emit8(p, 0xE0); emit8(p, 0x0F); // and eax, 15
+            // movzx ecx, word [keys]; bt ecx, eax
+            emit8(p, 0x0F); emit8(p, 0xB7); emitMem(p, ECX, OFF_KEYS);
+            emit8(p, 0x0F); emit8(p, 0xA3); emit8(p, 0xC1);
+            emitSkip(e, pc, op34 == 0x9E ? 0x72 : 0x73); // jc / jnc
+            return EMIT_END;
+        case 0xF:
+            switch (op34) {
+                case 0x07: // Fx07: Vx = D
+                    emit8(p, 0x0F); emit8(p, 0xB6); emitMem(p, EAX, OFF_D);
+                    storeV(p, EAX, op2);
+                    break;
+                case 0x15: // Fx15: D = Vx
+                    loadV(p, EAX, op2);
+                    emit8(p, 0x88); emitMem(p, EAX, OFF_D);
+                    break;
+                case 0x1E: // Fx1E: add word [I], ax
+                    loadV(p, EAX, op2);
+                    emit8(p, 0x66); emit8(p, 0x01); emitMem(p, EAX, OFF_I);
+                    break;
+                case 0x33: // Fx33: ram[I...I+2] = decimal digits of Vx
+                    emitRamCheck(e, pc, 3);
+                    loadV(p, ECX, op2);
+                    // Hundreds: edx = ecx * 41 >> 12
+                    emit8(p, 0x6B); emit8(p, 0xD1); emit8(p, 41);
+                    emit8(p, 0xC1); emit8(p, 0xEA); emit8(p, 12);
+                    emit8(p, 0x88); emit8(p, 0x94); emit8(p, 0x03);
+                    emit32(p, OFF_RAM);
+                    // ecx -= edx * 100, then tens: edx = ecx * 205 >> 11
+                    emit8(p, 0x6B); emit8(p, 0xD2); emit8(p, 100);
+                    emit8(p, 0x29); emit8(p, 0xD1);
+                    emit8(p, 0x69); emit8(p, 0xD1); emit32(p, 205);
+                    emit8(p, 0xC1); emit8(p, 0xEA); emit8(p, 11);
+                    emit8(p, 0x88); emit8(p, 0x94); emit8(p, 0x03);
+                    emit32(p, OFF_RAM + 1);
+                    // Ones: ecx -= edx * 10
+                    emit8(p, 0x8D); emit8(p, 0x14); emit8(p, 0x92);
+                    emit8(p, 0x01); emit8(p, 0xD2);
+                    emit8(p, 0x29); emit8(p, 0xD1);
+                    emit8(p, 0x88); emit8(p, 0x8C); emit8(p, 0x03);
+                    emit32(p, OFF_RAM + 2);
+                    emitWritten(e, pc, 3);
+                    return EMIT_HELPER;
+                case 0x55: // Fx55: ram[I...] = V0...V(x-1)
+                case 0x65: // Fx65: V0...V(x-1) = ram[I...]
+                    emitRamCheck(e, pc, op2);
+                    emitMoves(p, op2, op34 == 0x55);
+                    if (!self->superMode && op2 > 0) {
+                        // add word [I], x
+                        emit8(p, 0x66); emit8(p, 0x83); emitMem(p, 0, OFF_I);
+                        emit8(p, op2);
+                    }
+                    if (op34 == 0x55) {
+                        emitWritten(e, pc, op2);
+                        return EMIT_HELPER;
+                    }
+                    break;
+                case 0x18: case 0x29: case 0x30: case 0x75: case 0x85:
+                    goto helper;
+                default:
+                    return EMIT_NONE;
+            }
+            break;
+    }
+    ++e->pending;
+    return EMIT_NATIVE;
+
+helper:
+    // Run the instruction through Chip8_advance with the cycle count in
+    // memory up to date, and leave if that dropped the translated code
+    emitRetire(e);
+    emit8(p, 0x4C); emit8(p, 0x89); emitMem(p, R12, OFF_CYCLES);
+    emit8(p, 0x48); emit8(p, 0x89); emit8(p, 0xDF);     // mov rdi, rbx
+    emit8(p, 0xBE); emit32(p, pc);                      // mov esi, pc
+    emit8(p, 0x48); emit8(p, 0xB8);                     // mov rax, helper
+    emit64(p, (uint64_t) (uintptr_t) &Chip8Jit_helper);
+    emit8(p, 0xFF); emit8(p, 0xD0);                     // call rax
+    emit8(p, 0x4C); emit8(p, 0x8B); emitMem(p, R12, OFF_CYCLES);
+    emit8(p, 0x85); emit8(p, 0xC0);                     // test eax, eax
+    emit8(p, 0x74); emit8(p, 0); ok = *p;               // jz next
+    emit8(p, 0x31); emit8(p, 0xC0);                     // xor eax, eax
+    emitJump(p, e->jit->code + e->jit->exit);
+    patchShort(ok, *p);
+    return EMIT_HELPER;
+}
+
+/*
+ * Mark ram[addr, addr + len) as translated
+ */
+static void Chip8Jit_cover(struct Chip8Jit *jit, int addr, int len) {
+    if (addr + len > 4096) {
+        len = 4096 - addr;
+    }
+    memset(jit->covered + addr, 1, len);
+    if (addr < jit->low) {
+        jit->low = addr;
+    }
+    if (addr + len > jit->high) {
+        jit->high = addr + len;
+    }
+}
+
+/*
+ * Whether a 1nnn at pc jumping back to target can close one of the idle
+ * loops Chip8_skipIdle looks for, going by the instructions in between
+ * (covered from then on, so that rewriting them drops this translation)
+ */
+static bool Chip8Jit_mayIdle(struct Chip8Jit *jit, const Chip8Proc *self,
+        uint16_t pc, uint16_t target) {
+    if (target > pc || pc - target > 4) {
+        return false;
+    }
+    Chip8Jit_cover(jit, target, pc - target);
+    uint16_t op = self->ram[target] << 8 | self->ram[target + 1],
+             x = op >> 8 & 0xF;
+    switch (pc - target) {
+        case 0: // 1nnn to itself
+            return true;
+        case 2: // Ex9E or ExA1, 1nnn back
+            return (op & 0xF0FF) == 0xE09E || (op & 0xF0FF) == 0xE0A1;
+        case 4: // Fx07, 3x00, 1nnn back
+            return (op & 0xF0FF) == 0xF007
+                && self->ram[target + 2] == (0x30 | x)
+                && self->ram[target + 3] == 0x00;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Execute the instruction at pc with the interpreter on behalf of a block.
+ * Returns nonzero if the block calling it must stop: its code was dropped
+ * or the instruction trapped.
+ */
+static uint32_t Chip8Jit_helper(Chip8Proc *self, uint32_t pc) {
+    self->PC = pc;
+    self->jit->flushed = false;
+    return !Chip8_advance(self) || self->jit->flushed;
+}
+
+/*
+ * Drop what the processor has cached of ram[addr, addr + len), which a
+ * block has just written.
+ * Returns nonzero if that dropped the translated code.
+ */
+static uint32_t Chip8Jit_written(Chip8Proc *self, uint32_t addr,
+        uint32_t len) {
+    self->jit->flushed = false;
+    Chip8_invalidate(self, addr, len);
+    return self->jit->flushed;
+}
+
+#else
+
+bool Chip8Jit_enable(Chip8Proc *self) {
+    (void) self;
+    return false;
+}
+
+void Chip8Jit_disable(Chip8Proc *self) {
+    (void) self;
+}
+
+bool Chip8Jit_execute(Chip8Proc *self, uint64_t budget) {
+    (void) self;
+    (void) budget;
+    return true;
+}
+
+void Chip8Jit_invalidate(Chip8Proc *self, int addr, int len) {
+    (void) self;
+    (void) addr;
+    (void) len;
+}
+
+#endif
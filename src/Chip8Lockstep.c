@@ -0,0 +1,588 @@
+#include <string.h>
+
+#include "Chip8Lockstep.h"
+
+// What an instruction run per lane reads or writes of the state kept here:
+// bit r for Vr, then I and the shared stack
+#define USES_V(r)   (1u << (r))
+#define USES_I      (1u << 16)
+#define USES_STACK  (1u << 17)
+#define USES_ALL    ((USES_STACK << 1) - 1)
+
+static void Chip8Lockstep_stepConverged(Chip8Lockstep *self);
+static void Chip8Lockstep_stepLanes(Chip8Lockstep *self);
+static void Chip8Lockstep_stepDiverged(Chip8Lockstep *self);
+static void Chip8Lockstep_skip(Chip8Lockstep *self, Chip8Lane8 taken);
+static bool Chip8Lockstep_transfer(Chip8Lockstep *self, int x, uint8_t kind,
+        bool superMode);
+static void Chip8Lockstep_diverge(Chip8Lockstep *self);
+static void Chip8Lockstep_tryConverge(Chip8Lockstep *self);
+static void Chip8Lockstep_flushCycles(Chip8Lockstep *self);
+static void Chip8Lockstep_gather(Chip8Lockstep *self, int lane,
+        uint32_t uses);
+static void Chip8Lockstep_scatter(Chip8Lockstep *self, int lane,
+        uint32_t uses);
+static void Chip8Lockstep_uses(const uint8_t *op, uint32_t *reads,
+        uint32_t *writes);
+static bool Chip8Lockstep_none(Chip8Lane8 mask);
+static bool Chip8Lockstep_sameOpcode(const Chip8Lockstep *self);
+static void Chip8Lockstep_stores(Chip8Lockstep *self, const Chip8Proc *proc,
+        const uint8_t *op);
+static void Chip8Lockstep_stored(Chip8Lockstep *self, int addr, int len);
+
+void Chip8Lockstep_init(Chip8Lockstep *self, Chip8Proc **procs, int count) {
+    memset(self, 0, sizeof(*self));
+    for (int lane = 0; lane < count && lane < CHIP8_LANES; ++lane) {
+        self->procs[lane] = procs[lane];
+        self->active[lane] = 0xFF;
+    }
+    Chip8Lockstep_tryConverge(self);
+}
+
+bool Chip8Lockstep_execute(Chip8Lockstep *self, uint64_t budget) {
+    for (; budget > 0; --budget) {
+        if (Chip8Lockstep_none(self->active)) {
+            return false;
+        }
+        if (self->converged) {
+            Chip8Lockstep_stepConverged(self);
+        } else {
+            Chip8Lockstep_stepDiverged(self);
+        }
+    }
+    return !Chip8Lockstep_none(self->active);
+}
+
+void Chip8Lockstep_sync(Chip8Lockstep *self) {
+    if (!self->converged) {
+        return;
+    }
+    Chip8Lockstep_flushCycles(self);
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (self->active[lane]) {
+            Chip8Lockstep_scatter(self, lane, USES_ALL);
+            self->procs[lane]->PC = self->PC;
+        }
+    }
+}
+
+/*
+ * Run one instruction for every lane at the shared PC
+ */
+static void Chip8Lockstep_stepConverged(Chip8Lockstep *self) {
+    uint16_t pc = self->PC;
+    if (pc > 0xFFE || (pc + 2 > self->storedLow && pc < self->storedHigh
+                && !Chip8Lockstep_sameOpcode(self))) {
+        Chip8Lockstep_diverge(self);
+        Chip8Lockstep_stepDiverged(self);
+        return;
+    }
+
+    // Any running lane's ram holds the same opcode
+    const Chip8Proc *lead = NULL;
+    for (int lane = 0; lead == NULL; ++lane) {
+        if (self->active[lane]) { lead = self->procs[lane]; }
+    }
+    uint8_t op12 = lead->ram[pc], op34 = lead->ram[pc + 1];
+    uint8_t op1 = op12 >> 4,
+            op2 = op12 & 0x0F,
+            op3 = op34 >> 4,
+            op4 = op34 & 0x0F;
+    Chip8Lane8 *V = self->V;
+    bool superMode = lead->superMode;
+
+    switch (op1) {
+        case 0x0:
+            // 00EE, unless the stack is empty or each lane has its own
+            if (op12 == 0x00 && op34 == 0xEE && self->stackShared
+                    && self->SC >= 0) {
+                self->PC = self->stack[self->SC--] + 2;
+                break;
+            }
+            Chip8Lockstep_stepLanes(self);
+            return;
+        case 0x1: // 1nnn
+            self->PC = op2 << 8 | op34;
+            break;
+        case 0x2: // 2nnn, unless the stack is full or each lane has its own
+            if (self->stackShared && self->SC < 15) {
+                self->stack[++self->SC] = pc;
+                self->PC = op2 << 8 | op34;
+                break;
+            }
+            Chip8Lockstep_stepLanes(self);
+            return;
+        case 0x3: // 3xnn
+            Chip8Lockstep_skip(self, (Chip8Lane8) (V[op2] == op34));
+            break;
+        case 0x4: // 4xnn
+            Chip8Lockstep_skip(self, (Chip8Lane8) (V[op2] != op34));
+            break;
+        case 0x5: // 5xy0
+        case 0x9: // 9xy0
+            if (op4 != 0x0) {
+                Chip8Lockstep_stepLanes(self);
+                return;
+            }
+            Chip8Lockstep_skip(self, op1 == 0x5
+                    ? (Chip8Lane8) (V[op2] == V[op3])
+                    : (Chip8Lane8) (V[op2] != V[op3]));
+            break;
+        case 0x6: // 6xnn
+            V[op2] = (Chip8Lane8) {0} + op34;
+            self->PC += 2;
+            break;
+        case 0x7: // 7xnn
+            V[op2] += op34;
+            self->PC += 2;
+            break;
+        case 0x8: {
+            // Same statement order as Chip8_advance, so x == F behaves alike
+            Chip8Lane8 old, y;
+            switch (op4) {
+                case 0x0: V[op2] = V[op3]; break;
+                case 0x1: V[op2] |= V[op3]; break;
+                case 0x2: V[op2] &= V[op3]; break;
+                case 0x3: V[op2] ^= V[op3]; break;
+                case 0x4: // Vf = Vx + Vy >= 255
+                    // Both read before Vf is written, as y may be F
+                    old = V[op2];
+                    y = V[op3];
+                    V[0xF] = (Chip8Lane8) (old >= 255 - y) & 1;
+                    V[op2] = old + y;
+                    break;
+                case 0x5:
+                    old = V[op2];
+                    V[op2] -= V[op3];
+                    V[0xF] = (Chip8Lane8) (old >= V[op2]) & 1;
+                    break;
+                case 0x6:
+                    if (superMode) {
+                        V[0xF] = V[op2] & 1;
+                        V[op2] >>= 1;
+                    } else {
+                        V[0xF] = V[op3] & 1;
+                        V[op2] = V[op3] >> 1;
+                    }
+                    break;
+                case 0x7:
+                    old = V[op3];
+                    V[op2] = V[op3] - V[op2];
+                    V[0xF] = (Chip8Lane8) (old >= V[op2]) & 1;
+                    break;
+                case 0xE:
+                    if (superMode) {
+                        V[0xF] = V[op2] & 0x80;
+                        V[op2] <<= 1;
+                    } else {
+                        V[0xF] = V[op3] & 0x80;
+                        V[op2] = V[op3] << 1;
+                    }
+                    break;
+                default:
+                    Chip8Lockstep_stepLanes(self);
+                    return;
+            }
+            self->PC += 2;
+            break;
+        }
+        case 0xA: // Annn
+            self->I = (Chip8Lane16) {0} + (uint16_t) (op2 << 8 | op34);
+            self->PC += 2;
+            break;
+        case 0xF:
+            if (op34 == 0x1E) { // Fx1E
+                self->I += __builtin_convertvector(V[op2], Chip8Lane16);
+                self->PC += 2;
+                break;
+            }
+            if (op34 == 0x29) { // Fx29
+                self->I = CHIP8_FONT_5_START
+                    + 5 * __builtin_convertvector(V[op2] & 0xF, Chip8Lane16);
+                self->PC += 2;
+                break;
+            }
+            // Fx33, Fx55, Fx65
+            if ((op34 == 0x33 || op34 == 0x55 || op34 == 0x65)
+                    && Chip8Lockstep_transfer(self, op2, op34, superMode)) {
+                self->PC += 2;
+                break;
+            }
+            Chip8Lockstep_stepLanes(self);
+            return;
+        default:
+            Chip8Lockstep_stepLanes(self);
+            return;
+    }
+    // A skip that split the lanes already retired itself in each proc
+    if (self->converged) {
+        ++self->pendingCycles;
+    }
+    ++self->vectorSteps;
+}
+
+/*
+ * Run the instruction at the shared PC through Chip8_advance, lane by lane,
+ * copying to each lane's proc only what the instruction reads, and back
+ * only what it writes
+ */
+static void Chip8Lockstep_stepLanes(Chip8Lockstep *self) {
+    uint16_t pc = self->PC;
+    // Copied before running, as the instruction may overwrite itself
+    uint8_t op[2];
+    uint32_t reads = USES_ALL, writes = USES_ALL;
+    bool any = false;
+    int next = -1;
+    bool same = true;
+    Chip8Lockstep_flushCycles(self);
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        Chip8Proc *proc = self->procs[lane];
+        if (!any) {
+            memcpy(op, proc->ram + pc, sizeof(op));
+            Chip8Lockstep_uses(op, &reads, &writes);
+            any = true;
+        }
+        proc->PC = pc;
+        Chip8Lockstep_scatter(self, lane, reads);
+        Chip8Lockstep_stores(self, proc, op);
+        if (!Chip8_advance(proc) || proc->waitKey >= 0) {
+            // The proc keeps the final state of a stopped lane, which
+            // either trapped or waits with no register written yet
+            Chip8Lockstep_scatter(self, lane, USES_ALL);
+            self->active[lane] = 0;
+            continue;
+        }
+        Chip8Lockstep_gather(self, lane, writes);
+        if (next >= 0 && proc->PC != next) { same = false; }
+        next = proc->PC;
+    }
+    ++self->laneSteps;
+    if (same && next >= 0) {
+        self->PC = next;
+    } else {
+        // Each running proc is up to date but for what the instruction
+        // left alone
+        for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+            if (self->active[lane]) {
+                Chip8Lockstep_scatter(self, lane, USES_ALL & ~writes);
+            }
+        }
+        self->converged = false;
+    }
+}
+
+/*
+ * Step each running lane on its own, then regroup if they meet
+ */
+static void Chip8Lockstep_stepDiverged(Chip8Lockstep *self) {
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        Chip8Proc *proc = self->procs[lane];
+        // A lane storing on its own leaves its ram unlike the others' once
+        // they converge again
+        if (proc->PC <= 0xFFE) {
+            Chip8Lockstep_stores(self, proc, proc->ram + proc->PC);
+        }
+        if (!Chip8_advance(proc) || proc->waitKey >= 0) {
+            self->active[lane] = 0;
+        }
+    }
+    ++self->divergedSteps;
+    Chip8Lockstep_tryConverge(self);
+}
+
+/*
+ * Finish a skip whose condition held in the lanes set in taken
+ */
+static void Chip8Lockstep_skip(Chip8Lockstep *self, Chip8Lane8 taken) {
+    taken &= self->active;
+    if (Chip8Lockstep_none(taken)) {
+        self->PC += 2;
+    } else if (Chip8Lockstep_none(taken ^ self->active)) {
+        self->PC += 4;
+    } else {
+        uint16_t pc = self->PC;
+        Chip8Lockstep_diverge(self);
+        for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+            if (self->active[lane]) {
+                self->procs[lane]->PC = pc + (taken[lane] ? 4 : 2);
+                // Retire the skip itself
+                ++self->procs[lane]->cycles;
+            }
+        }
+    }
+}
+
+/*
+ * Run Fx33, Fx55 or Fx65 (kind is its low byte) between the vector
+ * registers and each running lane's ram.
+ * Returns false, changing nothing, if a lane's I is too close to the end
+ * of ram, for Chip8_advance to trap on it.
+ */
+static bool Chip8Lockstep_transfer(Chip8Lockstep *self, int x, uint8_t kind,
+        bool superMode) {
+    int len = kind == 0x33 ? 3 : x;
+    int low = 4096, high = 0;
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        int addr = self->I[lane];
+        if (addr + len > 4096) {
+            return false;
+        }
+        low = addr < low ? addr : low;
+        high = addr > high ? addr : high;
+    }
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        Chip8Proc *proc = self->procs[lane];
+        uint8_t *ram = proc->ram + self->I[lane];
+        if (kind == 0x33) {
+            int val = self->V[x][lane];
+            ram[0] = val / 100;
+            ram[1] = val / 10 % 10;
+            ram[2] = val % 10;
+        } else if (kind == 0x55) {
+            for (int i = 0; i < x; ++i) {
+                ram[i] = self->V[i][lane];
+            }
+        } else {
+            for (int i = 0; i < x; ++i) {
+                self->V[i][lane] = ram[i];
+            }
+        }
+        if (kind != 0x65) {
+            Chip8_invalidate(proc, self->I[lane], len);
+        }
+    }
+    // Each lane may have stored values of its own
+    if (kind != 0x65 && len > 0) {
+        Chip8Lockstep_stored(self, low, high + len - low);
+    }
+    if (kind != 0x33 && !superMode) {
+        self->I += (uint16_t) x;
+    }
+    return true;
+}
+
+/*
+ * Hand every running lane's state back to its proc and stop vectorizing
+ */
+static void Chip8Lockstep_diverge(Chip8Lockstep *self) {
+    Chip8Lockstep_sync(self);
+    self->converged = false;
+}
+
+/*
+ * Switch to vector execution if every running lane is at the same PC
+ */
+static void Chip8Lockstep_tryConverge(Chip8Lockstep *self) {
+    int pc = -1;
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        if (pc >= 0 && self->procs[lane]->PC != pc) {
+            return;
+        }
+        pc = self->procs[lane]->PC;
+    }
+    if (pc < 0) {
+        return;
+    }
+    // The lanes share a stack if they all arrived with the same one
+    const Chip8Proc *lead = NULL;
+    self->stackShared = true;
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        const Chip8Proc *proc = self->procs[lane];
+        if (lead == NULL) {
+            lead = proc;
+        } else if (proc->SC != lead->SC || (proc->SC >= 0
+                    && memcmp(proc->stack, lead->stack,
+                        (proc->SC + 1) * sizeof(proc->stack[0])) != 0)) {
+            self->stackShared = false;
+        }
+        Chip8Lockstep_gather(self, lane, USES_ALL & ~USES_STACK);
+    }
+    if (self->stackShared) {
+        self->SC = lead->SC;
+        memcpy(self->stack, lead->stack, sizeof(self->stack));
+    }
+    self->PC = pc;
+    self->converged = true;
+}
+
+/*
+ * Credit the vector steps run so far to every running lane
+ */
+static void Chip8Lockstep_flushCycles(Chip8Lockstep *self) {
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (self->active[lane]) {
+            self->procs[lane]->cycles += self->pendingCycles;
+        }
+    }
+    self->pendingCycles = 0;
+}
+
+/*
+ * Load what uses names of a lane's V and I from its proc (the shared stack
+ * is only ever loaded by Chip8Lockstep_tryConverge)
+ */
+static void Chip8Lockstep_gather(Chip8Lockstep *self, int lane,
+        uint32_t uses) {
+    const Chip8Proc *proc = self->procs[lane];
+    for (uint32_t v = uses & 0xFFFF; v != 0; v &= v - 1) {
+        int r = __builtin_ctz(v);
+        self->V[r][lane] = proc->V[r];
+    }
+    if (uses & USES_I) {
+        self->I[lane] = proc->I;
+    }
+}
+
+/*
+ * Store what uses names of a lane's V, I and the shared stack into its proc
+ */
+static void Chip8Lockstep_scatter(Chip8Lockstep *self, int lane,
+        uint32_t uses) {
+    Chip8Proc *proc = self->procs[lane];
+    for (uint32_t v = uses & 0xFFFF; v != 0; v &= v - 1) {
+        int r = __builtin_ctz(v);
+        proc->V[r] = self->V[r][lane];
+    }
+    if (uses & USES_I) {
+        proc->I = self->I[lane];
+    }
+    if (uses & USES_STACK && self->stackShared) {
+        proc->SC = self->SC;
+        memcpy(proc->stack, self->stack, sizeof(proc->stack));
+    }
+}
+
+/*
+ * Set reads and writes to what the instruction op reads and writes of the
+ * state kept in a group when Chip8_advance runs it
+ */
+static void Chip8Lockstep_uses(const uint8_t *op, uint32_t *reads,
+        uint32_t *writes) {
+    int x = op[0] & 0xF, y = op[1] >> 4;
+    uint32_t below = USES_V(x) - 1;
+    *reads = *writes = 0;
+    switch (op[0] >> 4) {
+        case 0x0: // 00EE; the other system instructions use none
+            if (op[0] == 0x00 && op[1] == 0xEE) {
+                *reads = *writes = USES_STACK;
+            }
+            return;
+        case 0x2: // 2nnn
+            *reads = *writes = USES_STACK;
+            return;
+        case 0xB: // Bnnn
+            *reads = USES_V(0);
+            return;
+        case 0xC: // Cxnn
+            *writes = USES_V(x);
+            return;
+        case 0xD: // Dxyn
+            *reads = USES_V(x) | USES_V(y) | USES_I;
+            *writes = USES_V(0xF);
+            return;
+        case 0xE: // Ex9E, ExA1
+            *reads = USES_V(x);
+            return;
+        case 0xF:
+            switch (op[1]) {
+                case 0x07: *writes = USES_V(x); return;
+                case 0x15: case 0x18: *reads = USES_V(x); return;
+                case 0x1E: *reads = USES_V(x) | USES_I; *writes = USES_I;
+                           return;
+                case 0x29: case 0x30: *reads = USES_V(x); *writes = USES_I;
+                           return;
+                case 0x33: *reads = USES_V(x) | USES_I; return;
+                case 0x55: *reads = below | USES_I; *writes = USES_I; return;
+                case 0x65: *reads = USES_I; *writes = below | USES_I; return;
+                case 0x75: case 0x85: *reads = *writes = below; return;
+            }
+            // Fx0A writes Vx only once a key arrives, to the stopped lane's
+            // proc; anything else traps
+            return;
+    }
+    *reads = *writes = USES_ALL;
+}
+
+/*
+ * True if no lane of mask is set
+ */
+static bool Chip8Lockstep_none(Chip8Lane8 mask) {
+    uint64_t words[CHIP8_LANES / 8], any = 0;
+    memcpy(words, &mask, sizeof(words));
+    for (int i = 0; i < CHIP8_LANES / 8; ++i) {
+        any |= words[i];
+    }
+    return any == 0;
+}
+
+/*
+ * True if every running lane has the same opcode at the shared PC
+ */
+static bool Chip8Lockstep_sameOpcode(const Chip8Lockstep *self) {
+    const uint8_t *first = NULL;
+    for (int lane = 0; lane < CHIP8_LANES; ++lane) {
+        if (!self->active[lane]) {
+            continue;
+        }
+        const uint8_t *op = self->procs[lane]->ram + self->PC;
+        if (first == NULL) {
+            first = op;
+        } else if (op[0] != first[0] || op[1] != first[1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Widen the range of stored ram by what op stores when proc runs it: Fx33
+ * and Fx55 store at I
+ */
+static void Chip8Lockstep_stores(Chip8Lockstep *self, const Chip8Proc *proc,
+        const uint8_t *op) {
+    if (op[0] >> 4 != 0xF || (op[1] != 0x33 && op[1] != 0x55)) {
+        return;
+    }
+    int len = op[1] == 0x33 ? 3 : (op[0] & 0xF);
+    if (proc->I + len <= 4096) {
+        Chip8Lockstep_stored(self, proc->I, len);
+    }
+}
+
+/*
+ * Widen the range of stored ram to cover ram[addr, addr + len)
+ */
+static void Chip8Lockstep_stored(Chip8Lockstep *self, int addr, int len) {
+    if (len == 0) {
+        return;
+    }
+    if (self->storedLow >= self->storedHigh) {
+        self->storedLow = addr;
+        self->storedHigh = addr + len;
+        return;
+    }
+    if (addr < self->storedLow) {
+        self->storedLow = addr;
+    }
+    if (addr + len > self->storedHigh) {
+        self->storedHigh = addr + len;
+    }
+}
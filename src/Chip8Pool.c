@@ -0,0 +1,90 @@
+#include <string.h>
+
+#include "Chip8Jit.h"
+#include "Chip8Pool.h"
+#include "Guards.h"
+
+/*
+ * One allocation of processors, each on cache lines of its own
+ */
+typedef struct Chip8PoolSlab {
+    struct Chip8PoolSlab *next;
+    Chip8Proc procs[];
+} Chip8PoolSlab;
+
+static Chip8Proc *Chip8Pool_carve(Chip8Pool *self);
+
+void Chip8Pool_init(Chip8Pool *self, size_t slabSize,
+        void (*presentFrame)(uint64_t screen[64][2], uint64_t dirtyRows),
+        void (*setSound)(bool isPlaying, Chip8Proc *self),
+        bool superMode) {
+    Chip8_initAt(&self->fresh, NULL, 0, presentFrame, setSound,
+            superMode);
+    self->slabs = NULL;
+    self->slabUsed = 0;
+    self->slabSize = slabSize != 0 ? slabSize : CHIP8_POOL_DEFAULT_SLAB;
+    self->released = NULL;
+    self->releasedCount = 0;
+    self->capacity = 0;
+}
+
+Chip8Proc *Chip8Pool_acquire(Chip8Pool *self, const uint8_t *program,
+        size_t progSize) {
+    Chip8Proc *proc;
+    if (self->releasedCount > 0) {
+        proc = self->released[--self->releasedCount];
+    } else {
+        // Never used: a copy of fresh is what Chip8_reset expects
+        proc = Chip8Pool_carve(self);
+        memcpy(proc, &self->fresh, sizeof(Chip8Proc));
+    }
+    Chip8_reset(proc, &self->fresh, program, progSize);
+    return proc;
+}
+
+void Chip8Pool_release(Chip8Pool *self, Chip8Proc *proc) {
+    // There is room for every processor carved out
+    self->released[self->releasedCount++] = proc;
+}
+
+void Chip8Pool_free(Chip8Pool *self) {
+    size_t used = self->slabUsed;
+    while (self->slabs != NULL) {
+        Chip8PoolSlab *slab = self->slabs;
+        for (size_t p = 0; p < used; ++p) {
+            Chip8Jit_disable(&slab->procs[p]);
+        }
+        self->slabs = slab->next;
+        free(slab);
+        // Older slabs were carved out completely
+        used = self->slabSize;
+    }
+    free(self->released);
+    self->released = NULL;
+    self->releasedCount = 0;
+    self->capacity = 0;
+    self->slabUsed = 0;
+}
+
+/*
+ * Take a processor never handed out before, from the newest slab or a new
+ * one
+ */
+static Chip8Proc *Chip8Pool_carve(Chip8Pool *self) {
+    if (self->slabs == NULL || self->slabUsed == self->slabSize) {
+        // Chip8Proc is aligned to a cache line, so both sizes are multiples
+        // of one, as aligned_alloc requires
+        Chip8PoolSlab *slab = OOM_GUARD(aligned_alloc(_Alignof(Chip8Proc),
+                    sizeof(Chip8PoolSlab)
+                    + self->slabSize * sizeof(Chip8Proc)),
+                __FILE__, __LINE__);
+        slab->next = self->slabs;
+        self->slabs = slab;
+        self->slabUsed = 0;
+        self->capacity += self->slabSize;
+        self->released = OOM_GUARD(realloc(self->released,
+                    self->capacity * sizeof(Chip8Proc *)),
+                __FILE__, __LINE__);
+    }
+    return &self->slabs->procs[self->slabUsed++];
+}
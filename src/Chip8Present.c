@@ -0,0 +1,203 @@
+#define _GNU_SOURCE // syscall
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "Chip8Input.h"
+#include "Chip8Present.h"
+
+#define NS_PER_SEC 1000000000ULL
+// Longest the render thread sleeps before checking whether to stop
+#define IDLE_NS (50 * 1000000ULL)
+#define SLOT_MASK 0x3
+
+static void *Chip8Presenter_main(void *arg);
+static bool Chip8Presenter_take(Chip8Presenter *self);
+static void Chip8Presenter_renderFront(Chip8Presenter *self);
+static void Chip8Presenter_wait(Chip8Presenter *self, uint64_t deadline);
+static void Chip8Presenter_sleep(Chip8Presenter *self, uint32_t sequence,
+        uint64_t deadline);
+static void Chip8Presenter_wake(Chip8Presenter *self);
+
+bool Chip8Presenter_open(Chip8Presenter *self, unsigned refreshHz,
+        void (*render)(Chip8Frame *frame, void *context), void *context) {
+    memset(self, 0, sizeof(*self));
+    self->back = 0;
+    atomic_init(&self->middle, 1);
+    self->front = 2;
+    self->interval = refreshHz != 0 ? NS_PER_SEC / refreshHz : 0;
+    self->render = render;
+    self->context = context;
+    int error = pthread_create(&self->thread, NULL, Chip8Presenter_main,
+            self);
+    if (error != 0) {
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+void Chip8Presenter_publish(Chip8Presenter *self, uint64_t screen[64][2],
+        uint64_t cycles) {
+    Chip8Frame *frame = &self->frames[self->back];
+    memcpy(frame->screen, screen, sizeof(frame->screen));
+    frame->cycles = cycles;
+    frame->stamp = Chip8Input_now();
+    // Release the frame to the render thread, and take back whichever
+    // slot it left in the middle
+    uint32_t old = atomic_exchange_explicit(&self->middle,
+            self->back | CHIP8_FRAME_FRESH, memory_order_acq_rel);
+    self->back = old & SLOT_MASK;
+    if (old & CHIP8_FRAME_FRESH) {
+        ++self->dropped;
+    }
+    ++self->published;
+    // Sequentially consistent, so either the render thread sees the new
+    // sequence before sleeping or this sees it asleep
+    atomic_fetch_add(&self->sequence, 1);
+    if (atomic_load(&self->sleeping)) {
+        Chip8Presenter_wake(self);
+    }
+}
+
+void Chip8Presenter_close(Chip8Presenter *self) {
+    atomic_store(&self->stop, true);
+    atomic_fetch_add(&self->sequence, 1);
+    Chip8Presenter_wake(self);
+    pthread_join(self->thread, NULL);
+}
+
+/*
+ * Render thread: render the latest frame whenever one is published, no
+ * sooner than interval after the last, until stopped with none pending
+ */
+static void *Chip8Presenter_main(void *arg) {
+    Chip8Presenter *self = arg;
+    for (;;) {
+        // Read stop first, so a frame published before it is not missed
+        bool stopping = atomic_load(&self->stop);
+        if (Chip8Presenter_take(self)) {
+            // Timed from before rendering, so its cost does not slow the
+            // rate, and an eighth of an interval early, as frames paced at
+            // the refresh rate arrive with some jitter
+            uint64_t due = Chip8Input_now() + self->interval
+                - self->interval / 8;
+            Chip8Presenter_renderFront(self);
+            // Frames published meanwhile collapse into the latest
+            while (!atomic_load(&self->stop) && Chip8Input_now() < due) {
+                Chip8Presenter_sleep(self, atomic_load(&self->sequence),
+                        due);
+            }
+        } else if (stopping) {
+            return NULL;
+        } else {
+            Chip8Presenter_wait(self, Chip8Input_now() + IDLE_NS);
+        }
+    }
+}
+
+/*
+ * Swap the front slot for the middle one if that holds a new frame.
+ * Returns true if it did.
+ */
+static bool Chip8Presenter_take(Chip8Presenter *self) {
+    if (!(atomic_load_explicit(&self->middle, memory_order_relaxed)
+                & CHIP8_FRAME_FRESH)) {
+        return false;
+    }
+    uint32_t old = atomic_exchange_explicit(&self->middle, self->front,
+            memory_order_acq_rel);
+    self->front = old & SLOT_MASK;
+    return true;
+}
+
+/*
+ * Hand the front frame to render with the rows it changes, and account
+ * for its latency, unless it changes nothing
+ */
+static void Chip8Presenter_renderFront(Chip8Presenter *self) {
+    Chip8Frame *frame = &self->frames[self->front];
+    frame->dirtyRows = 0;
+    for (int row = 0; row < 64; ++row) {
+        if (frame->screen[row][0] != self->shown[row][0]
+                || frame->screen[row][1] != self->shown[row][1]) {
+            frame->dirtyRows |= 1ULL << row;
+        }
+    }
+    if (frame->dirtyRows == 0) {
+        ++self->unchanged;
+        return;
+    }
+    memcpy(self->shown, frame->screen, sizeof(self->shown));
+    self->render(frame, self->context);
+    uint64_t latency = Chip8Input_now() - frame->stamp;
+    ++self->presented;
+    self->latencyTotal += latency;
+    if (latency > self->latencyMax) {
+        self->latencyMax = latency;
+    }
+}
+
+/*
+ * Sleep until a frame is published, the presenter is stopped or the
+ * monotonic clock reaches deadline
+ */
+static void Chip8Presenter_wait(Chip8Presenter *self, uint64_t deadline) {
+    atomic_store(&self->sleeping, 1);
+    uint32_t sequence = atomic_load(&self->sequence);
+    if (!(atomic_load(&self->middle) & CHIP8_FRAME_FRESH)
+            && !atomic_load(&self->stop)) {
+        Chip8Presenter_sleep(self, sequence, deadline);
+    }
+    atomic_store(&self->sleeping, 0);
+}
+
+#ifdef __linux__
+
+/*
+ * Block while sequence is unchanged, until deadline on the monotonic clock
+ */
+static void Chip8Presenter_sleep(Chip8Presenter *self, uint32_t sequence,
+        uint64_t deadline) {
+    struct timespec ts = {
+        .tv_sec = deadline / NS_PER_SEC,
+        .tv_nsec = deadline % NS_PER_SEC
+    };
+    // FUTEX_WAIT_BITSET takes an absolute timeout
+    syscall(SYS_futex, (uint32_t *) &self->sequence,
+            FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, sequence, &ts, NULL,
+            FUTEX_BITSET_MATCH_ANY);
+}
+
+static void Chip8Presenter_wake(Chip8Presenter *self) {
+    syscall(SYS_futex, (uint32_t *) &self->sequence,
+            FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, NULL, NULL, 0);
+}
+
+#else
+
+/*
+ * Without futexes, the render thread waits for the deadline
+ */
+static void Chip8Presenter_sleep(Chip8Presenter *self, uint32_t sequence,
+        uint64_t deadline) {
+    (void) self;
+    (void) sequence;
+    struct timespec ts = {
+        .tv_sec = deadline / NS_PER_SEC,
+        .tv_nsec = deadline % NS_PER_SEC
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)
+            == EINTR);
+}
+
+static void Chip8Presenter_wake(Chip8Presenter *self) {
+    (void) self;
+}
+
+#endif
@@ -0,0 +1,213 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+#include "Chip8Profile.h"
+
+#ifdef CHIP8_PROFILE
+
+#include <string.h>
+
+#include "Guards.h"
+
+// Opcode classes, as numbered by Chip8Profile_classify
+static const char *const classNames[] = {
+    "invalid", "00Cn", "00E0", "00EE", "00FB", "00FC", "00FD", "00FE",
+    "00FF", "1nnn", "2nnn", "3xnn", "4xnn", "5xy0", "6xnn", "7xnn",
+    "8xy0", "8xy1", "8xy2", "8xy3", "8xy4", "8xy5", "8xy6", "8xy7",
+    "8xyE", "9xy0", "Annn", "Bnnn", "Cxnn", "Dxyn", "Ex9E", "ExA1",
+    "Fx07", "Fx0A", "Fx15", "Fx18", "Fx1E", "Fx29", "Fx30", "Fx33",
+    "Fx55", "Fx65", "Fx75", "Fx85"
+};
+#define CLASS_COUNT ((int) (sizeof(classNames) / sizeof(classNames[0])))
+
+static int Chip8Profile_classify(uint16_t opcode);
+static int Chip8Profile_lookup(const char *name);
+static void Chip8Profile_sample(Chip8Profile *self, const Chip8Proc *proc);
+
+Chip8Profile *Chip8Profile_create(unsigned samplePeriod) {
+    Chip8Profile *self = OOM_GUARD(calloc(1, sizeof(Chip8Profile)),
+            __FILE__, __LINE__);
+    for (uint32_t opcode = 0; opcode <= 0xFFFF; ++opcode) {
+        self->classOf[opcode] = Chip8Profile_classify(opcode);
+    }
+    self->samplePeriod = samplePeriod;
+    self->untilSample = samplePeriod;
+    // The program itself is the outermost frame
+    self->entries[0] = 0x200;
+    return self;
+}
+
+void Chip8Profile_free(Chip8Profile *self) {
+    free(self);
+}
+
+void Chip8Profile_record(Chip8Profile *self, const Chip8Proc *proc,
+        uint16_t pc, uint16_t opcode, uint64_t ticks) {
+    int c = self->classOf[opcode];
+    ++self->count[c];
+    self->ticks[c] += ticks;
+    ++self->pcHits[pc & 0xFFF];
+
+    // Note where the new subroutine starts; stack level n + 1 runs it
+    if (opcode >> 12 == 0x2 && proc->trap == CHIP8_TRAP_NONE) {
+        self->entries[proc->SC + 1] = opcode & 0xFFF;
+    }
+    if (self->samplePeriod != 0 && --self->untilSample == 0) {
+        self->untilSample = self->samplePeriod;
+        Chip8Profile_sample(self, proc);
+    }
+}
+
+const char *Chip8Profile_className(int c) {
+    return c >= 0 && c < CLASS_COUNT ? classNames[c] : NULL;
+}
+
+void Chip8Profile_writeFolded(const Chip8Profile *self, FILE *out) {
+    for (int s = 0; s < CHIP8_PROFILE_STACKS; ++s) {
+        const Chip8ProfileStack *stack = &self->stacks[s];
+        if (stack->samples == 0) {
+            continue;
+        }
+        fputs("main", out);
+        for (int f = 1; f < stack->depth; ++f) {
+            fprintf(out, ";sub_%03X", stack->frames[f]);
+        }
+        fprintf(out, " %llu\n", (unsigned long long) stack->samples);
+    }
+    if (self->otherSamples != 0) {
+        fprintf(out, "main;[other] %llu\n",
+                (unsigned long long) self->otherSamples);
+    }
+}
+
+void Chip8Profile_writeReport(const Chip8Profile *self, const Chip8Proc *proc,
+        int top, FILE *out) {
+    uint64_t totalCount = 0, totalTicks = 0;
+    for (int c = 0; c < CLASS_COUNT; ++c) {
+        totalCount += self->count[c];
+        totalTicks += self->ticks[c];
+    }
+    if (totalCount == 0) {
+        fputs("No instructions profiled\n", out);
+        return;
+    }
+
+    // Opcode classes, most time first
+    int order[64];
+    for (int c = 0; c < CLASS_COUNT; ++c) {
+        order[c] = c;
+    }
+    for (int i = 1; i < CLASS_COUNT; ++i) {
+        for (int j = i; j > 0 && self->ticks[order[j]] > self->ticks[order[j - 1]];
+                --j) {
+            int tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+    fprintf(out, "%-8s %14s %6s %16s %6s %10s\n",
+            "class", "count", "%", "ticks", "%", "ticks/op");
+    for (int i = 0; i < CLASS_COUNT && self->count[order[i]] != 0; ++i) {
+        int c = order[i];
+        fprintf(out, "%-8s %14llu %5.1f%% %16llu %5.1f%% %10.1f\n",
+                classNames[c], (unsigned long long) self->count[c],
+                100.0 * self->count[c] / totalCount,
+                (unsigned long long) self->ticks[c],
+                totalTicks ? 100.0 * self->ticks[c] / totalTicks : 0,
+                (double) self->ticks[c] / self->count[c]);
+    }
+
+    // Hottest addresses, picked out one at a time
+    bool shown[4096] = { false };
+    fprintf(out, "\n%-6s %-6s %14s %6s\n", "addr", "opcode", "count", "%");
+    for (int i = 0; i < top; ++i) {
+        int hottest = -1;
+        for (int pc = 0; pc < 4096; ++pc) {
+            if (!shown[pc] && self->pcHits[pc] != 0 && (hottest < 0
+                        || self->pcHits[pc] > self->pcHits[hottest])) {
+                hottest = pc;
+            }
+        }
+        if (hottest < 0) {
+            break;
+        }
+        shown[hottest] = true;
+        fprintf(out, "%03X    %02X%02X   %14llu %5.1f%%\n", hottest,
+                proc->ram[hottest], proc->ram[(hottest + 1) & 0xFFF],
+                (unsigned long long) self->pcHits[hottest],
+                100.0 * self->pcHits[hottest] / totalCount);
+    }
+}
+
+/*
+ * Opcode class index of an instruction, 0 if it is invalid
+ */
+static int Chip8Profile_classify(uint16_t opcode) {
+    char name[8];
+    uint8_t op1 = opcode >> 12, op4 = opcode & 0xF, op34 = opcode & 0xFF;
+    switch (op1) {
+        case 0x0:
+            if (opcode >> 8 != 0x00) { return 0; }
+            if (op34 >> 4 == 0xC) { return Chip8Profile_lookup("00Cn"); }
+            snprintf(name, sizeof(name), "00%02X", op34);
+            return Chip8Profile_lookup(name);
+        case 0x5:
+        case 0x9:
+            return op4 == 0 ? Chip8Profile_lookup(op1 == 5 ? "5xy0" : "9xy0")
+                : 0;
+        case 0x8:
+            snprintf(name, sizeof(name), "8xy%X", op4);
+            return Chip8Profile_lookup(name);
+        case 0xE:
+        case 0xF:
+            snprintf(name, sizeof(name), "%Xx%02X", op1, op34);
+            return Chip8Profile_lookup(name);
+        default: {
+            static const char *const fixed[16] = {
+                [0x1] = "1nnn", [0x2] = "2nnn", [0x3] = "3xnn",
+                [0x4] = "4xnn", [0x6] = "6xnn", [0x7] = "7xnn",
+                [0xA] = "Annn", [0xB] = "Bnnn", [0xC] = "Cxnn",
+                [0xD] = "Dxyn"
+            };
+            return Chip8Profile_lookup(fixed[op1]);
+        }
+    }
+}
+
+/*
+ * Index of the opcode class called name, 0 (invalid) if there is none
+ */
+static int Chip8Profile_lookup(const char *name) {
+    for (int c = 1; c < CLASS_COUNT; ++c) {
+        if (strcmp(classNames[c], name) == 0) {
+            return c;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Count one sample of the current call stack
+ */
+static void Chip8Profile_sample(Chip8Profile *self, const Chip8Proc *proc) {
+    Chip8ProfileStack key = { .depth = proc->SC + 2 };
+    memcpy(key.frames, self->entries, key.depth * sizeof(uint16_t));
+    uint32_t hash = 2166136261u;
+    for (int f = 0; f < key.depth; ++f) {
+        hash = (hash ^ key.frames[f]) * 16777619u;
+    }
+    // Open addressing; a slot with no samples is free
+    for (int probe = 0; probe < CHIP8_PROFILE_STACKS; ++probe) {
+        Chip8ProfileStack *slot =
+            &self->stacks[(hash + probe) % CHIP8_PROFILE_STACKS];
+        if (slot->samples == 0) {
+            *slot = key;
+        } else if (slot->depth != key.depth || memcmp(slot->frames,
+                    key.frames, key.depth * sizeof(uint16_t)) != 0) {
+            continue;
+        }
+        ++slot->samples;
+        return;
+    }
+    ++self->otherSamples;
+}
+
+#endif
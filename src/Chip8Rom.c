@@ -0,0 +1,277 @@
+#define _DEFAULT_SOURCE // MAP_POPULATE, strdup
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Chip8Bytes.h"
+#include "Chip8Rom.h"
+#include "Guards.h"
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+#define PACK_HEADER_SIZE 16
+#define PACK_ENTRY_SIZE 16
+
+static bool Chip8RomSet_addFile(Chip8RomSet *self, const char *path, int fd,
+        const struct stat *st);
+static bool Chip8RomSet_addDirectory(Chip8RomSet *self, const char *path);
+static bool Chip8RomSet_addArchive(Chip8RomSet *self, const uint8_t *data,
+        size_t size);
+static void Chip8RomSet_push(Chip8RomSet *self, const char *name,
+        const uint8_t *data, size_t size);
+static void *Chip8RomSet_grow(void *array, size_t *capacity, size_t count,
+        size_t itemSize);
+static int Chip8RomSet_compareNames(const void *a, const void *b);
+
+void Chip8RomSet_init(Chip8RomSet *self) {
+    memset(self, 0, sizeof(*self));
+}
+
+bool Chip8RomSet_add(Chip8RomSet *self, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        close(fd);
+        return Chip8RomSet_addDirectory(self, path);
+    }
+    bool added = Chip8RomSet_addFile(self, path, fd, &st);
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return added;
+}
+
+void Chip8RomSet_free(Chip8RomSet *self) {
+    for (size_t m = 0; m < self->mapCount; ++m) {
+        munmap(self->maps[m].addr, self->maps[m].size);
+    }
+    for (size_t n = 0; n < self->nameCount; ++n) {
+        free(self->names[n]);
+    }
+    free(self->maps);
+    free(self->names);
+    free(self->roms);
+    memset(self, 0, sizeof(*self));
+}
+
+bool Chip8RomSet_pack(const Chip8RomSet *self, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    // Names follow the entry table, and the data follows the names
+    size_t namesAt = PACK_HEADER_SIZE + self->count * PACK_ENTRY_SIZE,
+           dataAt = namesAt;
+    for (size_t r = 0; r < self->count; ++r) {
+        dataAt += strlen(self->roms[r].name) + 1;
+    }
+    uint8_t header[PACK_HEADER_SIZE];
+    memcpy(header, CHIP8_PACK_MAGIC, 8);
+    Chip8Bytes_putLE32(header + 8, CHIP8_PACK_VERSION);
+    Chip8Bytes_putLE32(header + 12, self->count);
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    size_t nameOffset = namesAt, dataOffset = dataAt;
+    for (size_t r = 0; ok && r < self->count; ++r) {
+        const Chip8Rom *rom = &self->roms[r];
+        size_t nameLength = strlen(rom->name);
+        // ROMs too large to have been mapped are stored empty
+        size_t size = rom->data != NULL ? rom->size : 0;
+        uint8_t entry[PACK_ENTRY_SIZE];
+        Chip8Bytes_putLE32(entry, dataOffset);
+        Chip8Bytes_putLE32(entry + 4, size);
+        Chip8Bytes_putLE32(entry + 8, nameOffset);
+        Chip8Bytes_putLE32(entry + 12, nameLength);
+        ok = fwrite(entry, 1, sizeof(entry), file) == sizeof(entry);
+        nameOffset += nameLength + 1;
+        dataOffset += size;
+    }
+    if (dataOffset > UINT32_MAX) {
+        ok = false;
+        errno = EFBIG;
+    }
+    for (size_t r = 0; ok && r < self->count; ++r) {
+        const char *name = self->roms[r].name;
+        ok = fwrite(name, 1, strlen(name) + 1, file) == strlen(name) + 1;
+    }
+    for (size_t r = 0; ok && r < self->count; ++r) {
+        const Chip8Rom *rom = &self->roms[r];
+        if (rom->data != NULL) {
+            ok = fwrite(rom->data, 1, rom->size, file) == rom->size;
+        }
+    }
+    int saved = errno;
+    if (fclose(file) != 0 && ok) {
+        return false;
+    }
+    errno = saved;
+    return ok;
+}
+
+/*
+ * Map an open regular file and add it, or its contents if it is an archive
+ */
+static bool Chip8RomSet_addFile(Chip8RomSet *self, const char *path, int fd,
+        const struct stat *st) {
+    size_t size = st->st_size;
+    char *name = OOM_GUARD(strdup(path), __FILE__, __LINE__);
+    self->names = Chip8RomSet_grow(self->names, &self->nameCapacity,
+            self->nameCount, sizeof(char *));
+    self->names[self->nameCount++] = name;
+    if (size == 0) {
+        Chip8RomSet_push(self, name, NULL, 0);
+        return true;
+    }
+
+    // Peek at the start first, so that only archives are mapped whole when
+    // they are too large to be a ROM
+    char magic[8] = { 0 };
+    bool archive = pread(fd, magic, sizeof(magic), 0) == sizeof(magic)
+        && memcmp(magic, CHIP8_PACK_MAGIC, sizeof(magic)) == 0;
+    if (!archive && size > CHIP8_MAX_ROM_SIZE) {
+        // Kept unmapped so that it is reported as invalid
+        Chip8RomSet_push(self, name, NULL, size);
+        return true;
+    }
+    // Prefault archives, whose every page is about to be read
+    void *addr = mmap(NULL, size, PROT_READ,
+            MAP_PRIVATE | (archive ? MAP_POPULATE : 0), fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    self->maps = Chip8RomSet_grow(self->maps, &self->mapCapacity,
+            self->mapCount, sizeof(struct Chip8RomMapping));
+    self->maps[self->mapCount++] = (struct Chip8RomMapping) { addr, size };
+    if (archive) {
+        return Chip8RomSet_addArchive(self, addr, size);
+    }
+    Chip8RomSet_push(self, name, addr, size);
+    return true;
+}
+
+/*
+ * Add every regular file in a directory, in name order
+ */
+static bool Chip8RomSet_addDirectory(Chip8RomSet *self, const char *path) {
+    DIR *dir = opendir(path);
+    if (dir == NULL) {
+        return false;
+    }
+    char **entries = NULL;
+    size_t count = 0, capacity = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        size_t length = strlen(path) + strlen(entry->d_name) + 2;
+        char *full = OOM_GUARD(malloc(length), __FILE__, __LINE__);
+        snprintf(full, length, "%s/%s", path, entry->d_name);
+        entries = Chip8RomSet_grow(entries, &capacity, count, sizeof(char *));
+        entries[count++] = full;
+    }
+    closedir(dir);
+    qsort(entries, count, sizeof(char *), Chip8RomSet_compareNames);
+
+    // Stop at the first file that cannot be read, but free every name
+    bool ok = true;
+    int saved = 0;
+    for (size_t e = 0; e < count; ++e) {
+        int fd = ok ? open(entries[e], O_RDONLY) : -1;
+        if (fd >= 0) {
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+                ok = Chip8RomSet_addFile(self, entries[e], fd, &st);
+            }
+            saved = errno;
+            close(fd);
+        } else if (ok) {
+            ok = false;
+            saved = errno;
+        }
+        free(entries[e]);
+    }
+    free(entries);
+    errno = saved;
+    return ok;
+}
+
+/*
+ * Add every ROM of a mapped archive, which must stay mapped
+ */
+static bool Chip8RomSet_addArchive(Chip8RomSet *self, const uint8_t *data,
+        size_t size) {
+    if (size < PACK_HEADER_SIZE
+            || Chip8Bytes_getLE32(data + 8) != CHIP8_PACK_VERSION) {
+        errno = EINVAL;
+        return false;
+    }
+    size_t count = Chip8Bytes_getLE32(data + 12);
+    if (count > (size - PACK_HEADER_SIZE) / PACK_ENTRY_SIZE) {
+        errno = EINVAL;
+        return false;
+    }
+    for (size_t r = 0; r < count; ++r) {
+        const uint8_t *entry = data + PACK_HEADER_SIZE + r * PACK_ENTRY_SIZE;
+        size_t offset = Chip8Bytes_getLE32(entry),
+               romSize = Chip8Bytes_getLE32(entry + 4),
+               nameOffset = Chip8Bytes_getLE32(entry + 8),
+               nameLength = Chip8Bytes_getLE32(entry + 12);
+        // Every range must lie inside the archive, and names end with NUL
+        if (offset > size || romSize > size - offset
+                || nameOffset >= size || nameLength >= size - nameOffset
+                || data[nameOffset + nameLength] != '\0') {
+            errno = EINVAL;
+            return false;
+        }
+        Chip8RomSet_push(self, (const char *) data + nameOffset,
+                romSize > 0 ? data + offset : NULL, romSize);
+    }
+    return true;
+}
+
+/*
+ * Append a ROM
+ */
+static void Chip8RomSet_push(Chip8RomSet *self, const char *name,
+        const uint8_t *data, size_t size) {
+    self->roms = Chip8RomSet_grow(self->roms, &self->capacity, self->count,
+            sizeof(Chip8Rom));
+    self->roms[self->count++] = (Chip8Rom) { name, data, size };
+}
+
+/*
+ * Make room for one more item in a growable array, doubling its capacity
+ * when full. Returns the (possibly moved) array.
+ */
+static void *Chip8RomSet_grow(void *array, size_t *capacity, size_t count,
+        size_t itemSize) {
+    if (count < *capacity) {
+        return array;
+    }
+    *capacity = *capacity > 0 ? 2 * *capacity : 16;
+    return OOM_GUARD(realloc(array, *capacity * itemSize), __FILE__, __LINE__);
+}
+
+/*
+ * qsort comparator for an array of strings
+ */
+static int Chip8RomSet_compareNames(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
@@ -0,0 +1,114 @@
+#define _POSIX_C_SOURCE 200809L // clock_nanosleep
+#include <errno.h>
+#include <time.h>
+
+#include "Chip8Audio.h"
+#include "Chip8Core.h"
+#include "Chip8Input.h"
+#include "Chip8State.h"
+#include "Chip8Trace.h"
+
+#define NS_PER_SEC 1000000000LL
+#define FRAME_RATE 60
+
+static long long Chip8_nanos(const struct timespec *ts);
+static void Chip8_sleepUntil(Chip8Proc *self, Chip8Input *input,
+        long long due);
+
+void Chip8_tick(Chip8Proc *self) {
+    if (self->trace != NULL) {
+        Chip8Trace_tick(self->trace, self->cycles);
+    }
+    if (self->D > 0) {
+        --self->D;
+    }
+    if (self->S > 0 && --self->S == 0 && self->setSound != NULL) {
+        self->setSound(false, self);
+    }
+}
+
+Chip8RunStats Chip8_run(Chip8Proc *self, const Chip8RunConfig *config) {
+    Chip8RunStats stats = { .running = true };
+    uint64_t begin = self->cycles, idleBegin = self->idleCycles;
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (stats.running) {
+        if (config->input != NULL) {
+            Chip8Input_deliver(config->input, self);
+        } else if (self->waitKey >= 0) {
+            // No key will ever come
+            break;
+        }
+        uint64_t budget = config->ipf;
+        if (config->maxCycles != 0) {
+            uint64_t left = config->maxCycles - (self->cycles - begin);
+            if (left == 0) {
+                break;
+            }
+            if (budget > left) { budget = left; }
+        }
+        stats.running = Chip8_execute(self, budget);
+        if (config->audio != NULL) {
+            Chip8Audio_frame(config->audio, self->S > 0);
+        }
+        Chip8_tick(self);
+        Chip8_present(self);
+        if (config->rewind != NULL) {
+            Chip8Rewind_push(config->rewind, self);
+        }
+        ++stats.frames;
+
+        if (!config->headless) {
+            // Each deadline is computed from the start time rather than the
+            // previous wakeup, so oversleeping never accumulates
+            long long due = Chip8_nanos(&start)
+                + (long long) (stats.frames * NS_PER_SEC / FRAME_RATE);
+            Chip8_sleepUntil(self, config->input, due);
+        } else if (self->waitKey >= 0 && config->input != NULL) {
+            // Waiting for a key happens in real time even when headless
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            Chip8_sleepUntil(self, config->input,
+                    Chip8_nanos(&now) + NS_PER_SEC / FRAME_RATE);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    stats.cycles = self->cycles - begin;
+    stats.idleCycles = self->idleCycles - idleBegin;
+    stats.seconds = (double) (Chip8_nanos(&now) - Chip8_nanos(&start))
+        / NS_PER_SEC;
+    stats.ips = stats.seconds > 0 ? stats.cycles / stats.seconds : 0;
+    return stats;
+}
+
+/*
+ * Convert a timespec to nanoseconds
+ */
+static long long Chip8_nanos(const struct timespec *ts) {
+    return ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+/*
+ * Sleep until due on the monotonic clock. While the processor waits for a
+ * key, events are delivered as they arrive and the sleep ends as soon as
+ * one completes the wait; otherwise they wait for the next frame.
+ */
+static void Chip8_sleepUntil(Chip8Proc *self, Chip8Input *input,
+        long long due) {
+    if (input != NULL && self->waitKey >= 0) {
+        while (Chip8Input_wait(input, due)) {
+            Chip8Input_deliver(input, self);
+            if (self->waitKey < 0) {
+                return;
+            }
+        }
+        return;
+    }
+    struct timespec deadline = {
+        .tv_sec = due / NS_PER_SEC,
+        .tv_nsec = due % NS_PER_SEC
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)
+            == EINTR);
+}
@@ -0,0 +1,346 @@
+#include <string.h>
+
+#include "Chip8Aot.h"
+#include "Chip8State.h"
+#include "Chip8Jit.h"
+#include "Guards.h"
+
+#define STATE_WORDS (sizeof(Chip8State) / 8)
+// A delta is a series of runs: a header of (unchanged, changed) word
+// counts followed by the changed words XORed with the keyframe. At worst
+// every other word changed.
+#define SCRATCH_SIZE (STATE_WORDS * 8 + (STATE_WORDS / 2 + 1) * 4)
+// Words compared at a time (with memcmp) while skipping unchanged state
+#define SCAN_WORDS 16
+#define ALIGN(n) (((n) + 7) & ~(size_t) 7)
+// Furthest a program can move PC before the fetch there traps: Bnnn from
+// FFF with V0 at FF
+#define MAX_PC (0xFFF + 0xFF)
+
+_Static_assert(sizeof(Chip8State) % 8 == 0,
+        "Chip8State must be a whole number of words");
+
+/*
+ * Header in front of every frame in the ring
+ */
+typedef struct Chip8RewindRecord {
+    // Offsets of the neighbouring records and of this frame's keyframe
+    // (its own offset for a keyframe)
+    uint32_t prev, next, key;
+    // Payload bytes, and frames since the keyframe
+    uint32_t size, age;
+} Chip8RewindRecord;
+
+#define HEADER_SIZE ALIGN(sizeof(Chip8RewindRecord))
+
+static bool Chip8State_valid(const Chip8State *state);
+static Chip8RewindRecord *Chip8Rewind_record(const Chip8Rewind *self,
+        size_t offset);
+static bool Chip8Rewind_reserve(Chip8Rewind *self, size_t size, size_t keep);
+static void Chip8Rewind_append(Chip8Rewind *self, size_t key, uint32_t age,
+        const uint8_t *payload, size_t size);
+static void Chip8Rewind_evict(Chip8Rewind *self);
+static size_t Chip8Rewind_encode(const uint8_t *key, const uint8_t *cur,
+        uint8_t *out);
+static void Chip8Rewind_decode(const uint8_t *delta, size_t size,
+        uint8_t *state);
+static uint64_t Chip8Rewind_word(const uint8_t *bytes, size_t i);
+
+void Chip8_saveState(const Chip8Proc *self, Chip8State *state) {
+    state->magic = CHIP8_STATE_MAGIC;
+    state->version = CHIP8_STATE_VERSION;
+    state->D = self->D;
+    state->S = self->S;
+    memcpy(state->V, self->V, sizeof(state->V));
+    memcpy(state->FR, self->FR, sizeof(state->FR));
+    state->I = self->I;
+    state->PC = self->PC;
+    state->SC = self->SC;
+    state->superMode = self->superMode;
+    state->largeScreen = self->largeScreen;
+    state->trap = self->trap;
+    state->trapPC = self->trapPC;
+    state->trapOpcode = self->trapOpcode;
+    memcpy(state->stack, self->stack, sizeof(state->stack));
+    state->randState = self->randState;
+    state->keys = self->keys;
+    state->waitKey = self->waitKey;
+    memset(state->reserved, 0, sizeof(state->reserved));
+    state->cycles = self->cycles;
+    memcpy(state->screen, self->screen, sizeof(state->screen));
+    memcpy(state->ram, self->ram, sizeof(state->ram));
+}
+
+bool Chip8_loadState(Chip8Proc *self, const Chip8State *state) {
+    if (state->magic != CHIP8_STATE_MAGIC
+            || state->version != CHIP8_STATE_VERSION
+            || !Chip8State_valid(state)) {
+        return false;
+    }
+    self->D = state->D;
+    self->S = state->S;
+    memcpy(self->V, state->V, sizeof(self->V));
+    memcpy(self->FR, state->FR, sizeof(self->FR));
+    self->I = state->I;
+    self->PC = state->PC;
+    self->SC = state->SC;
+    self->superMode = state->superMode;
+    self->largeScreen = state->largeScreen;
+    self->trap = state->trap;
+    self->trapPC = state->trapPC;
+    self->trapOpcode = state->trapOpcode;
+    memcpy(self->stack, state->stack, sizeof(self->stack));
+    self->randState = state->randState;
+    self->keys = state->keys;
+    self->waitKey = state->waitKey;
+    self->cycles = state->cycles;
+    memcpy(self->screen, state->screen, sizeof(self->screen));
+    memcpy(self->ram, state->ram, sizeof(self->ram));
+
+    // Any code may have changed, and so may any row
+    memset(self->decoded, 0, sizeof(self->decoded));
+    self->decodedLow = 4096;
+    self->decodedHigh = 0;
+    if (self->jit != NULL) {
+        Chip8Jit_invalidate(self, 0, sizeof(self->ram));
+    }
+    if (self->aot != NULL) {
+        Chip8Aot_invalidate(self, 0, sizeof(self->ram));
+    }
+    self->dirtyRows = ~0ULL;
+    return true;
+}
+
+bool Chip8Rewind_init(Chip8Rewind *self, size_t budget, unsigned keyInterval) {
+    memset(self, 0, sizeof(*self));
+    self->capacity = budget & ~(size_t) 7;
+    if (self->capacity < HEADER_SIZE + sizeof(Chip8State)
+            || self->capacity > UINT32_MAX) {
+        return false;
+    }
+    self->ring = OOM_GUARD(malloc(self->capacity), __FILE__, __LINE__);
+    self->scratch = OOM_GUARD(malloc(SCRATCH_SIZE), __FILE__, __LINE__);
+    self->keyInterval = keyInterval > 0 ? keyInterval : 1;
+    return true;
+}
+
+void Chip8Rewind_free(Chip8Rewind *self) {
+    free(self->ring);
+    free(self->scratch);
+    self->ring = NULL;
+    self->scratch = NULL;
+    self->frames = 0;
+}
+
+void Chip8Rewind_push(Chip8Rewind *self, const Chip8Proc *proc) {
+    Chip8_saveState(proc, &self->state);
+    const uint8_t *cur = (const uint8_t *) &self->state;
+
+    // Try a delta against the newest frame's keyframe
+    if (self->frames > 0) {
+        const Chip8RewindRecord *newest = Chip8Rewind_record(self, self->newest);
+        size_t key = newest->key;
+        uint32_t age = newest->age + 1;
+        if (age < self->keyInterval) {
+            size_t size = Chip8Rewind_encode(
+                    self->ring + key + HEADER_SIZE, cur, self->scratch);
+            if (size < sizeof(Chip8State)
+                    && Chip8Rewind_reserve(self, HEADER_SIZE + size, key)) {
+                Chip8Rewind_append(self, key, age, self->scratch, size);
+                return;
+            }
+        }
+    }
+
+    // Start a new keyframe, which always fits once everything else is gone
+    Chip8Rewind_reserve(self, HEADER_SIZE + sizeof(Chip8State), SIZE_MAX);
+    Chip8Rewind_append(self, self->write, 0, cur, sizeof(Chip8State));
+}
+
+bool Chip8Rewind_pop(Chip8Rewind *self, Chip8Proc *proc) {
+    if (self->frames == 0) {
+        return false;
+    }
+    const Chip8RewindRecord *record = Chip8Rewind_record(self, self->newest);
+    uint8_t *state = (uint8_t *) &self->state;
+    memcpy(state, self->ring + record->key + HEADER_SIZE, sizeof(Chip8State));
+    if (record->key != self->newest) {
+        Chip8Rewind_decode(self->ring + self->newest + HEADER_SIZE,
+                record->size, state);
+    }
+    Chip8_loadState(proc, &self->state);
+
+    // The popped frame was the last one written, so its space is free again
+    self->write = self->newest;
+    self->newest = record->prev;
+    if (--self->frames == 0) {
+        self->write = 0;
+    }
+    return true;
+}
+
+/*
+ * Whether state is one a processor can be in, so that running from it
+ * cannot index past the stack, keys or ram
+ */
+static bool Chip8State_valid(const Chip8State *state) {
+    if (state->PC < 0 || state->PC > MAX_PC
+            || state->SC < -1 || state->SC > 15
+            || state->waitKey < -1 || state->waitKey > 15
+            || state->trap > CHIP8_TRAP_BREAK
+            || *(const uint8_t *) &state->superMode > 1
+            || *(const uint8_t *) &state->largeScreen > 1) {
+        return false;
+    }
+    // 00EE returns past the address stacked, which must be in ram
+    for (int s = 0; s <= state->SC; ++s) {
+        if (state->stack[s] > 0xFFE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Header of the record at offset
+ */
+static Chip8RewindRecord *Chip8Rewind_record(const Chip8Rewind *self,
+        size_t offset) {
+    return (Chip8RewindRecord *) (self->ring + offset);
+}
+
+/*
+ * Move write to a free span of size bytes, dropping the oldest frames to
+ * make room. Returns false, dropping nothing more, if that would mean
+ * dropping the keyframe at offset keep.
+ */
+static bool Chip8Rewind_reserve(Chip8Rewind *self, size_t size, size_t keep) {
+    size = ALIGN(size);
+    for (;;) {
+        if (self->frames == 0) {
+            self->write = 0;
+            return size <= self->capacity;
+        }
+        if (self->oldest >= self->write) {
+            // Live frames wrap around the end: free space is [write, oldest)
+            if (self->write + size <= self->oldest) {
+                return true;
+            }
+        } else {
+            // Free space is [write, capacity) and [0, oldest)
+            if (self->write + size <= self->capacity) {
+                return true;
+            }
+            if (size <= self->oldest) {
+                self->write = 0;
+                return true;
+            }
+        }
+        if (self->oldest == keep) {
+            return false;
+        }
+        Chip8Rewind_evict(self);
+    }
+}
+
+/*
+ * Write a frame at the space reserved at write and make it the newest
+ */
+static void Chip8Rewind_append(Chip8Rewind *self, size_t key, uint32_t age,
+        const uint8_t *payload, size_t size) {
+    Chip8RewindRecord *record = Chip8Rewind_record(self, self->write);
+    *record = (Chip8RewindRecord) {
+        .prev = self->newest,
+        .key = key,
+        .size = size,
+        .age = age
+    };
+    memcpy(self->ring + self->write + HEADER_SIZE, payload, size);
+    if (self->frames == 0) {
+        self->oldest = self->write;
+    } else {
+        Chip8Rewind_record(self, self->newest)->next = self->write;
+    }
+    self->newest = self->write;
+    self->write += HEADER_SIZE + ALIGN(size);
+    ++self->frames;
+}
+
+/*
+ * Drop the oldest keyframe and every delta that depends on it
+ */
+static void Chip8Rewind_evict(Chip8Rewind *self) {
+    do {
+        self->oldest = Chip8Rewind_record(self, self->oldest)->next;
+        --self->frames;
+    } while (self->frames > 0
+            && Chip8Rewind_record(self, self->oldest)->key != self->oldest);
+}
+
+/*
+ * Write the run-length encoded XOR of the states key and cur to out.
+ * Returns the encoded size.
+ */
+static size_t Chip8Rewind_encode(const uint8_t *key, const uint8_t *cur,
+        uint8_t *out) {
+    uint8_t *p = out;
+    size_t i = 0;
+    while (i < STATE_WORDS) {
+        // Most of the state is unchanged, so skip it a block at a time
+        size_t start = i;
+        while (i + SCAN_WORDS <= STATE_WORDS
+                && memcmp(key + 8 * i, cur + 8 * i, 8 * SCAN_WORDS) == 0) {
+            i += SCAN_WORDS;
+        }
+        while (i < STATE_WORDS
+                && Chip8Rewind_word(key, i) == Chip8Rewind_word(cur, i)) {
+            ++i;
+        }
+        uint16_t run[2] = { (uint16_t) (i - start), 0 };
+        uint8_t *words = p + sizeof(run);
+        // Single unchanged words are cheaper to keep in the run than to
+        // start a new one for
+        while (i < STATE_WORDS) {
+            uint64_t diff = Chip8Rewind_word(key, i) ^ Chip8Rewind_word(cur, i);
+            if (diff == 0 && (i + 1 == STATE_WORDS
+                        || Chip8Rewind_word(key, i + 1)
+                            == Chip8Rewind_word(cur, i + 1))) {
+                break;
+            }
+            memcpy(words + 8 * run[1]++, &diff, 8);
+            ++i;
+        }
+        memcpy(p, run, sizeof(run));
+        p = words + 8 * run[1];
+    }
+    return p - out;
+}
+
+/*
+ * Apply an encoded delta to the keyframe in state
+ */
+static void Chip8Rewind_decode(const uint8_t *delta, size_t size,
+        uint8_t *state) {
+    const uint8_t *p = delta, *end = delta + size;
+    size_t i = 0;
+    while (p < end) {
+        uint16_t run[2];
+        memcpy(run, p, sizeof(run));
+        p += sizeof(run);
+        i += run[0];
+        for (int w = 0; w < run[1]; ++w, ++i, p += 8) {
+            uint64_t word = Chip8Rewind_word(state, i)
+                ^ Chip8Rewind_word(p, 0);
+            memcpy(state + 8 * i, &word, 8);
+        }
+    }
+}
+
+/*
+ * Word i of a byte buffer
+ */
+static uint64_t Chip8Rewind_word(const uint8_t *bytes, size_t i) {
+    uint64_t word;
+    memcpy(&word, bytes + 8 * i, 8);
+    return word;
+}
@@ -0,0 +1,213 @@
+#include <string.h>
+
+#include "Chip8Bytes.h"
+#include "Chip8Input.h"
+#include "Chip8Term.h"
+
+#define NS_PER_SEC 1000000000ULL
+
+// Hide the cursor, then clear the terminal with the cursor at the top left
+#define TERM_START "\x1b[?25l\x1b[H\x1b[2J"
+#define TERM_SHOW_CURSOR "\x1b[?25h"
+
+// Half blocks, for the top, the bottom and both pixels of a cell
+#define GLYPH_UPPER "\xE2\x96\x80"
+#define GLYPH_LOWER "\xE2\x96\x84"
+#define GLYPH_FULL  "\xE2\x96\x88"
+
+static void Chip8Term_frame(Chip8Term *self, uint64_t screen[64][2]);
+static void Chip8Term_diff(Chip8Term *self, uint64_t screen[64][2]);
+static void Chip8Term_cell(Chip8Term *self, uint64_t screen[64][2], int line,
+        int col);
+static void Chip8Term_moveTo(Chip8Term *self, int row, int col);
+static void Chip8Term_append(Chip8Term *self, const char *text, size_t length);
+static void Chip8Term_repeat(Chip8Term *self, const char *glyph, int count);
+static bool Chip8Term_flush(Chip8Term *self);
+
+void Chip8Term_init(Chip8Term *self, int fd, Chip8TermStyle style,
+        unsigned refreshHz) {
+    self->fd = fd;
+    self->style = style;
+    self->interval = refreshHz != 0 ? NS_PER_SEC / refreshHz : 0;
+    self->nextWrite = 0;
+    self->drawn = false;
+    self->length = 0;
+}
+
+bool Chip8Term_present(Chip8Term *self, uint64_t screen[64][2]) {
+    if (self->interval != 0) {
+        // Frames paced at the refresh rate arrive with some jitter, so
+        // allow each one an eighth of an interval early
+        uint64_t now = Chip8Input_now();
+        if (now + self->interval / 8 < self->nextWrite) {
+            return true;
+        }
+        // Keep to the rate over time, but never write a burst to catch up
+        self->nextWrite += self->interval;
+        if (self->nextWrite < now) {
+            self->nextWrite = now;
+        }
+    }
+    return Chip8Term_draw(self, screen);
+}
+
+bool Chip8Term_draw(Chip8Term *self, uint64_t screen[64][2]) {
+    if (self->drawn) {
+        Chip8Term_diff(self, screen);
+    } else {
+        Chip8Term_append(self, TERM_START, strlen(TERM_START));
+        Chip8Term_frame(self, screen);
+        self->drawn = true;
+    }
+    memcpy(self->shown, screen, sizeof(self->shown));
+    return Chip8Term_flush(self);
+}
+
+void Chip8Term_close(Chip8Term *self) {
+    if (self->drawn) {
+        // Just below the bottom border
+        Chip8Term_moveTo(self, self->style == CHIP8_TERM_COMPACT ? 35 : 67, 1);
+    }
+    Chip8Term_append(self, TERM_SHOW_CURSOR, strlen(TERM_SHOW_CURSOR));
+    Chip8Term_flush(self);
+}
+
+/*
+ * Append the whole display: borders and every cell
+ */
+static void Chip8Term_frame(Chip8Term *self, uint64_t screen[64][2]) {
+    if (self->style == CHIP8_TERM_COMPACT) {
+        Chip8Term_repeat(self, GLYPH_FULL, 1);
+        Chip8Term_repeat(self, GLYPH_UPPER, 130);
+        Chip8Term_append(self, GLYPH_FULL "\n", strlen(GLYPH_FULL "\n"));
+        for (int line = 0; line < 32; ++line) {
+            Chip8Term_append(self, GLYPH_FULL " ", strlen(GLYPH_FULL " "));
+            for (int col = 0; col < 128; ++col) {
+                Chip8Term_cell(self, screen, line, col);
+            }
+            Chip8Term_append(self, " " GLYPH_FULL "\n",
+                    strlen(" " GLYPH_FULL "\n"));
+        }
+        Chip8Term_repeat(self, GLYPH_FULL, 1);
+        Chip8Term_repeat(self, GLYPH_LOWER, 130);
+        Chip8Term_repeat(self, GLYPH_FULL, 1);
+    } else {
+        Chip8Term_repeat(self, "+", 1);
+        Chip8Term_repeat(self, "-", 128);
+        Chip8Term_append(self, "+\n", 2);
+        for (int line = 0; line < 64; ++line) {
+            Chip8Term_append(self, "|", 1);
+            for (int col = 0; col < 128; ++col) {
+                Chip8Term_cell(self, screen, line, col);
+            }
+            Chip8Term_append(self, "|\n", 2);
+        }
+        Chip8Term_repeat(self, "+", 1);
+        Chip8Term_repeat(self, "-", 128);
+        Chip8Term_repeat(self, "+", 1);
+    }
+}
+
+/*
+ * Append the cells that differ from the ones shown, in runs that each
+ * start with a cursor move. Unchanged cells between two changed ones are
+ * rewritten when that is shorter than moving past them.
+ */
+static void Chip8Term_diff(Chip8Term *self, uint64_t screen[64][2]) {
+    bool compact = self->style == CHIP8_TERM_COMPACT;
+    int lines = compact ? 32 : 64, rowsPerLine = compact ? 2 : 1,
+        // Columns left of the cells, and the most unchanged cells worth
+        // rewriting instead of a cursor move of up to 9 bytes
+        margin = compact ? 2 : 1, maxGap = compact ? 3 : 8;
+    for (int line = 0; line < lines; ++line) {
+        int row = line * rowsPerLine, next = -1;
+        for (int w = 0; w < 2; ++w) {
+            uint64_t changed = 0;
+            for (int r = row; r < row + rowsPerLine; ++r) {
+                changed |= screen[r][w] ^ self->shown[r][w];
+            }
+            // Column w * 64 + k is bit 63 - k
+            while (changed != 0) {
+                int k = __builtin_clzll(changed),
+                    col = w * 64 + k;
+                changed &= ~(1ULL << (63 - k));
+                if (next < 0 || col - next > maxGap) {
+                    // Terminal rows and columns count from 1, below the
+                    // top border and right of the margin
+                    Chip8Term_moveTo(self, line + 2, col + margin + 1);
+                    next = col;
+                }
+                for (; next <= col; ++next) {
+                    Chip8Term_cell(self, screen, line, next);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Append the character for one cell of the display
+ */
+static void Chip8Term_cell(Chip8Term *self, uint64_t screen[64][2], int line,
+        int col) {
+    uint64_t bit = 1ULL << (63 - col % 64);
+    if (self->style == CHIP8_TERM_FULL) {
+        self->buffer[self->length++] = screen[line][col / 64] & bit ? '#' : ' ';
+        return;
+    }
+    bool top = screen[2 * line][col / 64] & bit,
+         bottom = screen[2 * line + 1][col / 64] & bit;
+    if (!top && !bottom) {
+        self->buffer[self->length++] = ' ';
+    } else {
+        Chip8Term_append(self, top && bottom ? GLYPH_FULL
+                : top ? GLYPH_UPPER : GLYPH_LOWER, 3);
+    }
+}
+
+/*
+ * Append an absolute cursor move (CUP)
+ */
+static void Chip8Term_moveTo(Chip8Term *self, int row, int col) {
+    char text[16];
+    int length = 0;
+    text[length++] = '\x1b';
+    text[length++] = '[';
+    if (row >= 10) { text[length++] = '0' + row / 10; }
+    text[length++] = '0' + row % 10;
+    text[length++] = ';';
+    if (col >= 100) { text[length++] = '0' + col / 100; }
+    if (col >= 10) { text[length++] = '0' + col / 10 % 10; }
+    text[length++] = '0' + col % 10;
+    text[length++] = 'H';
+    Chip8Term_append(self, text, length);
+}
+
+/*
+ * Append to the frame buffer, which is sized for the largest frame
+ */
+static void Chip8Term_append(Chip8Term *self, const char *text,
+        size_t length) {
+    memcpy(self->buffer + self->length, text, length);
+    self->length += length;
+}
+
+/*
+ * Append a glyph count times
+ */
+static void Chip8Term_repeat(Chip8Term *self, const char *glyph, int count) {
+    size_t length = strlen(glyph);
+    for (int i = 0; i < count; ++i) {
+        Chip8Term_append(self, glyph, length);
+    }
+}
+
+/*
+ * Write out and empty the frame buffer; a single write() unless the
+ * terminal takes it in parts
+ */
+static bool Chip8Term_flush(Chip8Term *self) {
+    size_t length = self->length;
+    self->length = 0;
+    return Chip8Bytes_writeAll(self->fd, self->buffer, length);
+}
@@ -0,0 +1,251 @@
+#define _POSIX_C_SOURCE 200809L // posix_madvise
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Chip8Bytes.h"
+#include "Chip8Trace.h"
+
+// A varint and the largest payload, a sample
+#define MAX_RECORD_SIZE (10 + 4)
+#define FLAG_SUPER 0x1
+
+static void Chip8Trace_record(Chip8Trace *self, uint64_t cycles, int kind,
+        const uint8_t *payload, size_t size);
+static bool Chip8Trace_flush(Chip8Trace *self);
+static bool Chip8Trace_run(Chip8Proc *proc, uint64_t cycles);
+static uint16_t Chip8Trace_opcode(const Chip8Proc *proc);
+
+bool Chip8Trace_open(Chip8Trace *self, const char *path,
+        const Chip8Proc *proc, const uint8_t *program, size_t size,
+        uint32_t period) {
+    self->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (self->fd < 0) {
+        return false;
+    }
+    self->period = period;
+    self->cycles = proc->cycles;
+    self->nextSample = proc->cycles;
+    self->records = 0;
+    self->failed = false;
+    uint8_t *header = self->buffer;
+    memcpy(header, CHIP8_TRACE_MAGIC, 8);
+    Chip8Bytes_putLE32(header + 8, CHIP8_TRACE_VERSION);
+    Chip8Bytes_putLE32(header + 12, proc->superMode ? FLAG_SUPER : 0);
+    Chip8Bytes_putLE32(header + 16, proc->randState);
+    Chip8Bytes_putLE32(header + 20, period);
+    Chip8Bytes_putLE32(header + 24, size);
+    Chip8Bytes_putLE32(header + 28, 0);
+    Chip8Bytes_putLE64(header + 32, Chip8Bytes_hash(program, size));
+    self->length = CHIP8_TRACE_HEADER_SIZE;
+    return true;
+}
+
+void Chip8Trace_tick(Chip8Trace *self, uint64_t cycles) {
+    Chip8Trace_record(self, cycles, CHIP8_TRACE_TICK, NULL, 0);
+}
+
+void Chip8Trace_key(Chip8Trace *self, uint64_t cycles, uint8_t key,
+        bool pressed) {
+    uint8_t payload = (key & 0xF) | (pressed ? 0x10 : 0);
+    Chip8Trace_record(self, cycles, CHIP8_TRACE_KEY, &payload, 1);
+}
+
+void Chip8Trace_sample(Chip8Trace *self, const Chip8Proc *proc) {
+    if (self->period == 0 || proc->cycles < self->nextSample) {
+        return;
+    }
+    uint8_t payload[4];
+    Chip8Bytes_putLE16(payload, proc->PC);
+    Chip8Bytes_putLE16(payload + 2, Chip8Trace_opcode(proc));
+    Chip8Trace_record(self, proc->cycles, CHIP8_TRACE_SAMPLE, payload, 4);
+    self->nextSample = (proc->cycles / self->period + 1) * self->period;
+}
+
+bool Chip8Trace_close(Chip8Trace *self, const Chip8Proc *proc) {
+    uint8_t trapped = proc->trap != CHIP8_TRAP_NONE;
+    Chip8Trace_record(self, proc->cycles, CHIP8_TRACE_END, &trapped, 1);
+    bool ok = !self->failed && Chip8Trace_flush(self);
+    int saved = errno;
+    if (close(self->fd) != 0 && ok) {
+        return false;
+    }
+    errno = saved;
+    return ok;
+}
+
+bool Chip8TraceReader_open(Chip8TraceReader *self, const char *path) {
+    memset(self, 0, sizeof(*self));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return false;
+    }
+    if (st.st_size < CHIP8_TRACE_HEADER_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    int saved = errno;
+    close(fd);
+    if (addr == MAP_FAILED) {
+        errno = saved;
+        return false;
+    }
+    self->data = addr;
+    self->size = st.st_size;
+    if (memcmp(self->data, CHIP8_TRACE_MAGIC, 8) != 0
+            || Chip8Bytes_getLE32(self->data + 8) != CHIP8_TRACE_VERSION) {
+        Chip8TraceReader_close(self);
+        errno = EINVAL;
+        return false;
+    }
+    self->superMode = Chip8Bytes_getLE32(self->data + 12) & FLAG_SUPER;
+    self->randState = Chip8Bytes_getLE32(self->data + 16);
+    self->period = Chip8Bytes_getLE32(self->data + 20);
+    self->programSize = Chip8Bytes_getLE32(self->data + 24);
+    self->programHash = Chip8Bytes_getLE64(self->data + 32);
+    // Reads are sequential from here on
+    posix_madvise(addr, self->size, POSIX_MADV_SEQUENTIAL);
+    self->offset = CHIP8_TRACE_HEADER_SIZE;
+    return true;
+}
+
+Chip8ReplayResult Chip8Trace_replay(Chip8TraceReader *self, Chip8Proc *proc,
+        const uint8_t *program, size_t size) {
+    if (proc->superMode != self->superMode || size != self->programSize
+            || Chip8Bytes_hash(program, size) != self->programHash
+            || self->randState == 0) {
+        return CHIP8_REPLAY_MISMATCH;
+    }
+    proc->randState = self->randState;
+    self->cycles = proc->cycles;
+    for (;;) {
+        uint64_t word;
+        if (!Chip8Bytes_getVarint(self->data, self->size, &self->offset,
+                &word)) {
+            return CHIP8_REPLAY_CORRUPT;
+        }
+        ++self->records;
+        self->cycles += word >> 2;
+        if (!Chip8Trace_run(proc, self->cycles)) {
+            return CHIP8_REPLAY_DIVERGED;
+        }
+        switch (word & 3) {
+            case CHIP8_TRACE_TICK:
+                Chip8_tick(proc);
+                Chip8_present(proc);
+                break;
+            case CHIP8_TRACE_KEY:
+                if (self->offset == self->size) {
+                    return CHIP8_REPLAY_CORRUPT;
+                }
+                uint8_t key = self->data[self->offset++];
+                Chip8_keyEvent(proc, key & 0xF, key & 0x10);
+                break;
+            case CHIP8_TRACE_SAMPLE:
+                if (self->size - self->offset < 4) {
+                    return CHIP8_REPLAY_CORRUPT;
+                }
+                const uint8_t *sample = self->data + self->offset;
+                self->offset += 4;
+                if (Chip8Bytes_getLE16(sample) != (uint16_t) proc->PC
+                        || Chip8Bytes_getLE16(sample + 2)
+                            != Chip8Trace_opcode(proc)) {
+                    return CHIP8_REPLAY_DIVERGED;
+                }
+                break;
+            case CHIP8_TRACE_END:
+                if (self->offset == self->size) {
+                    return CHIP8_REPLAY_CORRUPT;
+                }
+                // The instruction that trapped did not retire
+                if (self->data[self->offset++] != 0
+                        && Chip8_execute(proc, 1)) {
+                    return CHIP8_REPLAY_DIVERGED;
+                }
+                return CHIP8_REPLAY_DONE;
+        }
+    }
+}
+
+const char *Chip8_replayResultName(Chip8ReplayResult result) {
+    switch (result) {
+        case CHIP8_REPLAY_DONE: return "done";
+        case CHIP8_REPLAY_MISMATCH: return "not the traced program or mode";
+        case CHIP8_REPLAY_DIVERGED: return "diverged from the trace";
+        case CHIP8_REPLAY_CORRUPT: return "corrupt trace";
+    }
+    return "unknown";
+}
+
+void Chip8TraceReader_close(Chip8TraceReader *self) {
+    if (self->data != NULL) {
+        munmap((void *) self->data, self->size);
+    }
+    memset(self, 0, sizeof(*self));
+}
+
+/*
+ * Append a record of kind after cycles instructions, with its payload
+ */
+static void Chip8Trace_record(Chip8Trace *self, uint64_t cycles, int kind,
+        const uint8_t *payload, size_t size) {
+    if (self->failed) {
+        return;
+    }
+    if (self->length > CHIP8_TRACE_BUFFER_SIZE - MAX_RECORD_SIZE
+            && !Chip8Trace_flush(self)) {
+        self->failed = true;
+        return;
+    }
+    uint8_t *out = Chip8Bytes_putVarint(self->buffer + self->length,
+            (cycles - self->cycles) << 2 | kind);
+    if (size > 0) {
+        memcpy(out, payload, size);
+    }
+    self->length = out + size - self->buffer;
+    self->cycles = cycles;
+    ++self->records;
+}
+
+/*
+ * Write out the buffer; a single write() unless the file takes it in parts
+ */
+static bool Chip8Trace_flush(Chip8Trace *self) {
+    size_t length = self->length;
+    self->length = 0;
+    return Chip8Bytes_writeAll(self->fd, self->buffer, length);
+}
+
+/*
+ * Execute until proc has retired cycles instructions in all.
+ * Returns false if it cannot: it traps or waits for a key first.
+ */
+static bool Chip8Trace_run(Chip8Proc *proc, uint64_t cycles) {
+    while (proc->cycles < cycles) {
+        if (!Chip8_execute(proc, cycles - proc->cycles)
+                || proc->waitKey >= 0) {
+            return proc->cycles == cycles;
+        }
+    }
+    return proc->cycles == cycles;
+}
+
+/*
+ * The opcode at proc's PC, 0 past the end of ram
+ */
+static uint16_t Chip8Trace_opcode(const Chip8Proc *proc) {
+    uint16_t pc = proc->PC;
+    return pc <= 0xFFE ? proc->ram[pc] << 8 | proc->ram[pc + 1] : 0;
+}
@@ -1,142 +1,728 @@
+#define _POSIX_C_SOURCE 200809L // getopt_long
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
 
+#include "Chip8Aot.h"
+#include "Chip8Audio.h"
+#include "Chip8Batch.h"
+#include "Chip8Capture.h"
+#include "Chip8Console.h"
 #include "Chip8Core.h"
+#include "Chip8Debug.h"
+#include "Chip8Input.h"
+#include "Chip8Jit.h"
+#include "Chip8Present.h"
+#include "Chip8Profile.h"
+#include "Chip8Rom.h"
+#include "Chip8Term.h"
+#include "Chip8Trace.h"
 #include "Guards.h"
 
-void printScreen(bool *screen);
-void printScreenCompact(bool *screen);
+// Instructions per 60Hz frame, the usual ~700 instructions per second
+#define DEFAULT_IPF 12
+// Instructions each ROM of a batch may execute unless --budget is given
+#define DEFAULT_BATCH_BUDGET 10000000
+// Most frames the render thread writes to the terminal per second
+#define DISPLAY_REFRESH_HZ 60
+// A terminal only reports key presses, so each key is released this long
+// after its last press (or auto-repeat)
+#define KEY_HOLD_NS 200000000ULL
+// Longest the input thread sleeps before checking whether to stop
+#define INPUT_POLL_MS 50
 
-int main() {
-    uint8_t maze[64] = { // Maze (alt) [David Winter, 199x]
-        0x60, 0x00, 0x61, 0x00, 0xA2, 0x22, 0xC2, 0x01,
-        0x32, 0x01, 0xA2, 0x1E, 0xD0, 0x14, 0x70, 0x04,
-        0x30, 0x40, 0x12, 0x04, 0x60, 0x00, 0x71, 0x04,
-        0x31, 0x20, 0x12, 0x04, 0x12, 0x1C, 0x80, 0x40,
-        0x20, 0x10, 0x20, 0x40, 0x80, 0x10
-    };
+/*
+ * Settings from the command line
+ */
+typedef struct Options {
+    bool superMode, headless, jit, batch;
+    uint64_t budget;
+    unsigned ipf, threads;
+    // Seed of every processor's random number generator
+    uint32_t seed;
+    // Show frames on the terminal, and in which style
+    bool display;
+    Chip8TermStyle style;
+    // Record every presented frame to this capture file (NULL for none)
+    const char *capturePath;
+    // Play the buzzer to this WAV file, or "null" (NULL for no audio)
+    const char *audioPath;
+    // Write the ROMs to this packed archive instead of running them
+    const char *packPath;
+    // Record the run's inputs to this trace, or replay the run recorded in
+    // it (NULL for neither), sampling the PC every samplePeriod
+    // instructions when recording (0 for never)
+    const char *recordPath, *replayPath;
+    uint32_t samplePeriod;
+    // Run under the debugger console instead
+    bool debug;
+} Options;
 
-    uint8_t writeText[64] = {
-        // Set V7 to 0x00
-        0x67, 0x00,
-        // Start V0 (x)
-        0x60, 0x02,
-        // Start V1 (y)
-        0x61, 0x01,
-        // Set I to addr of sprite for char in V7
-        0xF7, 0x29, 
-        // Draw the sprite
-        0xD0, 0x15,
-        // Add 5 to V0 (x)
-        0x70, 0x05,
-        // Add 1 to V7
-        0x77, 0x01,
-        // If V0 (x) == 0x3E, don't go back yet
-        0x30, 0x3E,
-        // Go back to the fetch sprite instruction
-        0x12, 0x06,
-        // Add 6 to V1 (y)
-        0x71, 0x06,
-        // Reset V0 (x)
-        0x60, 0x02,
-        // If V1 (y) == 0x1F, don't go back
-        0x31, 0x1F,
-        // Go back to the fetch sprite instruction
-        0x12, 0x06,
-        // Test scrolling
-        0x00, 0xFC,
-        0x00, 0xFC,
-        0x00, 0xFB,
-        0x00, 0xCc,
-        // Exit
-        0x00, 0xFD
-    };
+// Where presented frames go: the terminal, a capture file or both. The
+// terminal is written by a render thread taking frames from presenter, so
+// a slow terminal never holds up emulation; captures keep every frame.
+static Chip8Term terminal;
+static Chip8Presenter presenter;
+static Chip8Capture capture;
+static bool displaying, capturing;
+static Chip8Audio audio;
+// The processor being run, whose cycle count stamps captured frames
+static const Chip8Proc *running;
+
+// Key presses read from a terminal on stdin by the input thread
+static Chip8Input input;
+static struct termios savedTermios;
+static atomic_bool inputStop;
+// Host keys for CHIP-8 keys 0x0-0xF, on the usual 4x4 block:
+//   1 2 3 C    1 2 3 4
+//   4 5 6 D    q w e r
+//   7 8 9 E    a s d f
+//   A 0 B F    z x c v
+static const char keyMap[16] = {
+    'x', '1', '2', '3', 'q', 'w', 'e', 'a',
+    's', 'd', 'z', 'c', '4', 'r', 'f', 'v'
+};
+
+void presentFrame(uint64_t screen[64][2], uint64_t dirtyRows);
+void renderFrame(Chip8Frame *frame, void *unused);
+bool openDisplay(const Options *options);
+void closeDisplay(void);
+void printUsage(FILE *out, const char *program);
+bool parseOptions(int argc, char **argv, Options *options);
+int runSingle(const Chip8Rom *rom, const Options *options);
+int runReplay(const Chip8Rom *rom, const Options *options);
+int runDebug(const Chip8Rom *rom, const Options *options);
+int runBatch(const Chip8RomSet *set, const Options *options);
+bool startInput(pthread_t *thread);
+void stopInput(pthread_t thread);
+void *readKeys(void *unused);
+void restoreTerminal(int number);
+#ifdef CHIP8_PROFILE
+// Instructions between call stack samples, and addresses in the report
+#define PROFILE_SAMPLE_PERIOD 97
+#define PROFILE_TOP 20
+#define PROFILE_FOLDED_PATH "chip8.folded"
+void writeProfile(const Chip8Profile *profile, const Chip8Proc *proc);
+#endif
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+    if (optind >= argc) {
+        printUsage(stderr, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Chip8RomSet set;
+    Chip8RomSet_init(&set);
+    for (int a = optind; a < argc; ++a) {
+        if (!Chip8RomSet_add(&set, argv[a])) {
+            perror(argv[a]);
+            Chip8RomSet_free(&set);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int status;
+    if (options.packPath != NULL) {
+        status = EXIT_SUCCESS;
+        if (!Chip8RomSet_pack(&set, options.packPath)) {
+            perror(options.packPath);
+            status = EXIT_FAILURE;
+        }
+    } else if ((options.capturePath != NULL || options.audioPath != NULL
+                || options.recordPath != NULL || options.replayPath != NULL
+                || options.debug)
+            && (set.count != 1 || options.batch)) {
+        fprintf(stderr, "%s: --capture, --audio, --record, --replay and "
+                "--debug take a single ROM\n", argv[0]);
+        status = EXIT_FAILURE;
+    } else if (options.replayPath != NULL && (options.recordPath != NULL
+                || options.audioPath != NULL)) {
+        fprintf(stderr, "%s: --replay cannot be combined with --record or "
+                "--audio\n", argv[0]);
+        status = EXIT_FAILURE;
+    } else if (options.replayPath != NULL) {
+        status = runReplay(&set.roms[0], &options);
+    } else if (options.debug) {
+        status = runDebug(&set.roms[0], &options);
+    } else if (set.count == 1 && !options.batch) {
+        status = runSingle(&set.roms[0], &options);
+    } else {
+        status = runBatch(&set, &options);
+    }
+    Chip8RomSet_free(&set);
+    return status;
+}
 
-    uint8_t largeScreenDraw[64] = {
-        // Enable largeScreen mode
-        0x00, 0xFF,
-        // Skip sprite data
-        0x12, 0x24,
-        // Sprite data
-        0xF0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
-        0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
-        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
-        0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
-        // Set I to addr of sprite data
-        0xA2, 0x04,
-        // Set V0 to x
-        0x60, 0x00,
-        // Set V1 to y
-        0x61, 0x00,
-        // Draw 8x15
-        0xD0, 0x1F,
-        // Set V1 to next x
-        0x60, 0x00,
-        // Set V2 to next y
-        0x61, 0x20,
-        // Draw 16x16
-        0xD0, 0x10,
-        // Exit
-        0x00, 0xFD
+void printUsage(FILE *out, const char *program) {
+    fprintf(out,
+            "Usage: %s [options] <rom|directory|archive>...\n"
+            "Runs one ROM interactively, or several as a batch.\n"
+            "  -s, --super          start in SUPER-CHIP mode\n"
+            "  -n, --budget N       stop after N instructions (batch default %d)\n"
+            "  -i, --ipf N          instructions per 60Hz frame (default %d)\n"
+            "  -H, --headless       run flat out instead of at 60Hz\n"
+            "  -o, --output MODE    frame output: compact (default), full, "
+            "none\n"
+            "  -j, --jit            run translated code\n"
+            "  -b, --batch          print one result line per ROM\n"
+            "  -t, --threads N      batch worker threads (default: per CPU)\n"
+            "  -r, --seed N         random number seed (default %d)\n"
+            "  -c, --capture FILE   record every frame to a capture file\n"
+            "  -a, --audio SINK     play the buzzer to a WAV file, or 'null'\n"
+            "  -R, --record FILE    record the run's inputs to a trace\n"
+            "  -S, --sample N       also trace the PC every N instructions\n"
+            "  -P, --replay FILE    replay a trace of the ROM flat out\n"
+            "  -g, --debug          run the ROM under the debugger console\n"
+            "  -p, --pack FILE      write the ROMs to a packed archive\n"
+            "  -h, --help           show this help\n",
+            program, DEFAULT_BATCH_BUDGET, DEFAULT_IPF,
+            CHIP8_DEFAULT_SEED);
+}
+
+/*
+ * Fill options from the command line, leaving optind at the first path.
+ * Returns false after reporting an invalid option.
+ */
+bool parseOptions(int argc, char **argv, Options *options) {
+    static const struct option longOptions[] = {
+        { "super", no_argument, NULL, 's' },
+        { "budget", required_argument, NULL, 'n' },
+        { "ipf", required_argument, NULL, 'i' },
+        { "headless", no_argument, NULL, 'H' },
+        { "output", required_argument, NULL, 'o' },
+        { "jit", no_argument, NULL, 'j' },
+        { "batch", no_argument, NULL, 'b' },
+        { "threads", required_argument, NULL, 't' },
+        { "seed", required_argument, NULL, 'r' },
+        { "capture", required_argument, NULL, 'c' },
+        { "audio", required_argument, NULL, 'a' },
+        { "record", required_argument, NULL, 'R' },
+        { "sample", required_argument, NULL, 'S' },
+        { "replay", required_argument, NULL, 'P' },
+        { "debug", no_argument, NULL, 'g' },
+        { "pack", required_argument, NULL, 'p' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
     };
+    *options = (Options) {
+        .ipf = DEFAULT_IPF,
+        .seed = CHIP8_DEFAULT_SEED,
+        .display = true,
+        .style = CHIP8_TERM_COMPACT
+    };
+    int option;
+    while ((option = getopt_long(argc, argv, "sn:i:Ho:jbt:r:c:a:R:S:P:gp:h", longOptions,
+                    NULL)) != -1) {
+        char *end = NULL;
+        switch (option) {
+            case 's': options->superMode = true; break;
+            case 'H': options->headless = true; break;
+            case 'j': options->jit = true; break;
+            case 'b': options->batch = true; break;
+            case 'g': options->debug = true; break;
+            case 'c': options->capturePath = optarg; break;
+            case 'a': options->audioPath = optarg; break;
+            case 'p': options->packPath = optarg; break;
+            case 'R': options->recordPath = optarg; break;
+            case 'P': options->replayPath = optarg; break;
+            case 'n':
+                options->budget = strtoull(optarg, &end, 10);
+                break;
+            case 'i':
+                options->ipf = (unsigned) strtoul(optarg, &end, 10);
+                if (options->ipf == 0) { end = optarg; }
+                break;
+            case 't':
+                options->threads = (unsigned) strtoul(optarg, &end, 10);
+                break;
+            case 'r':
+                options->seed = (uint32_t) strtoul(optarg, &end, 0);
+                break;
+            case 'S':
+                options->samplePeriod = (uint32_t) strtoul(optarg, &end, 10);
+                break;
+            case 'o':
+                if (strcmp(optarg, "compact") == 0) {
+                    options->style = CHIP8_TERM_COMPACT;
+                } else if (strcmp(optarg, "full") == 0) {
+                    options->style = CHIP8_TERM_FULL;
+                } else if (strcmp(optarg, "none") == 0) {
+                    options->display = false;
+                } else {
+                    fprintf(stderr, "%s: unknown output '%s'\n", argv[0],
+                            optarg);
+                    return false;
+                }
+                break;
+            case 'h':
+                printUsage(stdout, argv[0]);
+                exit(EXIT_SUCCESS);
+            default:
+                printUsage(stderr, argv[0]);
+                return false;
+        }
+        // Numeric arguments must be whole numbers
+        if (end != NULL && (end == optarg || *end != '\0')) {
+            fprintf(stderr, "%s: invalid number '%s'\n", argv[0], optarg);
+            return false;
+        }
+    }
+    return true;
+}
 
-    Chip8Proc *proc = malloc(sizeof(Chip8Proc));
+/*
+ * Run one ROM until it exits, traps or uses up the budget
+ */
+int runSingle(const Chip8Rom *rom, const Options *options) {
+    if (!Chip8Rom_valid(rom)) {
+        fprintf(stderr, "%s: %zu bytes does not fit 0x200-0xFFF "
+                "(1 to %d bytes)\n", rom->name, rom->size, CHIP8_MAX_ROM_SIZE);
+        return EXIT_FAILURE;
+    }
+    capturing = options->capturePath != NULL;
+    if (capturing && !Chip8Capture_open(&capture, options->capturePath)) {
+        perror(options->capturePath);
+        return EXIT_FAILURE;
+    }
+    bool playing = options->audioPath != NULL;
+    // A headless run would outrun the audio thread, so its WAV file is
+    // written as the frames are rendered
+    Chip8AudioSink sink = !playing || strcmp(options->audioPath, "null") == 0
+        ? CHIP8_AUDIO_NULL
+        : options->headless ? CHIP8_AUDIO_WAV_OFFLINE : CHIP8_AUDIO_WAV;
+    if (playing && !Chip8Audio_open(&audio, sink, options->audioPath,
+                CHIP8_AUDIO_DEFAULT_RATE)) {
+        perror(options->audioPath);
+        if (capturing) {
+            Chip8Capture_close(&capture);
+        }
+        return EXIT_FAILURE;
+    }
+    displaying = options->display;
+    Chip8Proc *proc = aligned_alloc(_Alignof(Chip8Proc), sizeof(Chip8Proc));
     OOM_GUARD(proc, __FILE__, __LINE__);
-    *proc = Chip8_init(largeScreenDraw, 64, printScreenCompact, NULL, false);
+    running = proc;
+    Chip8_initAt(proc, rom->data, rom->size,
+            displaying || capturing ? presentFrame : NULL, NULL,
+            options->superMode);
+    Chip8_seed(proc, options->seed);
+    Chip8Trace *trace = NULL;
+    if (options->recordPath != NULL) {
+        trace = malloc(sizeof(Chip8Trace));
+        OOM_GUARD(trace, __FILE__, __LINE__);
+        if (!Chip8Trace_open(trace, options->recordPath, proc, rom->data,
+                    rom->size, options->samplePeriod)) {
+            perror(options->recordPath);
+            free(trace);
+            free(proc);
+            if (capturing) {
+                Chip8Capture_close(&capture);
+            }
+            if (playing) {
+                Chip8Audio_close(&audio);
+            }
+            return EXIT_FAILURE;
+        }
+        proc->trace = trace;
+    }
+    if (displaying) {
+        displaying = openDisplay(options);
+    }
+    Chip8Aot_attach(proc, rom->data, rom->size);
+    if (options->jit && !Chip8Jit_enable(proc)) {
+        fprintf(stderr, "JIT unavailable, interpreting\n");
+    }
 
-    while (Chip8_advance(proc));
+    Chip8RunConfig config = {
+        .ipf = options->ipf,
+        .headless = options->headless,
+        .maxCycles = options->budget
+    };
+    if (playing) {
+        config.audio = &audio;
+    }
+    pthread_t inputThread;
+    bool reading = startInput(&inputThread);
+    if (reading) {
+        config.input = &input;
+    }
+#ifdef CHIP8_PROFILE
+    proc->profile = Chip8Profile_create(PROFILE_SAMPLE_PERIOD);
+#endif
+    Chip8RunStats stats = Chip8_run(proc, &config);
+    if (reading) {
+        stopInput(inputThread);
+    }
+#ifdef CHIP8_PROFILE
+    writeProfile(proc->profile, proc);
+    Chip8Profile_free(proc->profile);
+    proc->profile = NULL;
+#endif
+    Chip8Jit_disable(proc);
+    if (displaying) {
+        closeDisplay();
+    }
+    bool captured = true;
+    if (capturing) {
+        captured = Chip8Capture_close(&capture);
+        if (captured) {
+            fprintf(stderr, "%llu frames captured to %s\n",
+                    (unsigned long long) capture.frames, options->capturePath);
+        } else {
+            perror(options->capturePath);
+        }
+    }
+    bool recorded = true;
+    if (trace != NULL) {
+        proc->trace = NULL;
+        recorded = Chip8Trace_close(trace, proc);
+        if (recorded) {
+            fprintf(stderr, "%llu trace records written to %s\n",
+                    (unsigned long long) trace->records,
+                    options->recordPath);
+        } else {
+            perror(options->recordPath);
+        }
+        free(trace);
+    }
+    bool played = true;
+    if (playing) {
+        played = Chip8Audio_close(&audio);
+        if (!played) {
+            perror(options->audioPath);
+        }
+        fprintf(stderr, "%llu audio samples, %llu dropped, %llu underruns\n",
+                (unsigned long long) audio.produced,
+                (unsigned long long) audio.dropped,
+                (unsigned long long) audio.underruns);
+    }
+    bool faulted = proc->trap > CHIP8_TRAP_EXIT;
+    if (faulted) {
+        fprintf(stderr, "%03X - Aborting - %s (%04X)\n", proc->trapPC,
+                Chip8_trapName(proc->trap), proc->trapOpcode);
+    }
+    if (!reading && proc->trap == CHIP8_TRAP_NONE && proc->waitKey >= 0) {
+        fprintf(stderr, "%03X - Stopped waiting for a key with no input\n",
+                proc->PC - 2);
+    }
+    if (reading && input.delivered > 0) {
+        fprintf(stderr, "%llu key events, latency %.3fms mean, "
+                "%.3fms max\n", (unsigned long long) input.delivered,
+                input.latencyTotal / 1e6 / input.delivered,
+                input.latencyMax / 1e6);
+    }
     printf("Done.\n");
+    if (config.headless) {
+        printf("%llu instructions in %.3fs (%.0f IPS), %llu idle\n",
+                (unsigned long long) stats.cycles, stats.seconds, stats.ips,
+                (unsigned long long) stats.idleCycles);
+    }
 
     // Cleanup
     free(proc);
     proc = NULL;
+    return faulted || !captured || !recorded || !played ? EXIT_FAILURE
+        : EXIT_SUCCESS;
+}
+
+/*
+ * Replay a trace recorded from rom as fast as it goes, presenting frames
+ * as runSingle does, and report whether the run stayed in step with it
+ */
+int runReplay(const Chip8Rom *rom, const Options *options) {
+    if (!Chip8Rom_valid(rom)) {
+        fprintf(stderr, "%s: %zu bytes does not fit 0x200-0xFFF "
+                "(1 to %d bytes)\n", rom->name, rom->size, CHIP8_MAX_ROM_SIZE);
+        return EXIT_FAILURE;
+    }
+    Chip8TraceReader reader;
+    if (!Chip8TraceReader_open(&reader, options->replayPath)) {
+        perror(options->replayPath);
+        return EXIT_FAILURE;
+    }
+    capturing = options->capturePath != NULL;
+    if (capturing && !Chip8Capture_open(&capture, options->capturePath)) {
+        perror(options->capturePath);
+        Chip8TraceReader_close(&reader);
+        return EXIT_FAILURE;
+    }
+    displaying = options->display && openDisplay(options);
+    Chip8Proc *proc = aligned_alloc(_Alignof(Chip8Proc), sizeof(Chip8Proc));
+    OOM_GUARD(proc, __FILE__, __LINE__);
+    running = proc;
+    // The trace says which mode it was recorded in
+    Chip8_initAt(proc, rom->data, rom->size,
+            displaying || capturing ? presentFrame : NULL, NULL,
+            reader.superMode);
+    Chip8Aot_attach(proc, rom->data, rom->size);
+    if (options->jit && !Chip8Jit_enable(proc)) {
+        fprintf(stderr, "JIT unavailable, interpreting\n");
+    }
+
+    uint64_t start = Chip8Input_now();
+    Chip8ReplayResult result = Chip8Trace_replay(&reader, proc, rom->data,
+            rom->size);
+    double seconds = (Chip8Input_now() - start) / 1e9;
+    Chip8Jit_disable(proc);
+    if (displaying) {
+        closeDisplay();
+    }
+    bool captured = true;
+    if (capturing) {
+        captured = Chip8Capture_close(&capture);
+        if (!captured) {
+            perror(options->capturePath);
+        }
+    }
+    if (result == CHIP8_REPLAY_DONE) {
+        printf("Replayed %llu records: %llu instructions in %.3fs "
+                "(%.0f IPS)\n", (unsigned long long) reader.records,
+                (unsigned long long) proc->cycles, seconds,
+                seconds > 0 ? proc->cycles / seconds : 0);
+    } else {
+        fprintf(stderr, "%s: %s at record %llu, instruction %llu\n",
+                options->replayPath, Chip8_replayResultName(result),
+                (unsigned long long) reader.records,
+                (unsigned long long) reader.cycles);
+    }
+
+    Chip8TraceReader_close(&reader);
+    free(proc);
+    proc = NULL;
+    return result != CHIP8_REPLAY_DONE || !captured ? EXIT_FAILURE
+        : EXIT_SUCCESS;
+}
+
+/*
+ * Run one ROM under the debugger console on stdin and stdout
+ */
+int runDebug(const Chip8Rom *rom, const Options *options) {
+    if (!Chip8Rom_valid(rom)) {
+        fprintf(stderr, "%s: %zu bytes does not fit 0x200-0xFFF "
+                "(1 to %d bytes)\n", rom->name, rom->size, CHIP8_MAX_ROM_SIZE);
+        return EXIT_FAILURE;
+    }
+    Chip8Proc *proc = aligned_alloc(_Alignof(Chip8Proc), sizeof(Chip8Proc));
+    OOM_GUARD(proc, __FILE__, __LINE__);
+    Chip8Debug *debug = malloc(sizeof(Chip8Debug));
+    OOM_GUARD(debug, __FILE__, __LINE__);
+    Chip8_initAt(proc, rom->data, rom->size, NULL, NULL, options->superMode);
+    Chip8_seed(proc, options->seed);
+    Chip8Aot_attach(proc, rom->data, rom->size);
+    if (options->jit && !Chip8Jit_enable(proc)) {
+        fprintf(stderr, "JIT unavailable, interpreting\n");
+    }
+    Chip8Debug_init(debug);
+    proc->debug = debug;
+    Chip8Console_run(proc, options->ipf, stdin, stdout);
+
+    Chip8Jit_disable(proc);
+    free(debug);
+    free(proc);
     return EXIT_SUCCESS;
 }
 
-void printScreenCompact(bool *screen) {
-    printf("\xE2\x96\x88");
-    for (int i = 0; i < 130; ++i) { printf("\xE2\x96\x80"); }
-    printf("\xE2\x96\x88\n");
-    for (int r = 0; r < 64; r += 2) {
-        printf("\xE2\x96\x88 ");
-        for (int c = 0; c < 128; ++c) {
-            if (screen[r * 128 + c]) {
-                if (screen[(r + 1) * 128 + c]) {
-                    printf("\xE2\x96\x88");
-                } else {
-                    printf("\xE2\x96\x80");
-                }
-            } else {
-                if (screen[(r + 1) * 128 + c ]) {
-                    printf("\xE2\x96\x84");
-                } else {
-                    printf(" ");
-                }
+/*
+ * Run every ROM in the set headlessly and print one line per ROM:
+ * name, exit reason, instructions, screen hash and, for faults, the trap
+ */
+int runBatch(const Chip8RomSet *set, const Options *options) {
+    Chip8BatchConfig config = {
+        .budget = options->budget != 0 ? options->budget
+            : DEFAULT_BATCH_BUDGET,
+        .ipf = options->ipf,
+        .threads = options->threads,
+        .seed = options->seed,
+        .superMode = options->superMode,
+        .jit = options->jit
+    };
+    Chip8BatchResult *results = malloc(set->count * sizeof(Chip8BatchResult));
+    OOM_GUARD(results, __FILE__, __LINE__);
+    Chip8Batch_run(set->roms, set->count, &config, results);
+    for (size_t i = 0; i < set->count; ++i) {
+        printf("%s\t%s\t%llu\t%016llx", set->roms[i].name,
+                Chip8_exitReasonName(results[i].reason),
+                (unsigned long long) results[i].cycles,
+                (unsigned long long) results[i].screenHash);
+        if (results[i].reason == CHIP8_EXIT_FAULT) {
+            printf("\t%03X %04X %s", results[i].trapPC,
+                    results[i].trapOpcode, Chip8_trapName(results[i].trap));
+        }
+        putchar('\n');
+    }
+    free(results);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Put a terminal on stdin into unbuffered, silent mode and start the
+ * thread feeding its key presses to input.
+ * Returns false, reading no keys, if stdin is not a terminal.
+ */
+bool startInput(pthread_t *thread) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTermios) != 0) {
+        return false;
+    }
+    struct termios raw = savedTermios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    // Ctrl-C still stops the emulator, but must leave the terminal usable
+    struct sigaction action = { .sa_handler = restoreTerminal };
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    Chip8Input_init(&input);
+    atomic_store(&inputStop, false);
+    if (pthread_create(thread, NULL, readKeys, NULL) != 0) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+        return false;
+    }
+    return true;
+}
+
+void stopInput(pthread_t thread) {
+    atomic_store(&inputStop, true);
+    pthread_join(thread, NULL);
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+}
+
+/*
+ * Input thread: push a press for each mapped key read from stdin, and its
+ * release once KEY_HOLD_NS pass without another
+ */
+void *readKeys(void *unused) {
+    (void) unused;
+    uint64_t releaseAt[16] = { 0 };
+    while (!atomic_load(&inputStop)) {
+        int timeout = INPUT_POLL_MS;
+        uint64_t now = Chip8Input_now();
+        for (int k = 0; k < 16; ++k) {
+            if (releaseAt[k] == 0) {
+                continue;
+            }
+            if (releaseAt[k] <= now) {
+                Chip8Input_push(&input, k, false);
+                releaseAt[k] = 0;
+            } else if ((releaseAt[k] - now) / 1000000 + 1 < (uint64_t) timeout) {
+                timeout = (releaseAt[k] - now) / 1000000 + 1;
             }
         }
-        printf(" \xE2\x96\x88\n");
-    }
-    printf("\xE2\x96\x88");
-    for (int i = 0; i < 130; ++i) { printf("\xE2\x96\x84"); }
-    printf("\xE2\x96\x88\n");
-    putchar('\n');
-}
-
-void printScreen(bool *screen) {
-    putchar('+');
-    for (int i = 0; i < 128; ++i) { putchar('-'); }
-    putchar('+');
-    putchar('\n');
-    for (int r = 0; r < 64; ++r) {
-        putchar('|');
-        for (int c = 0; c < 128; ++c) {
-            putchar(screen[r * 128 + c] ? '#' : ' ');
+        struct pollfd fd = { .fd = STDIN_FILENO, .events = POLLIN };
+        if (poll(&fd, 1, timeout) <= 0) {
+            continue;
         }
-        putchar('|');
-        putchar('\n');
+        char keys[64];
+        ssize_t count = read(STDIN_FILENO, keys, sizeof(keys));
+        now = Chip8Input_now();
+        for (ssize_t i = 0; i < count; ++i) {
+            const char *mapped = memchr(keyMap, keys[i], sizeof(keyMap));
+            if (mapped == NULL) {
+                continue;
+            }
+            int k = mapped - keyMap;
+            // Auto-repeat only keeps a held key down
+            if (releaseAt[k] == 0) {
+                Chip8Input_push(&input, k, true);
+            }
+            releaseAt[k] = now + KEY_HOLD_NS;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Signal handler: put the terminal back before dying
+ */
+void restoreTerminal(int number) {
+    static const char showCursor[] = "\x1b[?25h\n";
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+    if (write(STDOUT_FILENO, showCursor, sizeof(showCursor) - 1) < 0) {
+        // Nothing more can be done
+    }
+    _exit(128 + number);
+}
+
+#ifdef CHIP8_PROFILE
+void writeProfile(const Chip8Profile *profile, const Chip8Proc *proc) {
+    Chip8Profile_writeReport(profile, proc, PROFILE_TOP, stderr);
+    FILE *folded = fopen(PROFILE_FOLDED_PATH, "w");
+    if (folded == NULL) {
+        perror(PROFILE_FOLDED_PATH);
+        return;
+    }
+    Chip8Profile_writeFolded(profile, folded);
+    fclose(folded);
+    fprintf(stderr, "Call stacks written to " PROFILE_FOLDED_PATH "\n");
+}
+#endif
+
+void presentFrame(uint64_t screen[64][2], uint64_t dirtyRows) {
+    if (capturing) {
+        Chip8Capture_frame(&capture, screen, dirtyRows, running->cycles);
+    }
+    if (displaying) {
+        Chip8Presenter_publish(&presenter, screen, running->cycles);
+    }
+}
+
+/*
+ * Render thread: show a frame on the terminal
+ */
+void renderFrame(Chip8Frame *frame, void *unused) {
+    (void) unused;
+    Chip8Term_present(&terminal, frame->screen);
+}
+
+/*
+ * Set up the terminal and start the render thread showing frames on it.
+ * Returns false, showing nothing, after reporting why it cannot.
+ */
+bool openDisplay(const Options *options) {
+    // The render thread limits the frame rate
+    Chip8Term_init(&terminal, STDOUT_FILENO, options->style, 0);
+    if (!Chip8Presenter_open(&presenter, DISPLAY_REFRESH_HZ, renderFrame,
+                NULL)) {
+        perror("No render thread, not displaying");
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Stop the render thread once it has shown the last frame, and report how
+ * many frames it kept up with
+ */
+void closeDisplay(void) {
+    Chip8Presenter_close(&presenter);
+    Chip8Term_close(&terminal);
+    if (presenter.published > 0) {
+        fprintf(stderr, "%llu frames published, %llu shown, %llu unchanged, "
+                "%llu dropped", (unsigned long long) presenter.published,
+                (unsigned long long) presenter.presented,
+                (unsigned long long) presenter.unchanged,
+                (unsigned long long) presenter.dropped);
+        // Every frame may have been dropped or unchanged
+        if (presenter.presented > 0) {
+            fprintf(stderr, ", latency %.3fms mean, %.3fms max",
+                    presenter.latencyTotal / 1e6 / presenter.presented,
+                    presenter.latencyMax / 1e6);
+        }
+        fputc('\n', stderr);
     }
-    putchar('+');
-    for (int i = 0; i < 128; ++i) { putchar('-'); }
-    putchar('+');
-    putchar('\n');
 }
@@ -37,7 +37,7 @@ init() {
     fi
 
     # Symbolically link project dirs into build directory
-    link_dirs="test include src"
+    link_dirs="test include src tools"
     for dir in ${link_dirs}; do
         source_dir="${project_dir}/${dir}"
         link_dir="${build_dir}/${dir}"
@@ -57,7 +57,9 @@ init() {
 # run it when there's a new test file entirely.
 sync_cmake() {
     test_makefile="${build_dir}/Makefile"
-    tests=$(ls $unit_tests_dir)
+    # Test sources, and ROMs compiled ahead of time for them
+    tests=$(cd "${unit_tests_dir}" && ls *.cpp)
+    tests="${tests} $(ls ${project_dir}/test/aot)"
 
     if [ -f "${test_makefile}" ]; then
         rebuild="false"
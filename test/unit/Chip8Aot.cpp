@@ -0,0 +1,65 @@
+#include <cstring>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Aot.h"
+#include "Chip8Rom.h"
+}
+
+using namespace chip8test;
+
+/*
+ * Every ROM in test/aot, compiled ahead of time into the tests, must leave
+ * the processor after every frame exactly as the threaded interpreter
+ * does, in the quirk mode it was compiled for
+ */
+TEST(Chip8Aot, MatchesThreadedOnCompiledRoms) {
+    Chip8RomSet roms;
+    Chip8RomSet_init(&roms);
+    ASSERT_TRUE(Chip8RomSet_add(&roms, AOT_ROM_DIR));
+    ASSERT_GT(roms.count, 0u);
+    for (size_t r = 0; r < roms.count; ++r) {
+        const Chip8Rom &rom = roms.roms[r];
+        bool superMode = std::strstr(rom.name, ".sc8") != NULL;
+        std::vector<uint8_t> program(rom.data, rom.data + rom.size);
+        auto threaded = newProc(program, superMode);
+        auto compiled = newProc(program, superMode);
+        ASSERT_TRUE(Chip8Aot_attach(compiled.get(), rom.data, rom.size))
+            << rom.name;
+        uint32_t state = r + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            unsigned ipf = 1 + keys % 40;
+            bool running = runFrame(threaded.get(), frame, ipf, keys);
+            runFrame(compiled.get(), frame, ipf, keys);
+            ASSERT_TRUE(sameState(*threaded, *compiled))
+                << rom.name << ", frame " << frame;
+            if (!running) {
+                break;
+            }
+        }
+    }
+    Chip8RomSet_free(&roms);
+}
+
+/*
+ * A processor loaded with a program nothing was compiled from, or in the
+ * other quirk mode, gets no module
+ */
+TEST(Chip8Aot, AttachesOnlyToItsRom) {
+    Chip8RomSet roms;
+    Chip8RomSet_init(&roms);
+    ASSERT_TRUE(Chip8RomSet_add(&roms, AOT_ROM_DIR));
+    ASSERT_GT(roms.count, 0u);
+    const Chip8Rom &rom = roms.roms[0];
+    bool superMode = std::strstr(rom.name, ".sc8") != NULL;
+    std::vector<uint8_t> program(rom.data, rom.data + rom.size);
+    auto otherMode = newProc(program, !superMode);
+    EXPECT_FALSE(Chip8Aot_attach(otherMode.get(), rom.data, rom.size));
+    program[0] ^= 0xFF;
+    auto otherProgram = newProc(program, superMode);
+    EXPECT_FALSE(Chip8Aot_attach(otherProgram.get(), program.data(),
+                program.size()));
+    Chip8RomSet_free(&roms);
+}
@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Audio.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+const char *PATH = "chip8_audio_test.wav";
+
+/*
+ * The 16-bit samples of the WAV file at PATH, after checking that its
+ * header gives their size
+ */
+std::vector<int16_t> readSamples() {
+    std::ifstream file(PATH, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+            std::istreambuf_iterator<char>());
+    std::vector<int16_t> samples;
+    if (bytes.size() < 44 || std::memcmp(bytes.data(), "RIFF", 4) != 0
+            || std::memcmp(bytes.data() + 36, "data", 4) != 0) {
+        ADD_FAILURE() << "not a WAV file";
+        return samples;
+    }
+    auto le32 = [&](size_t at) {
+        return bytes[at] | bytes[at + 1] << 8 | bytes[at + 2] << 16
+            | (uint32_t) bytes[at + 3] << 24;
+    };
+    EXPECT_EQ(le32(4), bytes.size() - 8);
+    EXPECT_EQ(le32(40), bytes.size() - 44);
+    for (size_t at = 44; at + 1 < bytes.size(); at += 2) {
+        samples.push_back((int16_t) (bytes[at] | bytes[at + 1] << 8));
+    }
+    return samples;
+}
+
+}
+
+/*
+ * A headless run into an offline WAV sink keeps every sample, far more
+ * than the ring holds, and the tone lasts exactly as many frames as Fx18
+ * sets the sound timer to
+ */
+TEST(Chip8Audio, WritesEveryHeadlessSample) {
+    std::vector<uint8_t> program = {
+        0x60, 0x10,     // 200: V0 = 16
+        0xF0, 0x18,     // 202: S = V0
+        0x12, 0x04      // 204: jump to itself
+    };
+    const unsigned FRAMES_RUN = 600, IPF = 10, SOUNDING = 16;
+    for (unsigned rate : { 48000u, 44100u, 8000u }) {
+        std::unique_ptr<Chip8Audio> audio(new Chip8Audio);
+        ASSERT_TRUE(Chip8Audio_open(audio.get(), CHIP8_AUDIO_WAV_OFFLINE,
+                    PATH, rate));
+        auto proc = newProc(program, false);
+        Chip8RunConfig config = {};
+        config.ipf = IPF;
+        config.headless = true;
+        config.maxCycles = FRAMES_RUN * IPF;
+        config.audio = audio.get();
+        Chip8RunStats stats = Chip8_run(proc.get(), &config);
+        ASSERT_EQ(stats.frames, FRAMES_RUN);
+        ASSERT_TRUE(Chip8Audio_close(audio.get()));
+
+        uint64_t expected = (uint64_t) FRAMES_RUN * rate / 60;
+        EXPECT_EQ(audio->produced, expected) << rate;
+        EXPECT_EQ(audio->consumed, expected) << rate;
+        EXPECT_EQ(audio->dropped, 0u) << rate;
+        std::vector<int16_t> samples = readSamples();
+        ASSERT_EQ(samples.size(), expected) << rate;
+        // The square wave never crosses 0, so the tone is every sample
+        // that is not silence, and they come first
+        size_t sounding = SOUNDING * rate / 60, tone = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            if (samples[i] != 0) {
+                ++tone;
+                EXPECT_LT(i, sounding) << rate;
+            }
+        }
+        EXPECT_EQ(tone, sounding) << rate;
+    }
+    std::remove(PATH);
+}
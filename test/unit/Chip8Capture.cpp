@@ -0,0 +1,184 @@
+#include <array>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Capture.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+typedef std::array<uint64_t, 128> Screen;
+
+const char *PATH = "chip8_capture_test.cap";
+
+// The capture the processor presents to, with the screens and cycle counts
+// it was handed, for presentFrame to reach
+Chip8Capture *capture;
+const Chip8Proc *running;
+std::vector<Screen> screens;
+std::vector<uint64_t> cycles;
+
+Screen copyScreen(const uint64_t screen[64][2]) {
+    Screen copy;
+    std::memcpy(copy.data(), screen, sizeof(copy));
+    return copy;
+}
+
+void presentFrame(uint64_t screen[64][2], uint64_t dirtyRows) {
+    Chip8Capture_frame(capture, screen, dirtyRows, running->cycles);
+    screens.push_back(copyScreen(screen));
+    cycles.push_back(running->cycles);
+}
+
+/*
+ * Success if the capture at PATH holds exactly the frames in screens and
+ * cycles
+ */
+::testing::AssertionResult readsBack() {
+    Chip8CaptureReader reader;
+    if (!Chip8CaptureReader_open(&reader, PATH)) {
+        return ::testing::AssertionFailure() << "cannot open the capture";
+    }
+    size_t frame = 0;
+    for (; Chip8CaptureReader_next(&reader); ++frame) {
+        if (frame == screens.size()) {
+            break;
+        }
+        if (copyScreen(reader.screen) != screens[frame]
+                || reader.cycles != cycles[frame]) {
+            Chip8CaptureReader_close(&reader);
+            return ::testing::AssertionFailure() << "frame " << frame
+                << " differs";
+        }
+    }
+    bool corrupt = reader.corrupt;
+    Chip8CaptureReader_close(&reader);
+    if (corrupt) {
+        return ::testing::AssertionFailure() << "corrupt after frame "
+            << frame;
+    }
+    if (frame != screens.size()) {
+        return ::testing::AssertionFailure() << frame << " frames read, "
+            << screens.size() << " recorded";
+    }
+    return ::testing::AssertionSuccess();
+}
+
+}
+
+/*
+ * Blank frames, frames that repeat the last one and frames that change
+ * every pixel read back as recorded, and frames with nothing new take just
+ * their two varints
+ */
+TEST(Chip8Capture, RoundTripsWholeScreenChanges) {
+    std::unique_ptr<Chip8Capture> owned(new Chip8Capture);
+    capture = owned.get();
+    screens.clear();
+    cycles.clear();
+    ASSERT_TRUE(Chip8Capture_open(capture, PATH));
+
+    uint64_t screen[64][2] = {};
+    auto record = [&](uint64_t dirtyRows, uint64_t at) {
+        Chip8Capture_frame(capture, screen, dirtyRows, at);
+        screens.push_back(copyScreen(screen));
+        cycles.push_back(at);
+    };
+    // Blank frames, first with every row dirty, then with none
+    record(~0ULL, 10);
+    record(0, 20);
+    record(0, 20);
+    // Every pixel lit, then that again, then every pixel cleared
+    std::memset(screen, 0xFF, sizeof(screen));
+    record(~0ULL, 30);
+    record(~0ULL, 1000);
+    std::memset(screen, 0, sizeof(screen));
+    record(~0ULL, 1000);
+    // Alternating pixels, then their inverse
+    for (int r = 0; r < 64; ++r) {
+        screen[r][0] = screen[r][1] = r & 1 ? 0x5555555555555555ULL
+            : 0xAAAAAAAAAAAAAAAAULL;
+    }
+    record(~0ULL, 1001);
+    for (int r = 0; r < 64; ++r) {
+        screen[r][0] = ~screen[r][0];
+        screen[r][1] = ~screen[r][1];
+    }
+    record(~0ULL, 1002);
+    ASSERT_TRUE(Chip8Capture_close(capture));
+    EXPECT_EQ(capture->frames, screens.size());
+    EXPECT_TRUE(readsBack());
+
+    // A capture of frames that change nothing is the header and two
+    // one-byte varints a frame
+    ASSERT_TRUE(Chip8Capture_open(capture, PATH));
+    std::memset(screen, 0, sizeof(screen));
+    for (int frame = 0; frame < 100; ++frame) {
+        Chip8Capture_frame(capture, screen, frame % 2 ? ~0ULL : 0, frame);
+    }
+    ASSERT_TRUE(Chip8Capture_close(capture));
+    struct stat st;
+    ASSERT_EQ(stat(PATH, &st), 0);
+    EXPECT_EQ(st.st_size, CHIP8_CAPTURE_HEADER_SIZE + 100 * 2);
+    std::remove(PATH);
+}
+
+/*
+ * A program that switches between high and low resolution while it draws,
+ * and random programs, capture every presented frame faithfully
+ */
+TEST(Chip8Capture, RoundTripsRunningPrograms) {
+    std::vector<std::vector<uint8_t>> programs = {
+        {
+            0x00, 0xFF,     // 200: high resolution
+            0xA2, 0x1C,     // 202: I = 21C
+            0xD0, 0x15,     // 204: draw 5 rows at V0, V1
+            0x70, 0x07,     // 206: V0 += 7
+            0x71, 0x03,     // 208: V1 += 3
+            0x00, 0xFE,     // 20A: low resolution
+            0xD0, 0x15,     // 20C: draw 5 rows at V0, V1
+            0x70, 0x05,     // 20E: V0 += 5
+            0x72, 0x01,     // 210: V2 += 1
+            0x32, 0x08,     // 212: skip if V2 == 8
+            0x12, 0x00,     // 214: jump to 200
+            0x00, 0xE0,     // 216: clear the screen
+            0x62, 0x00,     // 218: V2 = 0
+            0x12, 0x00,     // 21A: jump to 200
+            0xF0, 0x90, 0xF0, 0x90, 0xF0, 0x00
+        }
+    };
+    for (uint32_t seed = 0; seed < 20; ++seed) {
+        programs.push_back(randomProgram(seed, 256));
+    }
+    std::unique_ptr<Chip8Capture> owned(new Chip8Capture);
+    capture = owned.get();
+    size_t presented = 0;
+    for (size_t p = 0; p < programs.size(); ++p) {
+        screens.clear();
+        cycles.clear();
+        ASSERT_TRUE(Chip8Capture_open(capture, PATH));
+        std::unique_ptr<Chip8Proc> proc(new Chip8Proc);
+        Chip8_initAt(proc.get(), programs[p].data(), programs[p].size(),
+                presentFrame, NULL, true);
+        running = proc.get();
+        uint32_t state = p + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            bool ran = runFrame(proc.get(), frame, 1 + keys % 7, keys);
+            Chip8_present(proc.get());
+            if (!ran) {
+                break;
+            }
+        }
+        ASSERT_TRUE(Chip8Capture_close(capture));
+        EXPECT_TRUE(readsBack()) << "program " << p;
+        presented += screens.size();
+    }
+    EXPECT_GT(presented, FRAMES);
+    std::remove(PATH);
+}
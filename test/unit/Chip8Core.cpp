@@ -0,0 +1,75 @@
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Jit.h"
+}
+
+using namespace chip8test;
+
+/*
+ * A call with the stack full traps, leaving SC at the last entry and the
+ * stack as it was, in every engine
+ */
+TEST(Chip8Core, TrapsStackOverflowWithFullStack) {
+    static const uint8_t code[] = {
+        0x22, 0x00   // 200: call 200
+    };
+    std::vector<uint8_t> program(code, code + sizeof(code));
+    for (int engine = 0; engine < 3; ++engine) {
+        auto proc = newProc(program, false);
+        proc->referenceMode = engine == 0;
+        if (engine == 2 && !Chip8Jit_enable(proc.get())) {
+            continue;
+        }
+        EXPECT_FALSE(Chip8_execute(proc.get(), 100)) << "engine " << engine;
+        EXPECT_EQ(proc->trap, CHIP8_TRAP_STACK_OVERFLOW);
+        EXPECT_EQ(proc->SC, 15) << "engine " << engine;
+        EXPECT_EQ(proc->trapPC, 0x200);
+        for (int s = 0; s < 16; ++s) {
+            EXPECT_EQ(proc->stack[s], 0x200);
+        }
+        Chip8Jit_disable(proc.get());
+    }
+}
+
+/*
+ * A processor reset after running one program must be byte for byte the
+ * processor Chip8_initAt creates for the next
+ */
+TEST(Chip8Core, ResetMatchesInit) {
+    auto fresh = newProc({}, true);
+    Chip8_seed(fresh.get(), 42);
+    for (uint32_t seed = 0; seed < 20; ++seed) {
+        auto proc = newProc(randomProgram(seed, 512), true);
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            if (!runFrame(proc.get(), frame, 1 + keys % 40, keys)) {
+                break;
+            }
+        }
+        std::vector<uint8_t> next = randomProgram(seed + 100, 2 * seed);
+        Chip8_reset(proc.get(), fresh.get(), next.data(), next.size());
+        auto expected = newProc(next, true);
+        Chip8_seed(expected.get(), 42);
+        EXPECT_EQ(std::memcmp(proc.get(), expected.get(), sizeof(Chip8Proc)),
+                0) << "seed " << seed;
+    }
+}
+
+/*
+ * A program too long for ram is cut short rather than written past it
+ */
+TEST(Chip8Core, CutsShortOversizedPrograms) {
+    std::vector<uint8_t> program(CHIP8_MAX_ROM_SIZE + 1000, 0xAB);
+    auto proc = newProc(program, false);
+    auto fresh = newProc({}, false);
+    auto reset = newProc({}, false);
+    Chip8_reset(reset.get(), fresh.get(), program.data(), program.size());
+    for (const Chip8Proc *p : { proc.get(), reset.get() }) {
+        EXPECT_EQ(p->ram[0xFFF], 0xAB);
+        EXPECT_EQ(p->PC, 0x200);
+        EXPECT_EQ(p->SC, -1);
+    }
+    EXPECT_EQ(std::memcmp(proc.get(), reset.get(), sizeof(Chip8Proc)), 0);
+}
@@ -0,0 +1,305 @@
+#include <cerrno>
+#include <cstdio>
+#include <string>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Console.h"
+#include "Chip8Debug.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+/*
+ * A processor running program with a fresh Chip8Debug attached
+ */
+struct Debugged {
+    std::unique_ptr<Chip8Proc> proc;
+    std::unique_ptr<Chip8Debug> debug;
+
+    explicit Debugged(const std::vector<uint8_t> &program)
+            : proc(newProc(program, false)), debug(new Chip8Debug) {
+        Chip8Debug_init(debug.get());
+        proc->debug = debug.get();
+    }
+};
+
+}
+
+/*
+ * A breakpoint stops before the instruction at it, and resuming lets that
+ * instruction through once before the breakpoint stops it again
+ */
+TEST(Chip8Debug, StopsAtBreakpoints) {
+    Debugged run({
+        0x60, 0x01,     // 200: V0 = 1
+        0x71, 0x01,     // 202: V1 += 1
+        0x12, 0x02      // 204: jump to 202
+    });
+    Chip8Proc *proc = run.proc.get();
+    ASSERT_TRUE(Chip8Debug_setBreak(run.debug.get(), 0x204, true));
+    for (unsigned pass = 1; pass <= 3; ++pass) {
+        EXPECT_FALSE(Chip8_execute(proc, 100));
+        EXPECT_EQ(proc->trap, CHIP8_TRAP_BREAK);
+        EXPECT_EQ(proc->PC, 0x204);
+        EXPECT_EQ(proc->V[1], pass);
+        EXPECT_EQ(proc->cycles, 2 * pass);
+        EXPECT_EQ(run.debug->stop.kind, CHIP8_STOP_BREAKPOINT);
+        // Stopped, it stays stopped
+        EXPECT_FALSE(Chip8_execute(proc, 100));
+        EXPECT_EQ(proc->cycles, 2 * pass);
+        Chip8Debug_resume(proc);
+        EXPECT_EQ(proc->trap, CHIP8_TRAP_NONE);
+        EXPECT_EQ(run.debug->stop.kind, CHIP8_STOP_NONE);
+    }
+    // Resuming a processor that is not stopped lets nothing through
+    EXPECT_TRUE(Chip8_execute(proc, 1));
+    EXPECT_EQ(proc->PC, 0x202);
+    Chip8Debug_resume(proc);
+    EXPECT_TRUE(Chip8_execute(proc, 1));
+    EXPECT_FALSE(Chip8_execute(proc, 1));
+    EXPECT_EQ(proc->PC, 0x204);
+
+    EXPECT_FALSE(Chip8Debug_setBreak(run.debug.get(), 0x1000, true));
+    EXPECT_EQ(errno, EINVAL);
+}
+
+/*
+ * Watchpoints stop Dxyn, Fx33, Fx55 and Fx65 before they touch a watched
+ * byte of the range they access, and only for the kind of access watched
+ */
+TEST(Chip8Debug, StopsAtWatchedRam) {
+    static const struct {
+        const char *name;
+        std::vector<uint8_t> program;
+        uint16_t at;
+        uint16_t watch;
+        int kind;
+        bool stops;
+    } cases[] = {
+        // Dxyn reads n bytes from I
+        { "D015", { 0xA3, 0x00, 0xD0, 0x15, 0x12, 0x04 }, 0x202, 0x304,
+            CHIP8_WATCH_READ, true },
+        { "D015 past", { 0xA3, 0x00, 0xD0, 0x15, 0x12, 0x04 }, 0x202, 0x305,
+            CHIP8_WATCH_READ, false },
+        { "D015 write", { 0xA3, 0x00, 0xD0, 0x15, 0x12, 0x04 }, 0x202, 0x300,
+            CHIP8_WATCH_WRITE, false },
+        // Fx33 writes three digits at I
+        { "F033", { 0x60, 0xFF, 0xA3, 0x00, 0xF0, 0x33, 0x12, 0x06 }, 0x204,
+            0x302, CHIP8_WATCH_WRITE, true },
+        { "F033 read", { 0x60, 0xFF, 0xA3, 0x00, 0xF0, 0x33, 0x12, 0x06 },
+            0x204, 0x302, CHIP8_WATCH_READ, false },
+        // Fx55 writes V0..V(x-1) at I, and Fx65 reads them
+        { "F355", { 0x62, 0x07, 0xA3, 0x00, 0xF3, 0x55, 0x12, 0x06 }, 0x204,
+            0x302, CHIP8_WATCH_WRITE, true },
+        { "F355 past", { 0x62, 0x07, 0xA3, 0x00, 0xF3, 0x55, 0x12, 0x06 },
+            0x204, 0x303, CHIP8_WATCH_WRITE, false },
+        { "F365", { 0xA2, 0x00, 0xF3, 0x65, 0x12, 0x04 }, 0x202, 0x200,
+            CHIP8_WATCH_READ, true },
+        { "F365 write", { 0xA2, 0x00, 0xF3, 0x65, 0x12, 0x04 }, 0x202, 0x200,
+            CHIP8_WATCH_WRITE, false },
+    };
+    for (const auto &test : cases) {
+        Debugged run(test.program);
+        Chip8Proc *proc = run.proc.get();
+        ASSERT_TRUE(Chip8Debug_setWatch(run.debug.get(), test.watch, 1,
+                    test.kind, true));
+        auto reference = newProc(test.program, false);
+        bool running = Chip8_execute(proc, 100);
+        if (!test.stops) {
+            EXPECT_TRUE(running) << test.name;
+            EXPECT_EQ(proc->trap, CHIP8_TRAP_NONE) << test.name;
+            continue;
+        }
+        EXPECT_FALSE(running) << test.name;
+        EXPECT_EQ(proc->trap, CHIP8_TRAP_BREAK) << test.name;
+        EXPECT_EQ(proc->PC, test.at) << test.name;
+        EXPECT_EQ(run.debug->stop.kind, test.kind == CHIP8_WATCH_READ
+                ? CHIP8_STOP_READ : CHIP8_STOP_WRITE) << test.name;
+        EXPECT_EQ(run.debug->stop.addr, test.watch) << test.name;
+
+        // Nothing of the instruction has happened yet, and once resumed it
+        // runs as it would have
+        Chip8_execute(reference.get(), proc->cycles);
+        auto same = [&] {
+            return std::memcmp(proc->ram, reference->ram,
+                        sizeof(proc->ram)) == 0
+                && std::memcmp(proc->V, reference->V, sizeof(proc->V)) == 0
+                && std::memcmp(proc->screen, reference->screen,
+                        sizeof(proc->screen)) == 0
+                && proc->I == reference->I && proc->PC == reference->PC
+                && proc->cycles == reference->cycles;
+        };
+        EXPECT_TRUE(same()) << test.name;
+        Chip8Debug_resume(proc);
+        EXPECT_TRUE(Chip8_execute(proc, 1)) << test.name;
+        Chip8_execute(reference.get(), 1);
+        EXPECT_TRUE(same()) << test.name;
+    }
+    Debugged run({ 0x12, 0x00 });
+    EXPECT_FALSE(Chip8Debug_setWatch(run.debug.get(), 0xFFF, 2,
+                CHIP8_WATCH_READ, true));
+    EXPECT_EQ(errno, EINVAL);
+}
+
+/*
+ * Conditions stop before any instruction, or the one at their address,
+ * once the register compares as asked
+ */
+TEST(Chip8Debug, StopsOnConditions) {
+    std::vector<uint8_t> program = {
+        0x70, 0x01,     // 200: V0 += 1
+        0xA2, 0x10,     // 202: I = 210
+        0x12, 0x00      // 204: jump to 200
+    };
+    {
+        Debugged run(program);
+        int index = Chip8Debug_addCondition(run.debug.get(), -1, 0x0,
+                CHIP8_CMP_EQ, 5);
+        ASSERT_GE(index, 0);
+        EXPECT_FALSE(Chip8_execute(run.proc.get(), 100));
+        EXPECT_EQ(run.proc->V[0], 5);
+        EXPECT_EQ(run.proc->PC, 0x202);
+        EXPECT_EQ(run.debug->stop.kind, CHIP8_STOP_CONDITION);
+        EXPECT_EQ(run.debug->stop.index, index);
+        // Still true after the instruction let through, so it stops again
+        Chip8Debug_resume(run.proc.get());
+        EXPECT_FALSE(Chip8_execute(run.proc.get(), 100));
+        EXPECT_EQ(run.proc->PC, 0x204);
+    }
+    {
+        Debugged run(program);
+        int index = Chip8Debug_addCondition(run.debug.get(), 0x200, 0x0,
+                CHIP8_CMP_GE, 3);
+        ASSERT_GE(index, 0);
+        EXPECT_FALSE(Chip8_execute(run.proc.get(), 100));
+        EXPECT_EQ(run.proc->V[0], 3);
+        EXPECT_EQ(run.proc->PC, 0x200);
+        EXPECT_EQ(run.debug->stop.index, index);
+    }
+    {
+        Debugged run(program);
+        ASSERT_GE(Chip8Debug_addCondition(run.debug.get(), -1, CHIP8_REG_I,
+                    CHIP8_CMP_GT, 0x20F), 0);
+        EXPECT_FALSE(Chip8_execute(run.proc.get(), 100));
+        EXPECT_EQ(run.proc->I, 0x210);
+        EXPECT_EQ(run.proc->PC, 0x204);
+    }
+    Debugged run(program);
+    EXPECT_EQ(Chip8Debug_addCondition(run.debug.get(), -1, CHIP8_REG_SC + 1,
+                CHIP8_CMP_EQ, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+    for (int c = 0; c < CHIP8_DEBUG_CONDITIONS; ++c) {
+        EXPECT_EQ(Chip8Debug_addCondition(run.debug.get(), 0x300, 0x0,
+                    CHIP8_CMP_EQ, 0), c);
+    }
+    EXPECT_EQ(Chip8Debug_addCondition(run.debug.get(), 0x300, 0x0,
+                CHIP8_CMP_EQ, 0), -1);
+    EXPECT_EQ(errno, ENOSPC);
+}
+
+/*
+ * armed counts each breakpoint, watched byte and condition once, and drops
+ * back to 0 as they are disarmed; a breakpoint cleared where a condition
+ * is bound leaves the condition checked there
+ */
+TEST(Chip8Debug, CountsWhatIsArmed) {
+    Debugged run({ 0x70, 0x01, 0x12, 0x00 });
+    Chip8Debug *debug = run.debug.get();
+    Chip8Debug_setBreak(debug, 0x200, true);
+    Chip8Debug_setBreak(debug, 0x200, true);
+    EXPECT_EQ(debug->armed, 1u);
+    int index = Chip8Debug_addCondition(debug, 0x200, 0x0, CHIP8_CMP_EQ, 2);
+    EXPECT_EQ(debug->armed, 2u);
+    Chip8Debug_setBreak(debug, 0x200, false);
+    Chip8Debug_setBreak(debug, 0x200, false);
+    EXPECT_EQ(debug->armed, 1u);
+    EXPECT_FALSE(Chip8_execute(run.proc.get(), 100));
+    EXPECT_EQ(debug->stop.kind, CHIP8_STOP_CONDITION);
+    EXPECT_EQ(run.proc->V[0], 2);
+
+    EXPECT_TRUE(Chip8Debug_removeCondition(debug, index));
+    EXPECT_EQ(debug->armed, 0u);
+    EXPECT_FALSE(CHIP8_DEBUGGING(run.proc.get()));
+    EXPECT_FALSE(Chip8Debug_removeCondition(debug, index));
+    EXPECT_EQ(errno, EINVAL);
+    Chip8Debug_resume(run.proc.get());
+    EXPECT_TRUE(Chip8_execute(run.proc.get(), 100));
+
+    Chip8Debug_setWatch(debug, 0x300, 4,
+            CHIP8_WATCH_READ | CHIP8_WATCH_WRITE, true);
+    Chip8Debug_setWatch(debug, 0x302, 4, CHIP8_WATCH_READ, true);
+    EXPECT_EQ(debug->armed, 10u);
+    Chip8Debug_setWatch(debug, 0x300, 6,
+            CHIP8_WATCH_READ | CHIP8_WATCH_WRITE, false);
+    EXPECT_EQ(debug->armed, 0u);
+}
+
+/*
+ * With a debugger attached but nothing armed, programs run on the fast
+ * engines (which skip idle loops) to the same end as without one
+ */
+TEST(Chip8Debug, LeavesFastEnginesAloneWhenDisarmed) {
+    {
+        Debugged run({ 0x12, 0x00 });
+        EXPECT_TRUE(Chip8_execute(run.proc.get(), 1000));
+        EXPECT_GT(run.proc->idleCycles, 0u);
+        Chip8Debug_setBreak(run.debug.get(), 0x300, true);
+        uint64_t idle = run.proc->idleCycles;
+        EXPECT_TRUE(Chip8_execute(run.proc.get(), 1000));
+        EXPECT_EQ(run.proc->idleCycles, idle);
+        Chip8Debug_setBreak(run.debug.get(), 0x300, false);
+        EXPECT_TRUE(Chip8_execute(run.proc.get(), 1000));
+        EXPECT_GT(run.proc->idleCycles, idle);
+    }
+    for (uint32_t seed = 0; seed < 50; ++seed) {
+        std::vector<uint8_t> program = randomProgram(seed, 256);
+        Debugged run(program);
+        // Armed and disarmed again before it starts
+        Chip8Debug_setWatch(run.debug.get(), 0x200, 256, CHIP8_WATCH_WRITE,
+                true);
+        Chip8Debug_setWatch(run.debug.get(), 0x200, 256, CHIP8_WATCH_WRITE,
+                false);
+        auto plain = newProc(program, false);
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            unsigned ipf = 1 + keys % 40;
+            bool running = runFrame(plain.get(), frame, ipf, keys);
+            EXPECT_EQ(runFrame(run.proc.get(), frame, ipf, keys), running);
+            ASSERT_TRUE(sameState(*plain, *run.proc))
+                << "seed " << seed << ", frame " << frame;
+            if (!running) {
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * The console's "c" stops after the frames it is given, or a minute of
+ * them, on a program that never stops by itself
+ */
+TEST(Chip8Debug, ConsoleContinueStops) {
+    Debugged run({ 0x70, 0x01, 0x12, 0x00 });
+    char script[] = "c 10\nc\nq\n";
+    FILE *in = fmemopen(script, sizeof(script) - 1, "r");
+    char *output = nullptr;
+    size_t size = 0;
+    FILE *out = open_memstream(&output, &size);
+    ASSERT_NE(in, nullptr);
+    ASSERT_NE(out, nullptr);
+    Chip8Console_run(run.proc.get(), 8, in, out);
+    fclose(in);
+    fclose(out);
+    std::string text(output, size);
+    free(output);
+    EXPECT_NE(text.find("80 instructions, 10 frames"), std::string::npos)
+        << text;
+    EXPECT_NE(text.find("28800 instructions, 3600 frames"),
+            std::string::npos) << text;
+    EXPECT_EQ(run.proc->cycles, 80u + 28800u);
+}
@@ -0,0 +1,74 @@
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Jit.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+// Idle loops of every kind Chip8_skipIdle recognises
+const std::vector<std::vector<uint8_t>> loops = {
+    {
+        0x60, 0x03,  // 200: V0 = 3
+        0xF0, 0x15,  // 202: D = V0
+        0xF1, 0x07,  // 204: V1 = D
+        0x31, 0x00,  // 206: skip if V1 == 0
+        0x12, 0x04,  // 208: jump 204
+        0x70, 0x01,  // 20A: V0 += 1
+        0x12, 0x02   // 20C: jump 202
+    },
+    {
+        0x62, 0x05,  // 200: V2 = 5
+        0xE2, 0x9E,  // 202: skip if key 5 is held
+        0x12, 0x02,  // 204: jump 202
+        0x73, 0x01,  // 206: V3 += 1
+        0xE2, 0xA1,  // 208: skip if key 5 is not held
+        0x12, 0x08,  // 20A: jump 208
+        0x12, 0x02   // 20C: jump 202
+    },
+    {
+        0x74, 0x01,  // 200: V4 += 1
+        0x12, 0x02   // 202: jump 202
+    }
+};
+
+}
+
+/*
+ * Skipping idle loops must leave the processor after every frame exactly
+ * as running them through the reference interpreter does, in the threaded
+ * interpreter and translated code alike
+ */
+TEST(Chip8Idle, MatchesReferenceWhileSkipping) {
+    for (size_t l = 0; l < loops.size(); ++l) {
+        for (int jit = 0; jit < 2; ++jit) {
+            auto reference = newProc(loops[l], false);
+            auto skipping = newProc(loops[l], false);
+            reference->referenceMode = true;
+            if (jit && !Chip8Jit_enable(skipping.get())) {
+                continue;
+            }
+            uint32_t state = l + 1;
+            for (unsigned frame = 0; frame < FRAMES; ++frame) {
+                // Hold key 5 for 5 frames out of every 10
+                if (frame % 5 == 0) {
+                    for (Chip8Proc *p : { reference.get(), skipping.get() }) {
+                        Chip8_keyEvent(p, 5, frame / 5 & 1);
+                    }
+                }
+                unsigned ipf = 1 + nextRandom(&state) % 1000;
+                Chip8_execute(reference.get(), ipf);
+                Chip8_execute(skipping.get(), ipf);
+                Chip8_tick(reference.get());
+                Chip8_tick(skipping.get());
+                ASSERT_TRUE(sameState(*reference, *skipping))
+                    << "loop " << l << ", jit " << jit << ", frame " << frame;
+            }
+            EXPECT_GT(skipping->idleCycles, skipping->cycles / 2)
+                << "loop " << l << ", jit " << jit;
+            Chip8Jit_disable(skipping.get());
+        }
+    }
+}
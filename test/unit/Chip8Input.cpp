@@ -0,0 +1,131 @@
+#include <thread>
+#include <unistd.h>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Input.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+// Key and state of the nth event a producer pushes: each key is pressed in
+// turn, then each is released
+uint8_t keyOf(uint32_t n) {
+    return n % 16;
+}
+
+bool pressedOf(uint32_t n) {
+    return n / 16 % 2 == 0;
+}
+
+/*
+ * The key bits that events [0, count) leave held
+ */
+uint16_t keysAfter(uint32_t count) {
+    uint16_t keys = 0;
+    for (uint32_t n = 0; n < count; ++n) {
+        if (pressedOf(n)) {
+            keys |= 1 << keyOf(n);
+        } else {
+            keys &= ~(1 << keyOf(n));
+        }
+    }
+    return keys;
+}
+
+}
+
+/*
+ * A full queue refuses and counts events, and delivering frees their
+ * slots for events that wrap around the ring
+ */
+TEST(Chip8Input, DropsEventsWhenFull) {
+    std::unique_ptr<Chip8Input> input(new Chip8Input);
+    Chip8Input_init(input.get());
+    auto proc = newProc({ 0x12, 0x00 }, false);
+    uint32_t pushed = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < CHIP8_INPUT_QUEUE_SIZE; ++i, ++pushed) {
+            ASSERT_TRUE(Chip8Input_push(input.get(), keyOf(pushed),
+                        pressedOf(pushed)));
+        }
+        EXPECT_FALSE(Chip8Input_push(input.get(), 0, true));
+        EXPECT_EQ(input->dropped, round + 1u);
+        // Each key is pressed and released in a delivery, so the releases
+        // wait for the next one
+        EXPECT_EQ(Chip8Input_deliver(input.get(), proc.get()), 16);
+        EXPECT_EQ(Chip8Input_deliver(input.get(), proc.get()), 32);
+        EXPECT_EQ(Chip8Input_deliver(input.get(), proc.get()), 16);
+        EXPECT_EQ(Chip8Input_deliver(input.get(), proc.get()), 0);
+        EXPECT_EQ(proc->keys, keysAfter(pushed));
+    }
+    EXPECT_EQ(input->delivered, pushed);
+}
+
+/*
+ * Events pushed from another thread arrive in order, through many trips
+ * around the ring, wake a consumer asleep in Chip8Input_wait, and are
+ * accounted for in the latency statistics
+ */
+TEST(Chip8Input, DeliversAcrossThreadsInOrder) {
+    constexpr uint32_t EVENTS = 20000;
+    std::unique_ptr<Chip8Input> input(new Chip8Input);
+    Chip8Input_init(input.get());
+    auto proc = newProc({ 0x12, 0x00 }, false);
+
+    uint64_t start = Chip8Input_now();
+    uint64_t refused = 0;
+    std::thread producer([&] {
+        for (uint32_t n = 0; n < EVENTS; ) {
+            if (Chip8Input_push(input.get(), keyOf(n), pressedOf(n))) {
+                ++n;
+            } else {
+                ++refused;
+                std::this_thread::yield();
+            }
+            // Pause now and then, so the consumer goes to sleep
+            if (n % 1000 == 999) {
+                usleep(2000);
+            }
+        }
+    });
+
+    uint32_t delivered = 0;
+    bool ordered = true, woken = true;
+    while (delivered < EVENTS && ordered && woken) {
+        // The events queued must be the next ones pushed; they are not
+        // overwritten until delivered
+        uint32_t tail = input->tail.load(std::memory_order_relaxed),
+                 head = input->head.load(std::memory_order_acquire);
+        for (uint32_t t = tail; t != head; ++t) {
+            const Chip8KeyEvent &event =
+                input->events[t % CHIP8_INPUT_QUEUE_SIZE];
+            uint32_t n = delivered + (t - tail);
+            ordered &= event.key == keyOf(n) && event.pressed == pressedOf(n)
+                && event.stamp >= start;
+        }
+        int count = Chip8Input_deliver(input.get(), proc.get());
+        delivered += count;
+        ordered &= proc->keys == keysAfter(delivered);
+        if (count == 0) {
+            woken = Chip8Input_wait(input.get(),
+                    Chip8Input_now() + 5000000000ULL);
+        }
+    }
+    producer.join();
+    uint64_t elapsed = Chip8Input_now() - start;
+
+    EXPECT_TRUE(ordered) << "after " << delivered << " events";
+    EXPECT_TRUE(woken) << "asleep after " << delivered << " events";
+    EXPECT_EQ(delivered, EVENTS);
+    EXPECT_EQ(input->delivered, EVENTS);
+    EXPECT_EQ(input->dropped, refused);
+    EXPECT_EQ(input->tail.load(), EVENTS);
+    EXPECT_GT(input->latencyMax, 0u);
+    EXPECT_LE(input->latencyMax, elapsed);
+    EXPECT_LE(input->latencyTotal, input->latencyMax * EVENTS);
+    EXPECT_GE(input->latencyTotal, input->latencyMax);
+}
@@ -0,0 +1,140 @@
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Jit.h"
+}
+
+using namespace chip8test;
+
+/*
+ * Translated code must leave the processor exactly as the reference
+ * interpreter does after every frame, in both quirk modes, whatever slices
+ * of the budget it is run in
+ */
+TEST(Chip8Jit, MatchesReferenceOnRandomPrograms) {
+    for (uint32_t seed = 0; seed < 100; ++seed) {
+        bool superMode = seed & 1;
+        std::vector<uint8_t> program = randomProgram(seed, 256);
+        auto reference = newProc(program, superMode);
+        auto translated = newProc(program, superMode);
+        reference->referenceMode = true;
+        if (!Chip8Jit_enable(translated.get())) {
+            GTEST_SKIP() << "no JIT on this host";
+        }
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            unsigned ipf = 1 + keys % 40;
+            bool running = runFrame(reference.get(), frame, ipf, keys);
+            runFrame(translated.get(), frame, ipf, keys);
+            ASSERT_TRUE(sameState(*reference, *translated))
+                << "seed " << seed << ", frame " << frame;
+            if (!running) {
+                break;
+            }
+        }
+        Chip8Jit_disable(translated.get());
+    }
+}
+
+/*
+ * A program rewriting code that has already been translated must run the
+ * new instruction from then on
+ */
+TEST(Chip8Jit, RunsRewrittenCode) {
+    static const uint8_t code[] = {
+        0x63, 0x00,  // 200: V3 = 0
+        0x73, 0x01,  // 202: V3 += 1, rewritten to V3 += 5
+        0x74, 0x01,  // 204: V4 += 1
+        0x34, 0x10,  // 206: skip if V4 == 16
+        0x12, 0x02,  // 208: jump 202
+        0x35, 0x01,  // 20A: skip if V5 == 1
+        0x12, 0x12,  // 20C: jump 212
+        0x00, 0xFD,  // 20E: exit
+        0x00, 0x00,  // 210
+        0x60, 0x73,  // 212: V0 = 73
+        0x61, 0x05,  // 214: V1 = 05
+        0xA2, 0x02,  // 216: I = 202
+        0xF2, 0x55,  // 218: store V0 and V1 at 202 (Fx55 stops short of Vx)
+        0x64, 0x00,  // 21A: V4 = 0
+        0x65, 0x01,  // 21C: V5 = 1
+        0x12, 0x02   // 21E: jump 202
+    };
+    std::vector<uint8_t> program(code, code + sizeof(code));
+    for (unsigned slice = 1; slice <= 16; slice *= 2) {
+        auto reference = newProc(program, false);
+        auto translated = newProc(program, false);
+        reference->referenceMode = true;
+        if (!Chip8Jit_enable(translated.get())) {
+            GTEST_SKIP() << "no JIT on this host";
+        }
+        while (Chip8_execute(reference.get(), slice)) {
+            Chip8_execute(translated.get(), slice);
+            ASSERT_TRUE(sameState(*reference, *translated))
+                << "slice " << slice;
+        }
+        EXPECT_FALSE(Chip8_execute(translated.get(), slice));
+        EXPECT_TRUE(sameState(*reference, *translated)) << "slice " << slice;
+        EXPECT_EQ(translated->trap, CHIP8_TRAP_EXIT);
+        EXPECT_EQ(translated->V[3], 16 * 1 + 16 * 5);
+        Chip8Jit_disable(translated.get());
+    }
+}
+
+/*
+ * Blocks jumping straight to one another through calls, returns, skips
+ * and Bnnn must stop exactly where the budget runs out, and leave stack
+ * overflows, underflows and jumps out of ram for the interpreter to trap on
+ */
+TEST(Chip8Jit, ChainsBlocksUpToTraps) {
+    std::vector<std::vector<uint8_t>> programs = {
+        {
+            0x70, 0x01,  // 200: V0 += 1
+            0x22, 0x00   // 202: call 200, until the stack overflows
+        },
+        {
+            0x22, 0x06,  // 200: call 206
+            0x71, 0x01,  // 202: V1 += 1
+            0x00, 0xEE,  // 204: return, with the stack empty
+            0x70, 0x01,  // 206: V0 += 1
+            0x30, 0x05,  // 208: skip if V0 == 5
+            0x12, 0x06,  // 20A: jump 206
+            0x00, 0xEE   // 20C: return
+        },
+        {
+            0x70, 0x02,  // 200: V0 += 2
+            0x40, 0x10,  // 202: skip if V0 != 16
+            0xBF, 0xFF,  // 204: jump past the end of ram
+            0xB2, 0x0A,  // 206: jump 20A + V0
+            0x00, 0x00,  // 208
+            0x00, 0x00,  // 20A
+            0x12, 0x00,  // 20C...218: jump 200
+            0x12, 0x00, 0x12, 0x00, 0x12, 0x00, 0x12, 0x00, 0x12, 0x00,
+            0x12, 0x00
+        }
+    };
+    const Chip8Trap traps[] = {
+        CHIP8_TRAP_STACK_OVERFLOW, CHIP8_TRAP_STACK_UNDERFLOW,
+        CHIP8_TRAP_BAD_PC
+    };
+    for (size_t p = 0; p < programs.size(); ++p) {
+        for (unsigned slice = 1; slice <= 64; slice *= 4) {
+            auto reference = newProc(programs[p], false);
+            auto translated = newProc(programs[p], false);
+            reference->referenceMode = true;
+            if (!Chip8Jit_enable(translated.get())) {
+                GTEST_SKIP() << "no JIT on this host";
+            }
+            while (Chip8_execute(reference.get(), slice)) {
+                Chip8_execute(translated.get(), slice);
+                ASSERT_TRUE(sameState(*reference, *translated))
+                    << "program " << p << ", slice " << slice;
+            }
+            EXPECT_FALSE(Chip8_execute(translated.get(), slice));
+            EXPECT_TRUE(sameState(*reference, *translated))
+                << "program " << p << ", slice " << slice;
+            EXPECT_EQ(translated->trap, traps[p]) << "program " << p;
+            Chip8Jit_disable(translated.get());
+        }
+    }
+}
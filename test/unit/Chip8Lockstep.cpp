@@ -0,0 +1,184 @@
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Lockstep.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+/*
+ * count lanes of program, each seeded and holding a key of its own so that
+ * they split apart, grouped in lockstep, and the same processors to run on
+ * their own through Chip8_advance
+ */
+struct Group {
+    std::vector<std::unique_ptr<Chip8Proc>> lanes, references;
+    Chip8Lockstep lockstep;
+
+    Group(const std::vector<uint8_t> &program, bool superMode, int count) {
+        Chip8Proc *procs[CHIP8_LANES];
+        for (int lane = 0; lane < count; ++lane) {
+            lanes.push_back(newProc(program, superMode));
+            references.push_back(newProc(program, superMode));
+            for (Chip8Proc *proc : { lanes[lane].get(),
+                    references[lane].get() }) {
+                Chip8_seed(proc, lane);
+                Chip8_keyEvent(proc, lane & 0xF, true);
+            }
+            references[lane]->referenceMode = true;
+            procs[lane] = lanes[lane].get();
+        }
+        Chip8Lockstep_init(&lockstep, procs, count);
+    }
+
+    /*
+     * Run a frame of ipf instructions in the group and on each reference,
+     * then tick every processor. Returns false once every lane stopped.
+     */
+    bool runFrame(unsigned ipf) {
+        bool running = Chip8Lockstep_execute(&lockstep, ipf);
+        Chip8Lockstep_sync(&lockstep);
+        for (size_t lane = 0; lane < lanes.size(); ++lane) {
+            Chip8_execute(references[lane].get(), ipf);
+            Chip8_tick(lanes[lane].get());
+            Chip8_tick(references[lane].get());
+        }
+        return running;
+    }
+
+    ::testing::AssertionResult same() const {
+        for (size_t lane = 0; lane < lanes.size(); ++lane) {
+            auto result = sameState(*lanes[lane], *references[lane]);
+            if (!result) {
+                return result << " in lane " << lane;
+            }
+        }
+        return ::testing::AssertionSuccess();
+    }
+};
+
+}
+
+/*
+ * Every lane must end each frame exactly as the same processor run on its
+ * own, through convergence, divergence and lanes stopping
+ */
+TEST(Chip8Lockstep, MatchesScalarRunsOnRandomPrograms) {
+    for (uint32_t seed = 0; seed < 100; ++seed) {
+        Group group(randomProgram(seed, 128), seed & 1,
+                1 + seed % CHIP8_LANES);
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            bool running = group.runFrame(1 + nextRandom(&state) % 40);
+            ASSERT_TRUE(group.same()) << "seed " << seed << ", frame "
+                << frame;
+            if (!running) {
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * 8xy4 with y = F adds the old Vf, not the carry written over it
+ */
+TEST(Chip8Lockstep, AddsVfBeforeWritingCarry) {
+    static const uint8_t code[] = {
+        0x6F, 0x10,  // 200: VF = 10
+        0x64, 0x20,  // 202: V4 = 20
+        0x84, 0xF4,  // 204: V4 += VF
+        0x12, 0x06   // 206: jump 206
+    };
+    Group group(std::vector<uint8_t>(code, code + sizeof(code)), false, 4);
+    group.runFrame(3);
+    ASSERT_TRUE(group.same());
+    EXPECT_EQ(group.lanes[0]->V[4], 0x30);
+    EXPECT_EQ(group.lanes[0]->V[0xF], 0);
+}
+
+/*
+ * A lane storing to ram while the lanes are apart must keep running its
+ * own code once they are back together
+ */
+TEST(Chip8Lockstep, RunsEachLanesCodeAfterDivergedStores) {
+    // Lane 0 holds key 0 and lane 1 key 1; both take five steps to 212
+    static const uint8_t code[] = {
+        0xE0, 0x9E,  // 200: skip if key V0 (0) is held
+        0x12, 0x0C,  // 202: jump 20C
+        0x60, 0x61,  // 204: V0 = 61
+        0xA2, 0x14,  // 206: I = 214
+        0xF1, 0x55,  // 208: store V0 at 214 (Fx55 stops short of Vx)
+        0x12, 0x12,  // 20A: jump 212
+        0x62, 0x00,  // 20C: V2 = 0
+        0x62, 0x00,  // 20E: V2 = 0
+        0x12, 0x12,  // 210: jump 212
+        0x61, 0x01,  // 212: V1 = 1, with the lanes together again
+        0x71, 0x05,  // 214: V1 += 5, which is V1 = 5 in lane 0
+        0x12, 0x16   // 216: jump 216
+    };
+    Group group(std::vector<uint8_t>(code, code + sizeof(code)), false, 2);
+    for (int frame = 0; frame < 4; ++frame) {
+        group.runFrame(3);
+        ASSERT_TRUE(group.same()) << "frame " << frame;
+    }
+    EXPECT_EQ(group.lanes[0]->V[1], 5);
+    EXPECT_EQ(group.lanes[1]->V[1], 6);
+}
+
+/*
+ * A store that overwrites its own opcode with values that differ between
+ * the lanes must still stop them sharing opcodes
+ */
+TEST(Chip8Lockstep, RunsEachLanesCodeAfterStoreOverItself) {
+    static const uint8_t code[] = {
+        0xC1, 0xFF,  // 200: V1 = random, different in each lane
+        0x60, 0xA2,  // 202: V0 = A2
+        0xA2, 0x06,  // 204: I = 206
+        0xF2, 0x55,  // 206: store V0 and V1 at 206, becoming A2 V1
+        0x12, 0x06   // 208: jump 206
+    };
+    Group group(std::vector<uint8_t>(code, code + sizeof(code)), false, 4);
+    for (int frame = 0; frame < 4; ++frame) {
+        group.runFrame(5);
+        ASSERT_TRUE(group.same()) << "frame " << frame;
+    }
+    EXPECT_NE(group.lanes[0]->I, group.lanes[1]->I);
+}
+
+/*
+ * Lanes that meet in a subroutine called from different places keep their
+ * own stacks and each returns to its own caller, while calls and returns
+ * made together run on one shared stack, down to overflowing it
+ */
+TEST(Chip8Lockstep, ReturnsEachLaneToItsOwnCaller) {
+    // Lane 0 holds key 0, so it calls the subroutine once from 204 while
+    // the others call it from 202, then again from 204
+    static const uint8_t code[] = {
+        0xE0, 0x9E,  // 200: skip if key V0 (0) is held
+        0x22, 0x0C,  // 202: call 20C
+        0x22, 0x0C,  // 204: call 20C
+        0x71, 0x01,  // 206: V1 += 1
+        0x22, 0x10,  // 208: call 210
+        0x00, 0x00,  // 20A
+        0x72, 0x01,  // 20C: V2 += 1
+        0x00, 0xEE,  // 20E: return
+        0x73, 0x01,  // 210: V3 += 1
+        0x22, 0x10   // 212: call 210, until the stack overflows
+    };
+    for (int count : { 1, 4 }) {
+        Group group(std::vector<uint8_t>(code, code + sizeof(code)), false,
+                count);
+        for (int frame = 0; frame < 8; ++frame) {
+            group.runFrame(7);
+            ASSERT_TRUE(group.same()) << count << " lanes, frame " << frame;
+        }
+        for (int lane = 0; lane < count; ++lane) {
+            EXPECT_EQ(group.lanes[lane]->trap, CHIP8_TRAP_STACK_OVERFLOW);
+            EXPECT_EQ(group.lanes[lane]->V[2], lane == 0 ? 1 : 2);
+            EXPECT_EQ(group.lanes[lane]->V[3], 16);
+        }
+        EXPECT_GT(group.lockstep.vectorSteps, 0u);
+    }
+}
@@ -0,0 +1,65 @@
+#include <set>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Pool.h"
+}
+
+using namespace chip8test;
+
+/*
+ * Every processor handed out, new or reused, must be byte for byte the
+ * processor Chip8_initAt creates for the program, and on a cache line of
+ * its own
+ */
+TEST(Chip8Pool, AcquiresProcessorsAsInit) {
+    Chip8Pool pool;
+    Chip8Pool_init(&pool, 4, NULL, NULL, true);
+    Chip8_seed(&pool.fresh, 9);
+    std::vector<Chip8Proc *> held;
+    for (uint32_t seed = 0; seed < 30; ++seed) {
+        std::vector<uint8_t> program = randomProgram(seed, 64 + 16 * seed);
+        Chip8Proc *proc = Chip8Pool_acquire(&pool, program.data(),
+                program.size());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(proc) % 64, 0u);
+        auto expected = newProc(program, true);
+        Chip8_seed(expected.get(), 9);
+        EXPECT_EQ(std::memcmp(proc, expected.get(), sizeof(Chip8Proc)), 0)
+            << "seed " << seed;
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < 50; ++frame) {
+            uint32_t keys = nextRandom(&state);
+            if (!runFrame(proc, frame, 1 + keys % 40, keys)) {
+                break;
+            }
+        }
+        // Keep every third processor, so the pool both reuses and carves
+        if (seed % 3 == 0) {
+            held.push_back(proc);
+        } else {
+            Chip8Pool_release(&pool, proc);
+        }
+    }
+    std::set<Chip8Proc *> distinct(held.begin(), held.end());
+    EXPECT_EQ(distinct.size(), held.size());
+    Chip8Pool_free(&pool);
+}
+
+/*
+ * The processor released most recently is the next one handed out
+ */
+TEST(Chip8Pool, ReusesLastReleased) {
+    Chip8Pool pool;
+    Chip8Pool_init(&pool, 0, NULL, NULL, false);
+    std::vector<uint8_t> program = randomProgram(5, 128);
+    Chip8Proc *a = Chip8Pool_acquire(&pool, program.data(), program.size());
+    Chip8Proc *b = Chip8Pool_acquire(&pool, program.data(), program.size());
+    EXPECT_NE(a, b);
+    Chip8Pool_release(&pool, a);
+    Chip8Pool_release(&pool, b);
+    EXPECT_EQ(Chip8Pool_acquire(&pool, program.data(), program.size()), b);
+    EXPECT_EQ(Chip8Pool_acquire(&pool, program.data(), program.size()), a);
+    EXPECT_EQ(pool.capacity, size_t(CHIP8_POOL_DEFAULT_SLAB));
+    Chip8Pool_free(&pool);
+}
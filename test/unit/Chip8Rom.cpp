@@ -0,0 +1,88 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Rom.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+void writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr) << path;
+    ASSERT_EQ(std::fwrite(data.data(), 1, data.size(), file), data.size());
+    std::fclose(file);
+}
+
+}
+
+/*
+ * Packing a directory of ROMs and loading the archive must give back the
+ * same names and contents, in the same order
+ */
+TEST(Chip8Rom, RoundTripsThroughPackedArchive) {
+    char dir[] = "/tmp/chip8_rom_testXXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    std::string roms = std::string(dir) + "/roms";
+    std::string archive = std::string(dir) + "/corpus.pak";
+    ASSERT_EQ(mkdir(roms.c_str(), 0700), 0);
+    std::vector<std::string> files;
+    for (uint32_t seed = 0; seed < 12; ++seed) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/rom%02u.ch8", seed);
+        files.push_back(roms + name);
+        // From an empty file up to 242 bytes
+        writeFile(files.back(), randomProgram(seed, 2 * seed * seed));
+    }
+
+    Chip8RomSet original;
+    Chip8RomSet_init(&original);
+    ASSERT_TRUE(Chip8RomSet_add(&original, roms.c_str()));
+    ASSERT_EQ(original.count, files.size());
+    ASSERT_TRUE(Chip8RomSet_pack(&original, archive.c_str()));
+
+    Chip8RomSet packed;
+    Chip8RomSet_init(&packed);
+    ASSERT_TRUE(Chip8RomSet_add(&packed, archive.c_str()));
+    ASSERT_EQ(packed.count, original.count);
+    for (size_t r = 0; r < packed.count; ++r) {
+        const Chip8Rom &a = original.roms[r], &b = packed.roms[r];
+        EXPECT_STREQ(a.name, b.name);
+        ASSERT_EQ(a.size, b.size) << a.name;
+        EXPECT_TRUE(a.size == 0 || std::memcmp(a.data, b.data, a.size) == 0)
+            << a.name;
+    }
+
+    // An archive cut short is refused
+    FILE *file = std::fopen(archive.c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    std::vector<uint8_t> bytes(1 << 16);
+    bytes.resize(std::fread(bytes.data(), 1, bytes.size(), file));
+    std::fclose(file);
+    bytes.resize(bytes.size() - 1);
+    writeFile(archive, bytes);
+    Chip8RomSet truncated;
+    Chip8RomSet_init(&truncated);
+    errno = 0;
+    EXPECT_FALSE(Chip8RomSet_add(&truncated, archive.c_str()));
+    EXPECT_EQ(errno, EINVAL);
+
+    Chip8RomSet_free(&truncated);
+    Chip8RomSet_free(&packed);
+    Chip8RomSet_free(&original);
+    for (const std::string &path : files) {
+        std::remove(path.c_str());
+    }
+    std::remove(archive.c_str());
+    rmdir(roms.c_str());
+    rmdir(dir);
+}
@@ -0,0 +1,123 @@
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8State.h"
+}
+
+using namespace chip8test;
+
+/*
+ * Loading a saved state and running on must match running on from where
+ * the state was saved
+ */
+TEST(Chip8State, RoundTripsThroughSaveAndLoad) {
+    for (uint32_t seed = 0; seed < 50; ++seed) {
+        std::vector<uint8_t> program = randomProgram(seed, 256);
+        auto proc = newProc(program, seed & 1);
+        auto restored = newProc(program, seed & 1);
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            Chip8State saved;
+            Chip8_saveState(proc.get(), &saved);
+            uint32_t keys = nextRandom(&state);
+            unsigned ipf = 1 + keys % 40;
+            // Run the frame elsewhere first, so that restored has code to drop
+            runFrame(restored.get(), frame, ipf, keys);
+            ASSERT_TRUE(Chip8_loadState(restored.get(), &saved));
+            ASSERT_TRUE(sameState(*proc, *restored));
+            bool running = runFrame(proc.get(), frame, ipf, keys);
+            runFrame(restored.get(), frame, ipf, keys);
+            ASSERT_TRUE(sameState(*proc, *restored))
+                << "seed " << seed << ", frame " << frame;
+            if (!running) {
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * Popping the history must give back every frame pushed, newest first,
+ * across keyframes and deltas
+ */
+TEST(Chip8State, RewindsEveryFramePushed) {
+    std::vector<uint8_t> program = randomProgram(7, 256);
+    auto proc = newProc(program, false);
+    std::vector<std::unique_ptr<Chip8Proc>> frames;
+    Chip8Rewind history;
+    ASSERT_TRUE(Chip8Rewind_init(&history, 1 << 20, 8));
+    uint32_t state = 1;
+    for (unsigned frame = 0; frame < 50; ++frame) {
+        Chip8Rewind_push(&history, proc.get());
+        frames.emplace_back(new Chip8Proc(*proc));
+        uint32_t keys = nextRandom(&state);
+        runFrame(proc.get(), frame, 1 + keys % 40, keys);
+    }
+    while (!frames.empty()) {
+        ASSERT_TRUE(Chip8Rewind_pop(&history, proc.get()));
+        ASSERT_TRUE(sameState(*frames.back(), *proc))
+            << "frame " << frames.size() - 1;
+        frames.pop_back();
+    }
+    EXPECT_FALSE(Chip8Rewind_pop(&history, proc.get()));
+    Chip8Rewind_free(&history);
+}
+
+/*
+ * A history too small for every frame keeps the newest ones
+ */
+TEST(Chip8State, DropsOldestFramesOverBudget) {
+    std::vector<uint8_t> program = randomProgram(3, 256);
+    auto proc = newProc(program, false);
+    Chip8Rewind history;
+    ASSERT_TRUE(Chip8Rewind_init(&history, 4 * sizeof(Chip8State), 2));
+    for (unsigned frame = 0; frame < 100; ++frame) {
+        Chip8Rewind_push(&history, proc.get());
+        runFrame(proc.get(), frame, 10, 0);
+    }
+    EXPECT_GT(history.frames, 0u);
+    EXPECT_LT(history.frames, 100u);
+    Chip8Proc newest(*proc);
+    Chip8Rewind_push(&history, proc.get());
+    runFrame(proc.get(), 100, 10, 0);
+    ASSERT_TRUE(Chip8Rewind_pop(&history, proc.get()));
+    EXPECT_TRUE(sameState(newest, *proc));
+    Chip8Rewind_free(&history);
+}
+
+/*
+ * States no processor can be in are refused, leaving the processor as it
+ * was
+ */
+TEST(Chip8State, RejectsCorruptStates) {
+    std::vector<uint8_t> program = randomProgram(1, 64);
+    auto proc = newProc(program, false);
+    Chip8Proc before(*proc);
+    Chip8State good;
+    Chip8_saveState(proc.get(), &good);
+    const std::vector<void (*)(Chip8State *)> corruptions = {
+        [](Chip8State *s) { s->magic ^= 1; },
+        [](Chip8State *s) { s->version += 1; },
+        [](Chip8State *s) { s->SC = 16; },
+        [](Chip8State *s) { s->SC = -2; },
+        [](Chip8State *s) { s->waitKey = 16; },
+        [](Chip8State *s) { s->waitKey = -2; },
+        [](Chip8State *s) { s->PC = -1; },
+        [](Chip8State *s) { s->PC = 0x2000; },
+        [](Chip8State *s) { s->trap = CHIP8_TRAP_BREAK + 1; },
+        [](Chip8State *s) { s->SC = 0; s->stack[0] = 0xFFF; },
+        [](Chip8State *s) { std::memset(&s->superMode, 2, 1); },
+    };
+    for (size_t c = 0; c < corruptions.size(); ++c) {
+        Chip8State bad = good;
+        corruptions[c](&bad);
+        EXPECT_FALSE(Chip8_loadState(proc.get(), &bad)) << "corruption " << c;
+        EXPECT_TRUE(sameState(before, *proc)) << "corruption " << c;
+    }
+    // Bounds themselves are accepted
+    Chip8State edge = good;
+    edge.SC = 15;
+    edge.waitKey = 15;
+    edge.PC = 0xFFF + 0xFF;
+    EXPECT_TRUE(Chip8_loadState(proc.get(), &edge));
+}
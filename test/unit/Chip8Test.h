@@ -0,0 +1,96 @@
+#ifndef CHIP_8_TEST_H
+#define CHIP_8_TEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "Chip8Core.h"
+#include "Chip8RandomProgram.h"
+#include "Chip8State.h"
+}
+
+/*
+ * Helpers shared by the unit tests: random programs to run, and checks that
+ * two processors agree on everything a program can observe
+ */
+namespace chip8test {
+
+// Frames each differential test runs a program for
+constexpr unsigned FRAMES = 200;
+
+inline uint32_t nextRandom(uint32_t *state) {
+    return Chip8RandomProgram_next(state);
+}
+
+/*
+ * A program of size bytes (even) of the fuzzing harness's instruction mix,
+ * the same for the same seed
+ */
+inline std::vector<uint8_t> randomProgram(uint32_t seed, size_t size) {
+    uint32_t state = seed * 2654435761u + 1;
+    std::vector<uint8_t> program(size);
+    Chip8RandomProgram_fill(program.data(), size, &state);
+    return program;
+}
+
+/*
+ * A processor on the heap, aligned as Chip8Proc requires
+ */
+inline std::unique_ptr<Chip8Proc> newProc(const std::vector<uint8_t> &program,
+        bool superMode) {
+    std::unique_ptr<Chip8Proc> proc(new Chip8Proc);
+    Chip8_initAt(proc.get(), program.data(), program.size(), NULL, NULL,
+            superMode);
+    return proc;
+}
+
+/*
+ * Run one frame as the fuzzing harness does: a key press for a processor
+ * waiting on one, random key changes from keys, ipf instructions and a
+ * timer tick. Returns false once the processor has trapped.
+ */
+inline bool runFrame(Chip8Proc *proc, unsigned frame, unsigned ipf,
+        uint32_t keys) {
+    if (proc->waitKey >= 0) {
+        Chip8_keyEvent(proc, frame & 0xF, true);
+    } else if ((keys >> 28) == 3) {
+        Chip8_keyEvent(proc, keys >> 8 & 0xF, keys >> 12 & 1);
+    }
+    bool running = Chip8_execute(proc, ipf);
+    Chip8_tick(proc);
+    return running;
+}
+
+/*
+ * Success if a and b agree in everything a program can observe
+ * (idleCycles is bookkeeping only)
+ */
+inline ::testing::AssertionResult sameState(const Chip8Proc &a,
+        const Chip8Proc &b) {
+#define FIELD(name) { #name, offsetof(Chip8Proc, name), sizeof(a.name) },
+    static const struct { const char *name; size_t offset, size; } fields[] = {
+        CHIP8_OBSERVABLE_FIELDS(FIELD)
+    };
+#undef FIELD
+    for (const auto &field : fields) {
+        if (std::memcmp(reinterpret_cast<const uint8_t *>(&a) + field.offset,
+                    reinterpret_cast<const uint8_t *>(&b) + field.offset,
+                    field.size) != 0) {
+            return ::testing::AssertionFailure() << field.name
+                << " differs (PC " << std::hex << a.PC << " and " << b.PC
+                << ", cycles " << std::dec << a.cycles << " and "
+                << b.cycles << ")";
+        }
+    }
+    return ::testing::AssertionSuccess();
+}
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "Chip8Test.h"
+
+using namespace chip8test;
+
+/*
+ * Each specialised variant of the threaded interpreter must leave the
+ * processor exactly as the reference interpreter does after every frame,
+ * in both quirk modes and across 00FE/00FF switches between the screens
+ */
+TEST(Chip8Threaded, MatchesReferenceOnRandomPrograms) {
+    bool ranVariant[2][2] = {};
+    for (uint32_t seed = 0; seed < 200; ++seed) {
+        bool superMode = seed & 1;
+        std::vector<uint8_t> program = randomProgram(seed, 256);
+        auto reference = newProc(program, superMode);
+        auto threaded = newProc(program, superMode);
+        reference->referenceMode = true;
+        uint32_t state = seed + 1;
+        for (unsigned frame = 0; frame < FRAMES; ++frame) {
+            ranVariant[threaded->superMode][threaded->largeScreen] = true;
+            uint32_t keys = nextRandom(&state);
+            unsigned ipf = 1 + keys % 40;
+            bool running = runFrame(reference.get(), frame, ipf, keys);
+            runFrame(threaded.get(), frame, ipf, keys);
+            ASSERT_TRUE(sameState(*reference, *threaded))
+                << "seed " << seed << ", frame " << frame;
+            if (!running) {
+                break;
+            }
+        }
+    }
+    for (int s = 0; s < 2; ++s) {
+        for (int l = 0; l < 2; ++l) {
+            EXPECT_TRUE(ranVariant[s][l]) << "superMode " << s
+                << ", largeScreen " << l;
+        }
+    }
+}
+
+/*
+ * Switching screens mid-frame must hand over to the other variant at the
+ * next instruction, with scrolls and sprites drawn at the new size
+ */
+TEST(Chip8Threaded, SwitchesVariantOnScreenChange) {
+    static const uint8_t code[] = {
+        0x00, 0xFF,  // 200: large screen
+        0x60, 0x08,  // 202: V0 = 8
+        0xF0, 0x30,  // 204: I = large digit 8 (V0 still 8)
+        0xD0, 0x00,  // 206: draw 16x16 at (8, 8)
+        0x00, 0xC2,  // 208: scroll down 2
+        0x00, 0xFB,  // 20A: scroll right 4
+        0x00, 0xFE,  // 20C: small screen
+        0xA0, 0x00,  // 20E: I = font 0
+        0xD0, 0x05,  // 210: draw 8x5 at (8, 8)
+        0x00, 0xFC,  // 212: scroll left 4
+        0x70, 0x01,  // 214: V0 += 1
+        0x12, 0x00   // 216: jump 200
+    };
+    std::vector<uint8_t> program(code, code + sizeof(code));
+    for (bool superMode : { false, true }) {
+        for (unsigned ipf = 1; ipf <= 13; ++ipf) {
+            auto reference = newProc(program, superMode);
+            auto threaded = newProc(program, superMode);
+            reference->referenceMode = true;
+            for (unsigned frame = 0; frame < 60; ++frame) {
+                bool running = runFrame(reference.get(), frame, ipf, 0);
+                runFrame(threaded.get(), frame, ipf, 0);
+                ASSERT_TRUE(sameState(*reference, *threaded))
+                    << "superMode " << superMode << ", ipf " << ipf
+                    << ", frame " << frame;
+                if (!running) {
+                    break;
+                }
+            }
+        }
+    }
+}
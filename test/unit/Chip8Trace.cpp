@@ -0,0 +1,81 @@
+#include <cstdio>
+
+#include "Chip8Test.h"
+
+extern "C" {
+#include "Chip8Trace.h"
+}
+
+using namespace chip8test;
+
+namespace {
+
+/*
+ * Record count frames of program, with random key events, into a trace at
+ * path, returning the processor as the run left it
+ */
+std::unique_ptr<Chip8Proc> record(const char *path,
+        const std::vector<uint8_t> &program, uint32_t seed, uint32_t period) {
+    auto proc = newProc(program, seed & 1);
+    Chip8_seed(proc.get(), seed);
+    std::unique_ptr<Chip8Trace> trace(new Chip8Trace);
+    if (!Chip8Trace_open(trace.get(), path, proc.get(), program.data(),
+                program.size(), period)) {
+        return nullptr;
+    }
+    proc->trace = trace.get();
+    uint32_t state = seed + 1;
+    for (unsigned frame = 0; frame < FRAMES; ++frame) {
+        uint32_t keys = nextRandom(&state);
+        if (!runFrame(proc.get(), frame, 1 + keys % 40, keys)) {
+            break;
+        }
+    }
+    bool closed = Chip8Trace_close(trace.get(), proc.get());
+    proc->trace = nullptr;
+    return closed ? std::move(proc) : nullptr;
+}
+
+}
+
+/*
+ * Replaying a trace must end on the same screen and state as the run it
+ * was recorded from, with and without samples
+ */
+TEST(Chip8Trace, ReplaysRecordedRuns) {
+    const char *path = "chip8_trace_test.trc";
+    for (uint32_t seed = 0; seed < 40; ++seed) {
+        std::vector<uint8_t> program = randomProgram(seed, 256);
+        uint32_t period = seed % 3 == 0 ? 0 : 1 + seed * 7;
+        auto recorded = record(path, program, seed, period);
+        ASSERT_NE(recorded, nullptr) << "seed " << seed;
+
+        Chip8TraceReader reader;
+        ASSERT_TRUE(Chip8TraceReader_open(&reader, path));
+        auto replayed = newProc(program, reader.superMode);
+        EXPECT_EQ(Chip8Trace_replay(&reader, replayed.get(), program.data(),
+                    program.size()), CHIP8_REPLAY_DONE) << "seed " << seed;
+        Chip8TraceReader_close(&reader);
+        EXPECT_EQ(std::memcmp(recorded->screen, replayed->screen,
+                    sizeof(recorded->screen)), 0) << "seed " << seed;
+        EXPECT_TRUE(sameState(*recorded, *replayed)) << "seed " << seed;
+    }
+    std::remove(path);
+}
+
+/*
+ * A trace replayed against a different program is refused
+ */
+TEST(Chip8Trace, RefusesOtherPrograms) {
+    const char *path = "chip8_trace_test.trc";
+    std::vector<uint8_t> program = randomProgram(1, 256);
+    ASSERT_NE(record(path, program, 1, 0), nullptr);
+    std::vector<uint8_t> other = randomProgram(2, 256);
+    Chip8TraceReader reader;
+    ASSERT_TRUE(Chip8TraceReader_open(&reader, path));
+    auto replayed = newProc(other, reader.superMode);
+    EXPECT_EQ(Chip8Trace_replay(&reader, replayed.get(), other.data(),
+                other.size()), CHIP8_REPLAY_MISMATCH);
+    Chip8TraceReader_close(&reader);
+    std::remove(path);
+}
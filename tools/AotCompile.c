@@ -0,0 +1,516 @@
+#define _POSIX_C_SOURCE 200809L // open_memstream
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Chip8Rom.h"
+
+#define PROG_START 0x200
+
+/*
+ * How an instruction is translated
+ */
+typedef enum Kind {
+    KIND_NONE,      // Left to Chip8_advance: 00FD, invalid, outside the ROM
+    KIND_NATIVE,    // Inline C
+    KIND_HELPER,    // Chip8Aot_helper, then on to the next instruction
+    KIND_JUMP,      // 1nnn
+    KIND_CALL,      // 2nnn
+    KIND_RET,       // 00EE
+    KIND_SKIP,      // 3xnn, 4xnn, 5xy0, 9xy0, Ex9E, ExA1
+    KIND_COMPUTED   // Bnnn
+} Kind;
+
+/*
+ * The ROM as loaded into ram, and what the walk found in it
+ */
+typedef struct Translation {
+    uint8_t ram[4096];
+    bool superMode;
+    // Instructions reachable from PROG_START, and those starting a block
+    bool reached[4096], leader[4096];
+    // Set once a block jumps through the dispatch switch
+    bool dispatched;
+} Translation;
+
+int translate(const Chip8Rom *rom, bool superMode, const char *name,
+        FILE *out);
+void walk(Translation *t);
+void emitBlock(Translation *t, uint16_t start, FILE *out);
+bool emitInstruction(Translation *t, uint16_t pc, unsigned *pending,
+        FILE *out);
+void emitTransfer(const Translation *t, uint16_t target, const char *indent,
+        FILE *out);
+void emitFlush(unsigned *pending, FILE *out);
+Kind classify(const Translation *t, uint16_t pc);
+uint16_t fetch(const Translation *t, uint16_t pc);
+void emitString(const char *text, FILE *out);
+
+int main(int argc, char **argv) {
+    // AotCompile [-s] <rom> <output.c>
+    bool superMode = false;
+    int option;
+    while ((option = getopt(argc, argv, "s")) != -1) {
+        if (option != 's') {
+            optind = argc;
+            break;
+        }
+        superMode = true;
+    }
+    if (argc - optind != 2) {
+        fprintf(stderr, "Usage: %s [-s] <rom> <output.c>\n"
+                "Translates a ROM to C for linking into the emulator\n"
+                "  -s   translate for SUPER-CHIP mode\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *romPath = argv[optind], *outPath = argv[optind + 1];
+
+    Chip8RomSet set;
+    Chip8RomSet_init(&set);
+    if (!Chip8RomSet_add(&set, romPath)) {
+        perror(romPath);
+        return EXIT_FAILURE;
+    }
+    if (set.count != 1 || !Chip8Rom_valid(&set.roms[0])) {
+        fprintf(stderr, "%s: not a single ROM of 1 to %d bytes\n", romPath,
+                CHIP8_MAX_ROM_SIZE);
+        Chip8RomSet_free(&set);
+        return EXIT_FAILURE;
+    }
+    // The module is named after the file, without directory or extension
+    const char *slash = strrchr(romPath, '/');
+    char *name = strdup(slash != NULL ? slash + 1 : romPath);
+    char *dot = strrchr(name, '.');
+    if (dot != NULL && dot != name) {
+        *dot = '\0';
+    }
+
+    FILE *out = fopen(outPath, "w");
+    int status = EXIT_FAILURE;
+    if (out == NULL) {
+        perror(outPath);
+    } else {
+        status = translate(&set.roms[0], superMode, name, out);
+        if (fclose(out) != 0 || status != EXIT_SUCCESS) {
+            perror(outPath);
+            remove(outPath);
+            status = EXIT_FAILURE;
+        }
+    }
+    free(name);
+    Chip8RomSet_free(&set);
+    return status;
+}
+
+/*
+ * Write the C module for rom to out
+ */
+int translate(const Chip8Rom *rom, bool superMode, const char *name,
+        FILE *out) {
+    static Translation t;
+    memset(&t, 0, sizeof(t));
+    memcpy(t.ram + PROG_START, rom->data, rom->size);
+    t.superMode = superMode;
+    walk(&t);
+
+    // Blocks go to a buffer first, to know whether the dispatch switch is
+    // jumped back to
+    char *body;
+    size_t bodySize;
+    FILE *blocks = open_memstream(&body, &bodySize);
+    if (blocks == NULL) {
+        return EXIT_FAILURE;
+    }
+    unsigned count = 0;
+    for (int a = PROG_START; a < 4096; ++a) {
+        if (t.leader[a]) {
+            emitBlock(&t, a, blocks);
+            ++count;
+        }
+    }
+    fclose(blocks);
+
+    fprintf(out, "/* Generated by AotCompile from ");
+    emitString(name, out);
+    fprintf(out, " (%s, %u blocks); do not edit */\n"
+            "#include \"Chip8Aot.h\"\n\n",
+            superMode ? "SUPER-CHIP" : "CHIP-8", count);
+    fprintf(out, "static void run(Chip8Proc *self, uint64_t end);\n\n");
+    fprintf(out, "static const uint8_t program[%zu] = {", rom->size);
+    for (size_t i = 0; i < rom->size; ++i) {
+        fprintf(out, "%s0x%02X,", i % 12 == 0 ? "\n    " : " ", rom->data[i]);
+    }
+    fprintf(out, "\n};\n\nstatic const uint8_t covered[512] = {");
+    for (int i = 0; i < 512; ++i) {
+        uint8_t bits = 0;
+        for (int b = 0; b < 8; ++b) {
+            int a = 8 * i + b;
+            bits |= (t.reached[a] || (a > 0 && t.reached[a - 1])) << b;
+        }
+        fprintf(out, "%s0x%02X,", i % 12 == 0 ? "\n    " : " ", bits);
+    }
+    fprintf(out, "\n};\n\nstatic Chip8AotModule module = {\n    .name = ");
+    emitString(name, out);
+    fprintf(out, ",\n"
+            "    .program = program,\n"
+            "    .size = sizeof(program),\n"
+            "    .superMode = %s,\n"
+            "    .covered = covered,\n"
+            "    .run = run\n"
+            "};\n\n"
+            "__attribute__((constructor)) static void registerModule(void) {\n"
+            "    Chip8Aot_register(&module);\n"
+            "}\n\n", superMode ? "true" : "false");
+
+    fprintf(out, "static void run(Chip8Proc *self, uint64_t end) {\n");
+    if (strstr(body, "V[") != NULL) {
+        fprintf(out, "    uint8_t *V = self->V;\n");
+    }
+    if (count == 0) {
+        fprintf(out, "    (void) end;\n");
+    }
+    if (t.dispatched) {
+        fprintf(out, "dispatch:\n");
+    }
+    fprintf(out, "    switch (self->PC) {\n");
+    for (int a = PROG_START; a < 4096; ++a) {
+        if (t.leader[a]) {
+            fprintf(out, "        case 0x%03X: goto L%03X;\n", a, a);
+        }
+    }
+    fprintf(out, "        default: return;\n    }\n");
+    fwrite(body, 1, bodySize, out);
+    fprintf(out, "}\n");
+    free(body);
+    return ferror(out) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Follow every path from PROG_START, marking the instructions reached and
+ * the blocks they fall into. A block starts at the entry point, the
+ * target of a jump or call, the return address of a call, either side of
+ * a skip, and after an instruction run by the interpreter.
+ */
+void walk(Translation *t) {
+    // Each instruction reached queues at most two others
+    static uint16_t pending[2 * 4096 + 1];
+    int count = 0;
+    if (classify(t, PROG_START) != KIND_NONE) {
+        t->leader[PROG_START] = true;
+        pending[count++] = PROG_START;
+    }
+    while (count > 0) {
+        uint16_t pc = pending[--count];
+        if (t->reached[pc]) {
+            continue;
+        }
+        t->reached[pc] = true;
+        uint16_t nnn = fetch(t, pc) & 0xFFF,
+                 next[2] = { pc + 2, pc + 2 };
+        int successors = 1;
+        bool branch = false;
+        switch (classify(t, pc)) {
+            case KIND_NONE: case KIND_RET: case KIND_COMPUTED:
+                successors = 0;
+                break;
+            case KIND_NATIVE:
+                break;
+            case KIND_HELPER:
+                // So that code resumed after a wait for a key is translated
+                branch = true;
+                break;
+            case KIND_JUMP:
+                next[0] = nnn;
+                branch = true;
+                break;
+            case KIND_CALL:
+                next[1] = nnn;
+                successors = 2;
+                branch = true;
+                break;
+            case KIND_SKIP:
+                next[1] = pc + 4;
+                successors = 2;
+                branch = true;
+                break;
+        }
+        for (int s = 0; s < successors; ++s) {
+            if (classify(t, next[s]) == KIND_NONE) {
+                continue;
+            }
+            if (branch) {
+                t->leader[next[s]] = true;
+            }
+            if (!t->reached[next[s]]) {
+                pending[count++] = next[s];
+            }
+        }
+    }
+}
+
+/*
+ * Emit the block starting at start: its instructions up to a branch or
+ * the start of another block
+ */
+void emitBlock(Translation *t, uint16_t start, FILE *out) {
+    unsigned length = 0;
+    for (uint16_t pc = start; ; pc += 2) {
+        ++length;
+        Kind kind = classify(t, pc);
+        if (kind != KIND_NATIVE && kind != KIND_HELPER) {
+            break;
+        }
+        if (t->leader[pc + 2] || classify(t, pc + 2) == KIND_NONE) {
+            break;
+        }
+    }
+    fprintf(out, "L%03X:\n"
+            "    if (self->cycles + %u > end) { self->PC = 0x%03X; return; }\n",
+            start, length, start);
+    // Instructions retired since cycles was last brought up to date
+    unsigned pending = 0;
+    for (uint16_t pc = start; emitInstruction(t, pc, &pending, out); pc += 2) {
+        if (t->leader[pc + 2] || classify(t, pc + 2) == KIND_NONE) {
+            emitFlush(&pending, out);
+            emitTransfer(t, pc + 2, "    ", out);
+            break;
+        }
+    }
+}
+
+/*
+ * Emit the instruction at pc.
+ * Returns true if the block carries on to the next instruction.
+ */
+bool emitInstruction(Translation *t, uint16_t pc, unsigned *pending,
+        FILE *out) {
+    uint16_t op = fetch(t, pc), nnn = op & 0xFFF;
+    uint8_t x = op >> 8 & 0xF, y = op >> 4 & 0xF, nn = op & 0xFF;
+    char condition[64];
+
+    switch (classify(t, pc)) {
+        case KIND_NONE:
+            break;
+        case KIND_HELPER:
+            emitFlush(pending, out);
+            fprintf(out, "    if (!Chip8Aot_helper(self, 0x%03X)) { return; }\n",
+                    pc);
+            return true;
+        case KIND_JUMP:
+            ++*pending;
+            emitFlush(pending, out);
+            if (nnn <= pc) {
+                // Backward: possibly an idle loop
+                fprintf(out, "    self->PC = 0x%03X;\n"
+                        "    if (Chip8_skipIdle(self, end - self->cycles)) {\n"
+                        "        self->cycles = end;\n"
+                        "        return;\n"
+                        "    }\n", nnn);
+            }
+            emitTransfer(t, nnn, "    ", out);
+            return false;
+        case KIND_CALL:
+            // Chip8_advance traps on a full stack
+            emitFlush(pending, out);
+            fprintf(out, "    if (self->SC >= 15) { self->PC = 0x%03X; return; }\n"
+                    "    self->stack[++self->SC] = 0x%03X;\n"
+                    "    self->cycles += 1;\n", pc, pc);
+            emitTransfer(t, nnn, "    ", out);
+            return false;
+        case KIND_RET:
+            // ... and on an empty one
+            emitFlush(pending, out);
+            fprintf(out, "    if (self->SC < 0) { self->PC = 0x%03X; return; }\n"
+                    "    self->PC = self->stack[self->SC--] + 2;\n"
+                    "    self->cycles += 1;\n"
+                    "    goto dispatch;\n", pc);
+            t->dispatched = true;
+            return false;
+        case KIND_COMPUTED:
+            ++*pending;
+            emitFlush(pending, out);
+            fprintf(out, "    self->PC = 0x%03X + V[0];\n"
+                    "    goto dispatch;\n", nnn);
+            t->dispatched = true;
+            return false;
+        case KIND_SKIP:
+            switch (op >> 12) {
+                case 0x3: case 0x4:
+                    snprintf(condition, sizeof(condition), "V[%d] %s 0x%02X",
+                            x, op >> 12 == 0x3 ? "==" : "!=", nn);
+                    break;
+                case 0x5: case 0x9:
+                    if (x == y) {
+                        // Settled now, and compilers warn about the test
+                        snprintf(condition, sizeof(condition), "%d",
+                                op >> 12 == 0x5);
+                    } else {
+                        snprintf(condition, sizeof(condition), "V[%d] %s V[%d]",
+                                x, op >> 12 == 0x5 ? "==" : "!=", y);
+                    }
+                    break;
+                default: // Ex9E, ExA1
+                    snprintf(condition, sizeof(condition),
+                            "%s(self->keys >> (V[%d] & 0xF) & 1)",
+                            nn == 0x9E ? "" : "!", x);
+                    break;
+            }
+            ++*pending;
+            emitFlush(pending, out);
+            fprintf(out, "    if (%s) {\n", condition);
+            emitTransfer(t, pc + 4, "        ", out);
+            fprintf(out, "    }\n");
+            emitTransfer(t, pc + 2, "    ", out);
+            return false;
+        case KIND_NATIVE:
+            ++*pending;
+            switch (op >> 12) {
+                case 0x6: fprintf(out, "    V[%d] = 0x%02X;\n", x, nn); break;
+                case 0x7: fprintf(out, "    V[%d] += 0x%02X;\n", x, nn); break;
+                case 0xA: fprintf(out, "    self->I = 0x%03X;\n", nnn); break;
+                case 0x8:
+                    switch (op & 0xF) {
+                        case 0x0:
+                            fprintf(out, "    V[%d] = V[%d];\n", x, y);
+                            break;
+                        case 0x1: case 0x2: case 0x3:
+                            fprintf(out, "    V[%d] %c= V[%d];\n", x,
+                                    "|&^"[(op & 0xF) - 1], y);
+                            break;
+                        case 0x4:
+                            fprintf(out, "    { int sum = V[%d] + V[%d]; "
+                                    "V[15] = sum >= 255; V[%d] = sum; }\n",
+                                    x, y, x);
+                            break;
+                        case 0x5:
+                            fprintf(out, "    { int old = V[%d]; V[%d] -= V[%d]; "
+                                    "V[15] = old >= V[%d]; }\n", x, x, y, x);
+                            break;
+                        case 0x7:
+                            fprintf(out, "    { int old = V[%d]; "
+                                    "V[%d] = V[%d] - V[%d]; "
+                                    "V[15] = old >= V[%d]; }\n", y, x, y, x, x);
+                            break;
+                        case 0x6: case 0xE: {
+                            // The quirk setting picks the source register
+                            int source = t->superMode ? x : y;
+                            bool right = (op & 0xF) == 0x6;
+                            fprintf(out, "    V[15] = V[%d] & 0x%02X; "
+                                    "V[%d] = V[%d] %s 1;\n", source,
+                                    right ? 0x01 : 0x80, x, source,
+                                    right ? ">>" : "<<");
+                            break;
+                        }
+                    }
+                    break;
+                case 0xF:
+                    switch (nn) {
+                        case 0x07: fprintf(out, "    V[%d] = self->D;\n", x); break;
+                        case 0x15: fprintf(out, "    self->D = V[%d];\n", x); break;
+                        case 0x1E: fprintf(out, "    self->I += V[%d];\n", x); break;
+                    }
+                    break;
+            }
+            return true;
+    }
+    // Not translated: leave it to Chip8_advance
+    emitFlush(pending, out);
+    fprintf(out, "    self->PC = 0x%03X;\n    return;\n", pc);
+    return false;
+}
+
+/*
+ * Emit a jump to the block at target, or a return to the caller with PC at
+ * target if it was not translated
+ */
+void emitTransfer(const Translation *t, uint16_t target, const char *indent,
+        FILE *out) {
+    if (target < 4096 && t->leader[target]) {
+        fprintf(out, "%sgoto L%03X;\n", indent, target);
+    } else {
+        fprintf(out, "%sself->PC = 0x%03X;\n%sreturn;\n", indent, target,
+                indent);
+    }
+}
+
+/*
+ * Emit the update of cycles for the instructions retired inline since the
+ * last one
+ */
+void emitFlush(unsigned *pending, FILE *out) {
+    if (*pending > 0) {
+        fprintf(out, "    self->cycles += %u;\n", *pending);
+    }
+    *pending = 0;
+}
+
+/*
+ * How the instruction at pc is translated, with the checks Chip8_advance
+ * makes on its opcode
+ */
+Kind classify(const Translation *t, uint16_t pc) {
+    if (pc < PROG_START || pc > 0xFFE) {
+        return KIND_NONE;
+    }
+    uint16_t op = fetch(t, pc);
+    uint8_t nn = op & 0xFF;
+    switch (op >> 12) {
+        case 0x0:
+            if (op >> 8 != 0x00) {
+                return KIND_NONE;
+            }
+            if ((nn & 0xF0) == 0xC0) {
+                return KIND_HELPER;
+            }
+            switch (nn) {
+                case 0xE0: case 0xFB: case 0xFC: case 0xFE: case 0xFF:
+                    return KIND_HELPER;
+                case 0xEE:
+                    return KIND_RET;
+            }
+            return KIND_NONE;
+        case 0x1: return KIND_JUMP;
+        case 0x2: return KIND_CALL;
+        case 0x3: case 0x4: return KIND_SKIP;
+        case 0x5: case 0x9: return (op & 0xF) == 0 ? KIND_SKIP : KIND_NONE;
+        case 0x6: case 0x7: case 0xA: return KIND_NATIVE;
+        case 0x8:
+            return (op & 0xF) <= 0x7 || (op & 0xF) == 0xE ? KIND_NATIVE
+                : KIND_NONE;
+        case 0xB: return KIND_COMPUTED;
+        case 0xC: case 0xD: return KIND_HELPER;
+        case 0xE: return nn == 0x9E || nn == 0xA1 ? KIND_SKIP : KIND_NONE;
+        case 0xF:
+            switch (nn) {
+                case 0x07: case 0x15: case 0x1E:
+                    return KIND_NATIVE;
+                case 0x0A: case 0x18: case 0x29: case 0x30: case 0x33:
+                case 0x55: case 0x65: case 0x75: case 0x85:
+                    return KIND_HELPER;
+            }
+            return KIND_NONE;
+    }
+    return KIND_NONE;
+}
+
+uint16_t fetch(const Translation *t, uint16_t pc) {
+    return t->ram[pc] << 8 | t->ram[pc + 1];
+}
+
+/*
+ * Write text as a C string literal
+ */
+void emitString(const char *text, FILE *out) {
+    fputc('"', out);
+    for (const unsigned char *c = (const unsigned char *) text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(out, "\\%c", *c);
+        } else if (*c < 0x20 || *c > 0x7E) {
+            fprintf(out, "\\%03o", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Chip8Capture.h"
+
+// Exit statuses, as with diff(1)
+#define SAME 0
+#define DIFFERENT 1
+#define TROUBLE 2
+
+int compare(Chip8CaptureReader *a, Chip8CaptureReader *b,
+        const char *nameA, const char *nameB);
+void reportScreens(const Chip8CaptureReader *a, const Chip8CaptureReader *b);
+
+int main(int argc, char **argv) {
+    // capture-diff <capture> <capture>
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <capture> <capture>\n", argv[0]);
+        return TROUBLE;
+    }
+    Chip8CaptureReader a, b;
+    if (!Chip8CaptureReader_open(&a, argv[1])) {
+        perror(argv[1]);
+        return TROUBLE;
+    }
+    if (!Chip8CaptureReader_open(&b, argv[2])) {
+        perror(argv[2]);
+        Chip8CaptureReader_close(&a);
+        return TROUBLE;
+    }
+    int status = compare(&a, &b, argv[1], argv[2]);
+    Chip8CaptureReader_close(&a);
+    Chip8CaptureReader_close(&b);
+    return status;
+}
+
+/*
+ * Step through both captures together and report the first frame at which
+ * they diverge
+ */
+int compare(Chip8CaptureReader *a, Chip8CaptureReader *b,
+        const char *nameA, const char *nameB) {
+    for (;;) {
+        bool moreA = Chip8CaptureReader_next(a),
+             moreB = Chip8CaptureReader_next(b);
+        if (a->corrupt || b->corrupt) {
+            fprintf(stderr, "%s: corrupt after frame %llu\n",
+                    a->corrupt ? nameA : nameB, (unsigned long long)
+                    (a->corrupt ? a->frames : b->frames));
+            return TROUBLE;
+        }
+        if (!moreA && !moreB) {
+            printf("identical: %llu frames\n", (unsigned long long) a->frames);
+            return SAME;
+        }
+        if (!moreA || !moreB) {
+            printf("%s ends after %llu frames, %s goes on\n",
+                    moreA ? nameB : nameA, (unsigned long long) (moreA
+                        ? b->frames : a->frames), moreA ? nameA : nameB);
+            return DIFFERENT;
+        }
+        bool sameScreen = memcmp(a->screen, b->screen, sizeof(a->screen)) == 0;
+        if (!sameScreen || a->cycles != b->cycles) {
+            printf("frame %llu differs: cycle %llu vs %llu\n",
+                    (unsigned long long) a->frames - 1,
+                    (unsigned long long) a->cycles,
+                    (unsigned long long) b->cycles);
+            if (!sameScreen) {
+                reportScreens(a, b);
+            }
+            return DIFFERENT;
+        }
+    }
+}
+
+/*
+ * Print how many pixels differ between the two current frames, and where
+ * the first one is
+ */
+void reportScreens(const Chip8CaptureReader *a, const Chip8CaptureReader *b) {
+    int count = 0, firstRow = -1, firstCol = -1;
+    for (int r = 0; r < 64; ++r) {
+        for (int w = 0; w < 2; ++w) {
+            uint64_t diff = a->screen[r][w] ^ b->screen[r][w];
+            if (diff != 0 && firstRow < 0) {
+                firstRow = r;
+                firstCol = w * 64 + __builtin_clzll(diff);
+            }
+            count += __builtin_popcountll(diff);
+        }
+    }
+    printf("%d pixels differ, the first at row %d, column %d\n", count,
+            firstRow, firstCol);
+}